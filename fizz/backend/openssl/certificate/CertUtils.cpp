@@ -9,6 +9,7 @@
 #include <fizz/backend/openssl/certificate/CertUtils.h>
 #include <fizz/backend/openssl/certificate/OpenSSLPeerCertImpl.h>
 #include <fizz/backend/openssl/certificate/OpenSSLSelfCertImpl.h>
+#include <fizz/backend/openssl/certificate/X509InternCache.h>
 #include <fizz/protocol/Certificate.h>
 #include <folly/ssl/OpenSSLCertUtils.h>
 #include <openssl/bio.h>
@@ -121,15 +122,7 @@ std::unique_ptr<PeerCert> CertUtils::makePeerCert(Buf certData) {
     throw std::runtime_error("empty peer cert");
   }
 
-  auto range = certData->coalesce();
-  const unsigned char* begin = range.data();
-  folly::ssl::X509UniquePtr cert(d2i_X509(nullptr, &begin, range.size()));
-  if (!cert) {
-    throw std::runtime_error("could not read cert");
-  }
-  if (begin != range.data() + range.size()) {
-    VLOG(1) << "Did not read to end of certificate";
-  }
+  auto cert = X509InternCache::get().parse(certData->coalesce());
   return makePeerCert(std::move(cert));
 }
 
@@ -41,7 +41,8 @@ class CertUtils {
   static std::vector<SignatureScheme> getSigSchemes(KeyType type);
 
   /**
-   * Create a PeerCert from the ASN1 encoded certData.
+   * Create a PeerCert from the ASN1 encoded certData. If X509InternCache is
+   * enabled, certificates seen before are not parsed again.
    */
   static std::unique_ptr<PeerCert> makePeerCert(Buf certData);
 
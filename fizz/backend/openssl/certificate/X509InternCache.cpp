@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/backend/openssl/certificate/X509InternCache.h>
+
+#include <folly/ssl/OpenSSLHash.h>
+#include <glog/logging.h>
+
+namespace fizz {
+namespace openssl {
+
+X509InternCache::X509InternCache() {
+  for (auto& shard : shards_) {
+    // Shards are resized when the cache is enabled.
+    shard = std::make_unique<folly::Synchronized<EvictingX509Map>>(
+        EvictingX509Map(1));
+  }
+}
+
+/* static */ X509InternCache& X509InternCache::get() {
+  // Leaked so that cached certificates outlive any static destructors that
+  // may still be verifying peers.
+  static auto* cache = new X509InternCache();
+  return *cache;
+}
+
+void X509InternCache::setCapacity(size_t capacity) {
+  capacity_.store(capacity, std::memory_order_relaxed);
+  auto shardCapacity = (capacity + kNumShards - 1) / kNumShards;
+  for (auto& shard : shards_) {
+    auto map = shard->wlock();
+    if (capacity == 0) {
+      map->clear();
+    } else {
+      map->setMaxSize(shardCapacity);
+    }
+  }
+}
+
+folly::ssl::X509UniquePtr X509InternCache::parse(folly::ByteRange der) {
+  if (getCapacity() == 0) {
+    return doParse(der);
+  }
+
+  std::array<uint8_t, 32> digest;
+  folly::ssl::OpenSSLHash::sha256(folly::range(digest), der);
+  std::string key(reinterpret_cast<const char*>(digest.data()), digest.size());
+  auto& shard = *shards_[digest[0] % kNumShards];
+
+  {
+    auto map = shard.wlock();
+    auto it = map->find(key);
+    if (it != map->end()) {
+      X509_up_ref(it->second.get());
+      return folly::ssl::X509UniquePtr(it->second.get());
+    }
+  }
+
+  // Parse outside of the lock, if another thread races us the last insert
+  // wins and both callers get a valid certificate.
+  auto cert = doParse(der);
+  auto map = shard.wlock();
+  // setCapacity(0) may have cleared the shard since the check above. It
+  // updates capacity_ before taking the shard locks, so checking again under
+  // the lock is enough to not repopulate a disabled cache.
+  if (getCapacity() != 0) {
+    X509_up_ref(cert.get());
+    map->set(std::move(key), folly::ssl::X509UniquePtr(cert.get()));
+  }
+  return cert;
+}
+
+size_t X509InternCache::size() const {
+  size_t total = 0;
+  for (const auto& shard : shards_) {
+    total += shard->rlock()->size();
+  }
+  return total;
+}
+
+void X509InternCache::clear() {
+  for (auto& shard : shards_) {
+    shard->wlock()->clear();
+  }
+}
+
+/* static */ folly::ssl::X509UniquePtr X509InternCache::doParse(
+    folly::ByteRange der) {
+  const unsigned char* begin = der.data();
+  folly::ssl::X509UniquePtr cert(d2i_X509(nullptr, &begin, der.size()));
+  if (!cert) {
+    throw std::runtime_error("could not read cert");
+  }
+  if (begin != der.data() + der.size()) {
+    VLOG(1) << "Did not read to end of certificate";
+  }
+  return cert;
+}
+} // namespace openssl
+} // namespace fizz
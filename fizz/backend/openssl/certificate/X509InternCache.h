@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <folly/ssl/OpenSSLPtrTypes.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace fizz {
+namespace openssl {
+
+/**
+ * Process wide cache of parsed peer certificates, keyed by the SHA-256 of
+ * their DER encoding.
+ *
+ * Servers send the same intermediates on every handshake, so with the cache
+ * enabled CertUtils::makePeerCert hands out references to a single shared
+ * X509 (and its cached public key) instead of parsing the certificate again.
+ *
+ * Interned X509 objects are shared across connections and threads. Callers
+ * must treat them as read-only: they may be read concurrently, relying on
+ * OpenSSL's internal locking for the extensions it caches lazily on first
+ * use, but must never be modified.
+ *
+ * The cache is disabled until a capacity is set.
+ */
+class X509InternCache {
+ public:
+  X509InternCache();
+
+  /**
+   * The instance used by CertUtils::makePeerCert.
+   */
+  static X509InternCache& get();
+
+  /**
+   * Set the maximum number of certificates kept. 0 disables the cache and
+   * drops all entries.
+   */
+  void setCapacity(size_t capacity);
+
+  size_t getCapacity() const {
+    return capacity_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Parse the DER encoded der, returning a reference to the cached X509 if
+   * the same certificate was parsed before. Throws std::runtime_error if der
+   * is not a valid certificate.
+   */
+  folly::ssl::X509UniquePtr parse(folly::ByteRange der);
+
+  size_t size() const;
+
+  void clear();
+
+ private:
+  using EvictingX509Map =
+      folly::EvictingCacheMap<std::string, folly::ssl::X509UniquePtr>;
+
+  static constexpr size_t kNumShards = 16;
+
+  static folly::ssl::X509UniquePtr doParse(folly::ByteRange der);
+
+  std::atomic<size_t> capacity_{0};
+  std::array<std::unique_ptr<folly::Synchronized<EvictingX509Map>>, kNumShards>
+      shards_;
+};
+} // namespace openssl
+} // namespace fizz
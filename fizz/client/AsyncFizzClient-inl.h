@@ -551,6 +551,14 @@ void AsyncFizzClientT<SM>::ActionMoveVisitor::operator()(
   // boundary (if handshakeRecordAlignedReads = true).
   client_.updateReadHint(0);
 
+  // Remember the group the server picked so the next connection to this host
+  // only sends a share for it.
+  const auto& state = client_.getState();
+  const auto& host = state.echState() ? state.echState()->sni : state.sni();
+  if (host && state.group()) {
+    client_.fizzContext_->putGroupHint(*host, *state.group());
+  }
+
   // if there are app writes pending this handshake success, flush them first,
   // then flush the early data buffers
   auto& pendingHandshakeAppWrites = client_.pendingHandshakeAppWrites_;
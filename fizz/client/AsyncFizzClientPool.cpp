@@ -0,0 +1,250 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/client/AsyncFizzClientPool.h>
+
+#include <folly/Conv.h>
+
+#include <algorithm>
+#include <array>
+
+namespace fizz {
+namespace client {
+
+class AsyncFizzClientPool::PooledConnection final
+    : public folly::AsyncSocket::ConnectCallback,
+      public folly::AsyncTransport::ReadCallback,
+      public folly::AsyncTransport::ReplaySafetyCallback {
+ public:
+  PooledConnection(AsyncFizzClientPool& pool, DestinationState& state)
+      : pool_(pool), state_(state) {}
+
+  ~PooledConnection() override {
+    // Closing the client below reports errors to the callbacks.
+    closing_ = true;
+    if (client_) {
+      client_->setReadCB(nullptr);
+      client_->setReplaySafetyCallback(nullptr);
+      client_->closeNow();
+    }
+  }
+
+  void start() {
+    const auto& destination = state_.destination;
+    client_.reset(new AsyncFizzClient(pool_.evb_, pool_.context_));
+    client_->connect(
+        destination.address,
+        this,
+        pool_.verifier_,
+        destination.sni,
+        destination.pskIdentity,
+        pool_.options_.handshakeTimeout);
+  }
+
+  bool isReady() const {
+    return ready_ && client_->good();
+  }
+
+  bool isExpired(std::chrono::steady_clock::time_point now) const {
+    return ready_ && now >= deadline_;
+  }
+
+  AsyncFizzClient::UniquePtr release() {
+    client_->setReadCB(nullptr);
+    return std::move(client_);
+  }
+
+  void connectSuccess() noexcept override {
+    if (closing_) {
+      return;
+    }
+    if (client_->isReplaySafe()) {
+      setReady();
+    } else {
+      // Wait for the full handshake rather than handing out a connection
+      // that would send early data.
+      client_->setReplaySafetyCallback(this);
+    }
+  }
+
+  void connectErr(const folly::AsyncSocketException& ex) noexcept override {
+    VLOG(4) << "Pooled connection to "
+            << state_.destination.address.describe()
+            << " failed: " << ex.what();
+    close();
+  }
+
+  void onReplaySafe() noexcept override {
+    if (!closing_) {
+      setReady();
+    }
+  }
+
+  void getReadBuffer(void** bufReturn, size_t* lenReturn) override {
+    *bufReturn = readBuf_.data();
+    *lenReturn = readBuf_.size();
+  }
+
+  void readDataAvailable(size_t /* len */) noexcept override {
+    // Nothing was requested, so the connection is in an unknown state.
+    close();
+  }
+
+  void readEOF() noexcept override {
+    close();
+  }
+
+  void readErr(const folly::AsyncSocketException& /* ex */) noexcept override {
+    close();
+  }
+
+ private:
+  void setReady() {
+    ready_ = true;
+    deadline_ = std::chrono::steady_clock::now() + pool_.options_.maxIdleTime;
+    // Notices the peer closing the connection while it is idle.
+    client_->setReadCB(this);
+  }
+
+  void close() {
+    if (!closing_) {
+      // Destroys this.
+      pool_.connectionClosed(state_, this);
+    }
+  }
+
+  AsyncFizzClientPool& pool_;
+  DestinationState& state_;
+  AsyncFizzClient::UniquePtr client_;
+  bool ready_{false};
+  bool closing_{false};
+  std::chrono::steady_clock::time_point deadline_;
+  std::array<uint8_t, 64> readBuf_;
+};
+
+AsyncFizzClientPool::AsyncFizzClientPool(
+    folly::EventBase* evb,
+    std::shared_ptr<const FizzClientContext> context,
+    std::shared_ptr<const CertificateVerifier> verifier,
+    AsyncFizzClientPoolOptions options)
+    : folly::AsyncTimeout(evb),
+      evb_(evb),
+      context_(std::move(context)),
+      verifier_(std::move(verifier)),
+      options_(std::move(options)) {}
+
+AsyncFizzClientPool::~AsyncFizzClientPool() {
+  cancelTimeout();
+  destinations_.clear();
+}
+
+std::string AsyncFizzClientPool::getKey(const Destination& destination) {
+  return folly::to<std::string>(
+      destination.address.describe(),
+      "/",
+      destination.sni.value_or(""),
+      "/",
+      destination.pskIdentity.value_or(""));
+}
+
+void AsyncFizzClientPool::addDestination(const Destination& destination) {
+  auto result =
+      destinations_.emplace(getKey(destination), DestinationState{destination});
+  if (!result.second) {
+    return;
+  }
+  fill(result.first->second);
+  if (!isScheduled()) {
+    scheduleTimeout(options_.refreshInterval);
+  }
+}
+
+void AsyncFizzClientPool::removeDestination(const Destination& destination) {
+  destinations_.erase(getKey(destination));
+  if (destinations_.empty()) {
+    cancelTimeout();
+  }
+}
+
+AsyncFizzClient::UniquePtr AsyncFizzClientPool::getConnection(
+    const Destination& destination) {
+  auto result = destinations_.find(getKey(destination));
+  if (result == destinations_.end()) {
+    return nullptr;
+  }
+  auto& state = result->second;
+  auto now = std::chrono::steady_clock::now();
+  AsyncFizzClient::UniquePtr client;
+  // Connections are started in order, so the first ready one has been idle
+  // the longest.
+  for (auto it = state.connections.begin(); it != state.connections.end();
+       ++it) {
+    if ((*it)->isReady() && !(*it)->isExpired(now)) {
+      client = (*it)->release();
+      state.connections.erase(it);
+      break;
+    }
+  }
+  fill(state);
+  return client;
+}
+
+size_t AsyncFizzClientPool::getNumReadyConnections(
+    const Destination& destination) const {
+  auto result = destinations_.find(getKey(destination));
+  if (result == destinations_.end()) {
+    return 0;
+  }
+  const auto& connections = result->second.connections;
+  return std::count_if(
+      connections.begin(), connections.end(), [](const auto& connection) {
+        return connection->isReady();
+      });
+}
+
+void AsyncFizzClientPool::timeoutExpired() noexcept {
+  auto now = std::chrono::steady_clock::now();
+  for (auto& destination : destinations_) {
+    auto& connections = destination.second.connections;
+    for (auto it = connections.begin(); it != connections.end();) {
+      if ((*it)->isExpired(now)) {
+        it = connections.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    fill(destination.second);
+  }
+  if (!destinations_.empty()) {
+    scheduleTimeout(options_.refreshInterval);
+  }
+}
+
+void AsyncFizzClientPool::fill(DestinationState& state) {
+  if (state.connections.size() >= options_.connectionsPerDestination) {
+    return;
+  }
+  // Connections failing synchronously are only retried on the next refresh.
+  auto needed = options_.connectionsPerDestination - state.connections.size();
+  for (size_t i = 0; i < needed; i++) {
+    state.connections.push_back(
+        std::make_unique<PooledConnection>(*this, state));
+    state.connections.back()->start();
+  }
+}
+
+void AsyncFizzClientPool::connectionClosed(
+    DestinationState& state,
+    const PooledConnection* connection) {
+  // Replaced on the next refresh, which keeps a destination that is down from
+  // being retried in a loop.
+  state.connections.remove_if(
+      [connection](const auto& pooled) { return pooled.get() == connection; });
+}
+} // namespace client
+} // namespace fizz
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/client/AsyncFizzClient.h>
+#include <folly/SocketAddress.h>
+#include <folly/io/async/AsyncTimeout.h>
+
+#include <list>
+#include <unordered_map>
+
+namespace fizz {
+namespace client {
+
+struct AsyncFizzClientPoolOptions {
+  // Number of handshaken connections kept ready for each destination.
+  size_t connectionsPerDestination{2};
+
+  std::chrono::milliseconds handshakeTimeout{std::chrono::seconds(10)};
+
+  // Ready connections are replaced once they have been idle for this long, so
+  // that connections the server has timed out are not handed out. Replacing
+  // them also keeps fresh tickets in the context's PskCache.
+  std::chrono::milliseconds maxIdleTime{std::chrono::seconds(30)};
+
+  // How often expired connections are replaced, and failed connection
+  // attempts retried.
+  std::chrono::milliseconds refreshInterval{std::chrono::seconds(1)};
+};
+
+/**
+ * Keeps TLS connections to a set of destinations open and handshaken ahead
+ * of time, so that taking a connection from the pool costs neither the TCP
+ * nor the TLS handshake.
+ *
+ * A connection is only handed out once its handshake has completed and it is
+ * replay safe. Taking a connection immediately starts a replacement. Ready
+ * connections that are closed by the peer are dropped, and all ready
+ * connections are replaced after maxIdleTime.
+ *
+ * All methods must be called from the EventBase thread.
+ */
+class AsyncFizzClientPool : private folly::AsyncTimeout {
+ public:
+  struct Destination {
+    folly::SocketAddress address;
+    folly::Optional<std::string> sni;
+    folly::Optional<std::string> pskIdentity;
+  };
+
+  AsyncFizzClientPool(
+      folly::EventBase* evb,
+      std::shared_ptr<const FizzClientContext> context,
+      std::shared_ptr<const CertificateVerifier> verifier,
+      AsyncFizzClientPoolOptions options = {});
+
+  /**
+   * Closes all pooled connections. Connections already handed out are not
+   * affected.
+   */
+  ~AsyncFizzClientPool() override;
+
+  /**
+   * Start keeping connections to destination ready.
+   */
+  void addDestination(const Destination& destination);
+
+  /**
+   * Stop keeping connections to destination, closing the pooled ones.
+   */
+  void removeDestination(const Destination& destination);
+
+  /**
+   * Returns a handshaken connection to destination, or nullptr if none is
+   * ready (in which case the caller should connect on its own). The returned
+   * connection has no read callback installed.
+   */
+  AsyncFizzClient::UniquePtr getConnection(const Destination& destination);
+
+  /**
+   * Number of connections to destination that are ready to be handed out.
+   */
+  size_t getNumReadyConnections(const Destination& destination) const;
+
+ private:
+  class PooledConnection;
+  struct DestinationState {
+    Destination destination;
+    std::list<std::unique_ptr<PooledConnection>> connections;
+  };
+
+  static std::string getKey(const Destination& destination);
+
+  void timeoutExpired() noexcept override;
+
+  void fill(DestinationState& state);
+  void connectionClosed(
+      DestinationState& state,
+      const PooledConnection* connection);
+
+  folly::EventBase* evb_;
+  std::shared_ptr<const FizzClientContext> context_;
+  std::shared_ptr<const CertificateVerifier> verifier_;
+  AsyncFizzClientPoolOptions options_;
+  std::unordered_map<std::string, DestinationState> destinations_;
+};
+} // namespace client
+} // namespace fizz
@@ -782,6 +782,25 @@ static ClientHello constructEncryptedClientHello(
   return chloOuter;
 }
 
+// Only send a share for the group the server selected last time, if we still
+// support it. This avoids both a HelloRetryRequest and generating shares the
+// server will ignore.
+static std::vector<NamedGroup> getGroupHintShares(
+    const FizzClientContext& context,
+    const folly::Optional<std::string>& sni) {
+  if (sni && context.getGroupHintCache()) {
+    auto hint = context.getGroupHint(*sni);
+    if (hint &&
+        std::find(
+            context.getSupportedGroups().begin(),
+            context.getSupportedGroups().end(),
+            *hint) != context.getSupportedGroups().end()) {
+      return {*hint};
+    }
+  }
+  return context.getDefaultShares();
+}
+
 Actions
 EventHandler<ClientTypes, StateEnum::Uninitialized, Event::Connect>::handle(
     const State& /*state*/,
@@ -815,7 +834,7 @@ EventHandler<ClientTypes, StateEnum::Uninitialized, Event::Connect>::handle(
     // psk_ke last time
     selectedShares = {};
   } else {
-    selectedShares = context->getDefaultShares();
+    selectedShares = getGroupHintShares(*context, sni);
   }
 
   auto earlyDataParams = getEarlyDataParams(*context, psk);
@@ -1994,13 +2013,9 @@ Actions EventHandler<
         AlertDescription::bad_certificate);
   }
 
-  auto decompressor =
-      state.context()->getCertDecompressorForAlgorithm(compCert.algorithm);
-  DCHECK(decompressor);
-
   CertificateMsg msg;
   try {
-    msg = decompressor->decompress(compCert);
+    msg = state.context()->decompressCertificate(compCert);
   } catch (const std::exception& e) {
     throw FizzException(
         folly::to<std::string>("certificate decompression failed: ", e.what()),
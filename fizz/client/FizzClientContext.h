@@ -10,6 +10,7 @@
 
 #include <fizz/client/CertManager.h>
 #include <fizz/client/ECHPolicy.h>
+#include <fizz/client/GroupHintCache.h>
 #include <fizz/client/PskCache.h>
 #include <fizz/compression/CertDecompressionManager.h>
 #include <fizz/protocol/Certificate.h>
@@ -216,6 +217,32 @@ class FizzClientContext {
     }
   }
 
+  /**
+   * Set the cache of the groups selected by each server. If set, connections
+   * to a host with a cached group only send a key share for that group.
+   */
+  void setGroupHintCache(std::shared_ptr<GroupHintCache> groupHintCache) {
+    groupHintCache_ = std::move(groupHintCache);
+  }
+
+  GroupHintCache* getGroupHintCache() const {
+    return groupHintCache_.get();
+  }
+
+  folly::Optional<NamedGroup> getGroupHint(const std::string& host) const {
+    if (groupHintCache_) {
+      return groupHintCache_->getGroup(host);
+    } else {
+      return folly::none;
+    }
+  }
+
+  void putGroupHint(const std::string& host, NamedGroup group) const {
+    if (groupHintCache_) {
+      groupHintCache_->putGroup(host, group);
+    }
+  }
+
   /**
    * Sets whether we should attempt to send early data.
    */
@@ -288,6 +315,19 @@ class FizzClientContext {
     }
   }
 
+  /**
+   * Decompresses a server certificate message using the certificate
+   * decompression manager, which may return a cached result. Throws if the
+   * algorithm isn't supported or decompression fails.
+   */
+  CertificateMsg decompressCertificate(
+      const CompressedCertificate& cert) const {
+    if (!certDecompressionManager_) {
+      throw std::runtime_error("no certificate decompression manager");
+    }
+    return certDecompressionManager_->decompress(cert);
+  }
+
   /**
    * Whether to omit the early record layer when sending early data. This will
    * also omit the EndOfEarlyData message.
@@ -385,6 +425,7 @@ class FizzClientContext {
 
   std::shared_ptr<ECHPolicy> echPolicy_;
   std::shared_ptr<PskCache> pskCache_;
+  std::shared_ptr<GroupHintCache> groupHintCache_;
   // Legacy to support non cert mgr api.
   std::shared_ptr<SelfCert> clientCert_{nullptr};
   std::shared_ptr<CertManager> certManager_{nullptr};
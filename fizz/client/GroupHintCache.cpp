@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/client/GroupHintCache.h>
+
+namespace fizz {
+namespace client {
+
+SynchronizedLruGroupHintCache::SynchronizedLruGroupHintCache(uint64_t mapMax)
+    : cache_(EvictingGroupMap(mapMax)) {}
+
+folly::Optional<NamedGroup> SynchronizedLruGroupHintCache::getGroup(
+    const std::string& host) {
+  // Lookups promote the entry, so they need the write lock.
+  auto cacheMap = cache_.wlock();
+  auto result = cacheMap->find(host);
+  if (result != cacheMap->end()) {
+    return result->second;
+  } else {
+    return folly::none;
+  }
+}
+
+void SynchronizedLruGroupHintCache::putGroup(
+    const std::string& host,
+    NamedGroup group) {
+  auto cacheMap = cache_.wlock();
+  auto result = cacheMap->find(host);
+  if (result != cacheMap->end() && result->second == group) {
+    // Common case for a stable server, avoid copying the key.
+    return;
+  }
+  cacheMap->set(host, group);
+}
+
+void SynchronizedLruGroupHintCache::removeGroup(const std::string& host) {
+  auto cacheMap = cache_.wlock();
+  cacheMap->erase(host);
+}
+} // namespace client
+} // namespace fizz
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/record/Types.h>
+#include <folly/Optional.h>
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+
+namespace fizz {
+namespace client {
+
+/**
+ * Remembers the key exchange group each server selected. When connecting to
+ * a host again the client only sends a key share for that group, instead of
+ * generating a share for every default group or paying for a
+ * HelloRetryRequest when the server prefers a group it didn't send.
+ */
+class GroupHintCache {
+ public:
+  virtual ~GroupHintCache() = default;
+
+  /**
+   * Retrieve the group last selected by host.
+   */
+  virtual folly::Optional<NamedGroup> getGroup(const std::string& host) = 0;
+
+  /**
+   * Record the group selected by host.
+   */
+  virtual void putGroup(const std::string& host, NamedGroup group) = 0;
+
+  /**
+   * Forget the group selected by host.
+   */
+  virtual void removeGroup(const std::string& host) = 0;
+};
+
+/**
+ * Group hint cache that provides synchronization and caps the number of hosts
+ * stored. When the limit is reached, the least recently used host is evicted.
+ */
+class SynchronizedLruGroupHintCache : public GroupHintCache {
+ public:
+  using EvictingGroupMap = folly::EvictingCacheMap<std::string, NamedGroup>;
+
+  explicit SynchronizedLruGroupHintCache(uint64_t mapMax);
+  ~SynchronizedLruGroupHintCache() override = default;
+
+  folly::Optional<NamedGroup> getGroup(const std::string& host) override;
+
+  void putGroup(const std::string& host, NamedGroup group) override;
+
+  void removeGroup(const std::string& host) override;
+
+ private:
+  folly::Synchronized<EvictingGroupMap> cache_;
+};
+} // namespace client
+} // namespace fizz
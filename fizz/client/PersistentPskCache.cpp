@@ -0,0 +1,342 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/client/PersistentPskCache.h>
+
+#include <fizz/client/PskSerializationUtils.h>
+#include <fizz/record/Types.h>
+#include <folly/Exception.h>
+#include <folly/FileUtil.h>
+#include <folly/hash/Checksum.h>
+#include <folly/io/Cursor.h>
+#include <folly/lang/Bits.h>
+#include <folly/system/MemoryMapping.h>
+#include <glog/logging.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <array>
+#include <shared_mutex>
+
+using namespace folly;
+
+namespace fizz {
+namespace client {
+
+namespace {
+
+// Log layout:
+//   "FZPSKLG1"
+//   records, each:
+//     uint32 payload length
+//     uint32 crc32c of payload
+//     payload:
+//       uint8 op
+//       uint64 ticket expiration, in seconds since the epoch
+//       opaque identity<0..2^16-1>
+//       opaque serialized_psk<0..2^32-1> (empty for removals)
+constexpr StringPiece kMagic{"FZPSKLG1"};
+constexpr size_t kRecordHeaderSize = 2 * sizeof(uint32_t);
+
+enum class RecordOp : uint8_t { Put = 1, Remove = 2 };
+
+uint64_t toSeconds(std::chrono::system_clock::time_point tp) {
+  auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+                     tp.time_since_epoch())
+                     .count();
+  return seconds > 0 ? seconds : 0;
+}
+
+std::chrono::system_clock::time_point fromSeconds(uint64_t seconds) {
+  using std::chrono::system_clock;
+  constexpr uint64_t kMaxSeconds =
+      std::chrono::duration_cast<std::chrono::seconds>(
+          system_clock::duration::max())
+          .count();
+  return system_clock::time_point(
+      std::chrono::seconds(std::min(seconds, kMaxSeconds)));
+}
+
+std::string encodeRecord(
+    RecordOp op,
+    const std::string& identity,
+    uint64_t expiration,
+    const std::string& serializedPsk) {
+  auto payload = IOBuf::create(0);
+  io::Appender appender(payload.get(), 512);
+  fizz::detail::write(static_cast<uint8_t>(op), appender);
+  fizz::detail::write(expiration, appender);
+  fizz::detail::writeBuf<uint16_t>(
+      IOBuf::wrapBuffer(StringPiece(identity)), appender);
+  fizz::detail::writeBuf<uint32_t>(
+      IOBuf::wrapBuffer(StringPiece(serializedPsk)), appender);
+  auto range = payload->coalesce();
+
+  std::string record(kRecordHeaderSize, '\0');
+  auto length = Endian::big(static_cast<uint32_t>(range.size()));
+  auto crc = Endian::big(crc32c(range.data(), range.size()));
+  std::memcpy(&record[0], &length, sizeof(length));
+  std::memcpy(&record[sizeof(length)], &crc, sizeof(crc));
+  record.append(range.begin(), range.end());
+  return record;
+}
+
+void writeAll(const File& file, StringPiece data, const std::string& path) {
+  checkUnixError(
+      writeFull(file.fd(), data.data(), data.size()), "write failed: ", path);
+}
+} // namespace
+
+PersistentPskCache::PersistentPskCache(
+    std::string path,
+    std::shared_ptr<Factory> factory,
+    PersistentPskCacheOptions options)
+    : path_(std::move(path)),
+      factory_(std::move(factory)),
+      options_(options),
+      lockFile_(path_ + ".lock", O_RDWR | O_CREAT | O_CLOEXEC, 0600) {
+  // Creates the log, or validates an existing one.
+  auto log = log_.lock();
+  std::unique_lock<File> fileLock(lockFile_);
+  refresh(*log, true);
+}
+
+folly::Optional<CachedPsk> PersistentPskCache::getPsk(
+    const std::string& identity) {
+  std::string serializedPsk;
+  try {
+    auto log = log_.lock();
+    std::shared_lock<File> fileLock(lockFile_);
+    refresh(*log, false);
+    auto result = log->entries.find(identity);
+    if (result == log->entries.end() ||
+        result->second.expiration <= clock_->getCurrentTime()) {
+      return folly::none;
+    }
+    serializedPsk = result->second.serializedPsk;
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Failed to read PSK store " << path_ << ": " << ex.what();
+    return folly::none;
+  }
+
+  try {
+    return deserializePsk(serializedPsk, *factory_);
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Failed to deserialize PSK from " << path_ << ": "
+               << ex.what();
+    return folly::none;
+  }
+}
+
+void PersistentPskCache::putPsk(const std::string& identity, CachedPsk psk) {
+  auto record = encodeRecord(
+      RecordOp::Put,
+      identity,
+      toSeconds(psk.ticketExpirationTime),
+      serializePsk(psk));
+  try {
+    auto log = log_.lock();
+    std::unique_lock<File> fileLock(lockFile_);
+    refresh(*log, true);
+    append(*log, record);
+    if (log->offset >= options_.compactionMinBytes &&
+        log->offset > 2 * log->liveBytes) {
+      compact(*log);
+    }
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Failed to write PSK store " << path_ << ": " << ex.what();
+  }
+}
+
+void PersistentPskCache::removePsk(const std::string& identity) {
+  try {
+    auto log = log_.lock();
+    std::unique_lock<File> fileLock(lockFile_);
+    refresh(*log, true);
+    if (log->entries.count(identity) == 0) {
+      return;
+    }
+    append(*log, encodeRecord(RecordOp::Remove, identity, 0, ""));
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Failed to write PSK store " << path_ << ": " << ex.what();
+  }
+}
+
+void PersistentPskCache::compact() {
+  auto log = log_.lock();
+  std::unique_lock<File> fileLock(lockFile_);
+  refresh(*log, true);
+  compact(*log);
+}
+
+size_t PersistentPskCache::size() {
+  auto log = log_.lock();
+  std::shared_lock<File> fileLock(lockFile_);
+  refresh(*log, false);
+  return log->entries.size();
+}
+
+void PersistentPskCache::openLog(Log& log) {
+  log = Log();
+  log.file = File(path_, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+  struct stat st;
+  checkUnixError(::fstat(log.file.fd(), &st), "fstat failed: ", path_);
+  log.device = st.st_dev;
+  log.inode = st.st_ino;
+}
+
+void PersistentPskCache::refresh(Log& log, bool exclusive) {
+  struct stat st;
+  bool exists = ::stat(path_.c_str(), &st) == 0;
+  if (!exists && errno != ENOENT) {
+    throwSystemError("stat failed: ", path_);
+  }
+  if (!exists && !exclusive) {
+    // Removed from under us, nothing to read until the next write.
+    log = Log();
+    return;
+  }
+  if (!exists || st.st_dev != log.device || st.st_ino != log.inode) {
+    // First access, or another process compacted the log.
+    openLog(log);
+  }
+
+  checkUnixError(::fstat(log.file.fd(), &st), "fstat failed: ", path_);
+  size_t size = st.st_size;
+  if (log.offset == 0) {
+    if (size < kMagic.size()) {
+      if (!exclusive) {
+        return;
+      }
+      // New log, or a crash while creating it.
+      checkUnixError(ftruncateNoInt(log.file.fd(), 0), "truncate failed");
+      writeAll(log.file, kMagic, path_);
+      size = kMagic.size();
+    } else {
+      std::array<char, kMagic.size()> magic;
+      checkUnixError(
+          preadFull(log.file.fd(), magic.data(), magic.size(), 0),
+          "read failed: ",
+          path_);
+      if (StringPiece(magic.data(), magic.size()) != kMagic) {
+        throw std::runtime_error(path_ + " is not a PSK store");
+      }
+    }
+    log.offset = kMagic.size();
+  } else if (size < log.offset) {
+    // Truncated by something other than this class, start over.
+    log.entries.clear();
+    log.liveBytes = 0;
+    log.offset = kMagic.size();
+  }
+
+  if (size > log.offset) {
+    MemoryMapping mapping(log.file.fd(), log.offset, size - log.offset);
+    log.offset += applyRecords(log, mapping.range());
+    if (log.offset < size && exclusive) {
+      // A writer crashed part way through a record. Drop it so that the
+      // records appended after it can be read.
+      checkUnixError(
+          ftruncateNoInt(log.file.fd(), log.offset), "truncate failed");
+    }
+  }
+}
+
+size_t PersistentPskCache::applyRecords(Log& log, ByteRange data) {
+  size_t consumed = 0;
+  while (data.size() - consumed >= kRecordHeaderSize) {
+    auto header = data.data() + consumed;
+    auto length = Endian::big(loadUnaligned<uint32_t>(header));
+    auto crc = Endian::big(loadUnaligned<uint32_t>(header + sizeof(length)));
+    if (data.size() - consumed - kRecordHeaderSize < length) {
+      break;
+    }
+    ByteRange payload(header + kRecordHeaderSize, length);
+    if (crc32c(payload.data(), payload.size()) != crc) {
+      break;
+    }
+
+    std::string identity;
+    std::string serializedPsk;
+    RecordOp op;
+    uint64_t expiration;
+    try {
+      auto buf = IOBuf::wrapBufferAsValue(payload);
+      io::Cursor cursor(&buf);
+      op = static_cast<RecordOp>(cursor.read<uint8_t>());
+      expiration = cursor.readBE<uint64_t>();
+      identity = cursor.readFixedString(cursor.readBE<uint16_t>());
+      serializedPsk = cursor.readFixedString(cursor.readBE<uint32_t>());
+    } catch (const std::out_of_range&) {
+      break;
+    }
+    if (op != RecordOp::Put && op != RecordOp::Remove) {
+      break;
+    }
+
+    auto recordSize = kRecordHeaderSize + length;
+    auto existing = log.entries.find(identity);
+    if (existing != log.entries.end()) {
+      log.liveBytes -= existing->second.recordSize;
+      log.entries.erase(existing);
+    }
+    if (op == RecordOp::Put) {
+      log.entries.emplace(
+          std::move(identity),
+          Entry{std::move(serializedPsk), fromSeconds(expiration), recordSize});
+      log.liveBytes += recordSize;
+    }
+    consumed += recordSize;
+  }
+  return consumed;
+}
+
+void PersistentPskCache::append(Log& log, const std::string& record) {
+  writeAll(log.file, record, path_);
+  if (options_.syncWrites) {
+    checkUnixError(fdatasyncNoInt(log.file.fd()), "fdatasync failed: ", path_);
+  }
+  log.offset += applyRecords(log, StringPiece(record));
+}
+
+void PersistentPskCache::compact(Log& log) {
+  std::string contents = kMagic.str();
+  auto now = clock_->getCurrentTime();
+  for (const auto& entry : log.entries) {
+    if (entry.second.expiration > now) {
+      contents += encodeRecord(
+          RecordOp::Put,
+          entry.first,
+          toSeconds(entry.second.expiration),
+          entry.second.serializedPsk);
+    }
+  }
+
+  // Other processes notice the new inode on their next access. The new log is
+  // always synced before it replaces the old one.
+  auto compactPath = path_ + ".compact";
+  File compacted(
+      compactPath, O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0600);
+  writeAll(compacted, contents, compactPath);
+  checkUnixError(fsyncNoInt(compacted.fd()), "fsync failed: ", compactPath);
+  checkUnixError(
+      ::rename(compactPath.c_str(), path_.c_str()),
+      "rename failed: ",
+      compactPath);
+
+  struct stat st;
+  checkUnixError(::fstat(compacted.fd(), &st), "fstat failed: ", path_);
+  log = Log();
+  log.file = std::move(compacted);
+  log.device = st.st_dev;
+  log.inode = st.st_ino;
+  log.offset = kMagic.size() +
+      applyRecords(log, StringPiece(contents).subpiece(kMagic.size()));
+}
+} // namespace client
+} // namespace fizz
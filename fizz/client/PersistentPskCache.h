@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/client/PskCache.h>
+#include <fizz/protocol/Factory.h>
+#include <fizz/protocol/clock/SystemClock.h>
+#include <folly/File.h>
+#include <folly/Synchronized.h>
+
+#include <sys/types.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace fizz {
+namespace client {
+
+struct PersistentPskCacheOptions {
+  // fdatasync() the log after every write. Without it records survive a
+  // process crash, but not necessarily a power failure.
+  bool syncWrites{false};
+
+  // The log is compacted once it is at least this large and less than half of
+  // it is still live.
+  size_t compactionMinBytes{64 * 1024};
+};
+
+/**
+ * PSK cache backed by a file, so that resumption tickets outlive the process.
+ * Short lived clients can resume on their very first connection, and a group
+ * of processes sharing the same path share their tickets.
+ *
+ * The file is an append-only log of put and remove records, each protected by
+ * a checksum. New records are read through a memory mapping whenever the cache
+ * is accessed. A record torn by a crash is ignored and overwritten by the next
+ * write. Tickets past their ticketExpirationTime are never returned, and are
+ * dropped when the log is compacted into a new file, which is then renamed
+ * over the old one.
+ *
+ * Access across processes is serialized with flock() on path + ".lock". I/O
+ * errors after construction are logged and treated as cache misses.
+ */
+class PersistentPskCache : public PskCache {
+ public:
+  PersistentPskCache(
+      std::string path,
+      std::shared_ptr<Factory> factory,
+      PersistentPskCacheOptions options = {});
+  ~PersistentPskCache() override = default;
+
+  folly::Optional<CachedPsk> getPsk(const std::string& identity) override;
+
+  void putPsk(const std::string& identity, CachedPsk psk) override;
+
+  void removePsk(const std::string& identity) override;
+
+  /**
+   * Rewrite the log with only the unexpired PSKs.
+   */
+  void compact();
+
+  /**
+   * Number of identities in the store, including expired ones that have not
+   * been compacted away yet.
+   */
+  size_t size();
+
+  void setClock(std::shared_ptr<Clock> clock) {
+    clock_ = std::move(clock);
+  }
+
+ private:
+  struct Entry {
+    std::string serializedPsk;
+    std::chrono::system_clock::time_point expiration;
+    size_t recordSize;
+  };
+
+  struct Log {
+    folly::File file;
+    dev_t device{0};
+    ino_t inode{0};
+    // End of the last valid record read from file.
+    size_t offset{0};
+    size_t liveBytes{0};
+    std::unordered_map<std::string, Entry> entries;
+  };
+
+  void openLog(Log& log);
+  void refresh(Log& log, bool exclusive);
+  size_t applyRecords(Log& log, folly::ByteRange data);
+  void append(Log& log, const std::string& record);
+  void compact(Log& log);
+
+  std::string path_;
+  std::shared_ptr<Factory> factory_;
+  PersistentPskCacheOptions options_;
+  std::shared_ptr<Clock> clock_ = std::make_shared<SystemClock>();
+  folly::File lockFile_;
+  folly::Synchronized<Log, std::mutex> log_;
+};
+} // namespace client
+} // namespace fizz
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/client/PooledPskCache.h>
+
+namespace fizz {
+namespace client {
+
+PooledPskCache::PooledPskCache(uint64_t mapMax, size_t maxPsksPerIdentity)
+    : maxPsksPerIdentity_(maxPsksPerIdentity),
+      cache_(EvictingPskPoolMap(mapMax)) {
+  if (maxPsksPerIdentity_ == 0) {
+    throw std::runtime_error("PooledPskCache needs room for a PSK");
+  }
+}
+
+folly::Optional<CachedPsk> PooledPskCache::getPsk(
+    const std::string& identity) {
+  auto cacheMap = cache_.wlock();
+  auto result = cacheMap->find(identity);
+  if (result == cacheMap->end()) {
+    return folly::none;
+  }
+  auto& pool = result->second;
+  auto now = std::chrono::system_clock::now();
+  while (!pool.empty() && now > pool.front().ticketExpirationTime) {
+    VLOG(1) << "PSK expired: " << identity;
+    pool.pop_front();
+  }
+  if (pool.empty()) {
+    cacheMap->erase(result);
+    return folly::none;
+  }
+  // Each ticket is only handed out once.
+  auto psk = std::move(pool.front());
+  pool.pop_front();
+  if (pool.empty()) {
+    cacheMap->erase(result);
+  }
+  return psk;
+}
+
+void PooledPskCache::putPsk(const std::string& identity, CachedPsk psk) {
+  auto cacheMap = cache_.wlock();
+  auto result = cacheMap->find(identity);
+  if (result == cacheMap->end()) {
+    std::deque<CachedPsk> pool;
+    pool.push_back(std::move(psk));
+    cacheMap->set(identity, std::move(pool));
+    return;
+  }
+  auto& pool = result->second;
+  if (pool.size() >= maxPsksPerIdentity_) {
+    pool.pop_front();
+  }
+  pool.push_back(std::move(psk));
+}
+
+void PooledPskCache::removePsk(const std::string& identity) {
+  auto cacheMap = cache_.wlock();
+  cacheMap->erase(identity);
+}
+
+size_t PooledPskCache::getNumPsks(const std::string& identity) {
+  auto cacheMap = cache_.rlock();
+  auto result = cacheMap->findWithoutPromotion(identity);
+  return result != cacheMap->end() ? result->second.size() : 0;
+}
+} // namespace client
+} // namespace fizz
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/client/PskCache.h>
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+
+#include <deque>
+
+namespace fizz {
+namespace client {
+
+/**
+ * PSK cache that keeps several tickets per identity and hands each one out
+ * only once. Parallel connections to the same host each resume with their
+ * own ticket, instead of all presenting the same one to a server that only
+ * accepts a ticket once. Servers can be configured to send several tickets
+ * per handshake (FizzServerContext::setNumNewSessionTickets()) to fill the
+ * pool.
+ *
+ * getPsk() removes the oldest unexpired ticket from the pool. putPsk() adds a
+ * ticket, dropping the oldest one once maxPsksPerIdentity is reached.
+ * removePsk() drops the whole pool. When more than mapMax identities are
+ * cached, the least recently used one is evicted.
+ */
+class PooledPskCache : public PskCache {
+ public:
+  PooledPskCache(uint64_t mapMax, size_t maxPsksPerIdentity);
+  ~PooledPskCache() override = default;
+
+  folly::Optional<CachedPsk> getPsk(const std::string& identity) override;
+
+  void putPsk(const std::string& identity, CachedPsk psk) override;
+
+  void removePsk(const std::string& identity) override;
+
+  /**
+   * Number of tickets available for identity, including expired ones.
+   */
+  size_t getNumPsks(const std::string& identity);
+
+ private:
+  using EvictingPskPoolMap =
+      folly::EvictingCacheMap<std::string, std::deque<CachedPsk>>;
+
+  size_t maxPsksPerIdentity_;
+  folly::Synchronized<EvictingPskPoolMap> cache_;
+};
+} // namespace client
+} // namespace fizz
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/client/ShardedLruPskCache.h>
+
+namespace fizz {
+namespace client {
+
+ShardedLruPskCache::ShardedLruPskCache(uint64_t mapMax, size_t numShards) {
+  if (numShards == 0) {
+    throw std::runtime_error("psk cache needs at least one shard");
+  }
+  auto shardMax = std::max<uint64_t>(1, (mapMax + numShards - 1) / numShards);
+  for (size_t i = 0; i < numShards; i++) {
+    shards_.push_back(std::make_unique<Shard>(EvictingPskMap(shardMax)));
+  }
+}
+
+folly::Optional<CachedPsk> ShardedLruPskCache::getPsk(
+    const std::string& identity) {
+  // Copy outside of the shard lock.
+  auto psk = getSharedPsk(identity);
+  if (psk) {
+    return *psk;
+  } else {
+    return folly::none;
+  }
+}
+
+std::shared_ptr<const CachedPsk> ShardedLruPskCache::getSharedPsk(
+    const std::string& identity) {
+  auto cacheMap = getShard(identity).lock();
+  auto result = cacheMap->find(identity);
+  if (result == cacheMap->end()) {
+    return nullptr;
+  }
+  if (std::chrono::system_clock::now() >
+      result->second->ticketExpirationTime) {
+    VLOG(1) << "PSK expired: " << identity << ", id: "
+            << (result->second->serverCert
+                    ? result->second->serverCert->getIdentity()
+                    : "none");
+    cacheMap->erase(result);
+    return nullptr;
+  }
+  return result->second;
+}
+
+void ShardedLruPskCache::putPsk(const std::string& identity, CachedPsk psk) {
+  auto sharedPsk = std::make_shared<const CachedPsk>(std::move(psk));
+  auto cacheMap = getShard(identity).lock();
+  cacheMap->set(identity, std::move(sharedPsk));
+}
+
+void ShardedLruPskCache::removePsk(const std::string& identity) {
+  auto cacheMap = getShard(identity).lock();
+  cacheMap->erase(identity);
+}
+
+ShardedLruPskCache::Shard& ShardedLruPskCache::getShard(
+    const std::string& identity) {
+  return *shards_[std::hash<std::string>()(identity) % shards_.size()];
+}
+
+} // namespace client
+} // namespace fizz
@@ -0,0 +1,60 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/client/PskCache.h>
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+
+#include <mutex>
+
+namespace fizz {
+namespace client {
+
+/**
+ * PSK cache for clients connecting from many threads at once. Identities are
+ * spread over independently locked LRU shards, so threads working on
+ * different identities rarely contend. PSKs are stored immutably and only a
+ * shared_ptr is copied while holding a shard lock.
+ *
+ * Eviction is per shard: each shard holds up to mapMax / numShards entries
+ * (rounded up).
+ */
+class ShardedLruPskCache : public PskCache {
+ public:
+  static constexpr size_t kDefaultNumShards = 16;
+
+  explicit ShardedLruPskCache(
+      uint64_t mapMax,
+      size_t numShards = kDefaultNumShards);
+  ~ShardedLruPskCache() override = default;
+
+  folly::Optional<CachedPsk> getPsk(const std::string& identity) override;
+
+  void putPsk(const std::string& identity, CachedPsk psk) override;
+
+  void removePsk(const std::string& identity) override;
+
+  /**
+   * Like getPsk(), but returns the cached PSK itself instead of a copy.
+   */
+  std::shared_ptr<const CachedPsk> getSharedPsk(const std::string& identity);
+
+ private:
+  using EvictingPskMap =
+      folly::EvictingCacheMap<std::string, std::shared_ptr<const CachedPsk>>;
+  using Shard = folly::Synchronized<EvictingPskMap, std::mutex>;
+
+  Shard& getShard(const std::string& identity);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace client
+} // namespace fizz
@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+
+#include <fizz/client/AsyncFizzClientPool.h>
+#include <fizz/client/PskCache.h>
+#include <fizz/server/test/Utils.h>
+
+using namespace fizz::server;
+using namespace fizz::server::test;
+using namespace testing;
+
+namespace fizz {
+namespace client {
+namespace test {
+
+class AsyncFizzClientPoolTest : public Test,
+                                public FizzTestServer::CallbackFactory,
+                                public AsyncFizzServer::HandshakeCallback {
+ public:
+  void SetUp() override {
+    server_ = std::make_unique<FizzTestServer>(evb_, this, 0, "127.0.0.1");
+    server_->setResumption(true);
+    clientContext_ = std::make_shared<FizzClientContext>();
+    clientContext_->setPskCache(std::make_shared<BasicPskCache>());
+    destination_.address = server_->getAddress();
+    destination_.sni = "fizz-test-selfsign";
+    destination_.pskIdentity = "fizz-test-selfsign";
+
+    options_.connectionsPerDestination = 2;
+    options_.refreshInterval = std::chrono::milliseconds(10);
+  }
+
+  AsyncFizzServer::HandshakeCallback* getCallback(
+      std::shared_ptr<AsyncFizzServer> server) override {
+    servers_.push_back(std::move(server));
+    return this;
+  }
+
+  void fizzHandshakeSuccess(AsyncFizzServer*) noexcept override {}
+
+  void fizzHandshakeError(
+      AsyncFizzServer*,
+      folly::exception_wrapper) noexcept override {}
+
+  void fizzHandshakeAttemptFallback(AttemptVersionFallback) override {}
+
+ protected:
+  std::unique_ptr<AsyncFizzClientPool> makePool() {
+    return std::make_unique<AsyncFizzClientPool>(
+        &evb_, clientContext_, nullptr, options_);
+  }
+
+  // The pool's refresh timer keeps the loop from blocking indefinitely.
+  template <typename F>
+  bool loopUntil(F condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      evb_.loopOnce();
+    }
+    return true;
+  }
+
+  folly::EventBase evb_;
+  std::unique_ptr<FizzTestServer> server_;
+  std::vector<std::shared_ptr<AsyncFizzServer>> servers_;
+  std::shared_ptr<FizzClientContext> clientContext_;
+  AsyncFizzClientPool::Destination destination_;
+  AsyncFizzClientPoolOptions options_;
+};
+
+TEST_F(AsyncFizzClientPoolTest, TestGetConnection) {
+  auto pool = makePool();
+  EXPECT_FALSE(pool->getConnection(destination_));
+
+  pool->addDestination(destination_);
+  EXPECT_EQ(pool->getNumReadyConnections(destination_), 0);
+  ASSERT_TRUE(loopUntil(
+      [&]() { return pool->getNumReadyConnections(destination_) == 2; }));
+  EXPECT_EQ(servers_.size(), 2);
+
+  auto client = pool->getConnection(destination_);
+  ASSERT_TRUE(client);
+  EXPECT_TRUE(client->good());
+  EXPECT_TRUE(client->isReplaySafe());
+  EXPECT_EQ(pool->getNumReadyConnections(destination_), 1);
+
+  // A replacement was started right away.
+  ASSERT_TRUE(loopUntil(
+      [&]() { return pool->getNumReadyConnections(destination_) == 2; }));
+  EXPECT_EQ(servers_.size(), 3);
+  EXPECT_TRUE(client->good());
+}
+
+TEST_F(AsyncFizzClientPoolTest, TestUnknownDestination) {
+  auto pool = makePool();
+  pool->addDestination(destination_);
+  auto other = destination_;
+  other.sni = "other";
+  EXPECT_FALSE(pool->getConnection(other));
+  EXPECT_EQ(pool->getNumReadyConnections(other), 0);
+}
+
+TEST_F(AsyncFizzClientPoolTest, TestPeerClose) {
+  auto pool = makePool();
+  pool->addDestination(destination_);
+  ASSERT_TRUE(loopUntil(
+      [&]() { return pool->getNumReadyConnections(destination_) == 2; }));
+
+  for (auto& server : servers_) {
+    server->closeNow();
+  }
+  servers_.clear();
+  ASSERT_TRUE(loopUntil([&]() { return servers_.size() == 2; }));
+  ASSERT_TRUE(loopUntil(
+      [&]() { return pool->getNumReadyConnections(destination_) == 2; }));
+  auto client = pool->getConnection(destination_);
+  ASSERT_TRUE(client);
+  EXPECT_TRUE(client->good());
+}
+
+TEST_F(AsyncFizzClientPoolTest, TestRefreshResumes) {
+  options_.maxIdleTime = std::chrono::milliseconds(50);
+  auto pool = makePool();
+  pool->addDestination(destination_);
+  ASSERT_TRUE(loopUntil(
+      [&]() { return pool->getNumReadyConnections(destination_) == 2; }));
+  auto client = pool->getConnection(destination_);
+  ASSERT_TRUE(client);
+  EXPECT_FALSE(client->pskResumed());
+
+  // Idle connections are replaced, using tickets from earlier ones.
+  ASSERT_TRUE(loopUntil([&]() { return servers_.size() >= 5; }));
+  ASSERT_TRUE(loopUntil([&]() {
+    if (pool->getNumReadyConnections(destination_) == 0) {
+      return false;
+    }
+    client = pool->getConnection(destination_);
+    return client && client->pskResumed();
+  }));
+}
+
+TEST_F(AsyncFizzClientPoolTest, TestRemoveDestination) {
+  auto pool = makePool();
+  pool->addDestination(destination_);
+  ASSERT_TRUE(loopUntil(
+      [&]() { return pool->getNumReadyConnections(destination_) == 2; }));
+  pool->removeDestination(destination_);
+  EXPECT_EQ(pool->getNumReadyConnections(destination_), 0);
+  EXPECT_FALSE(pool->getConnection(destination_));
+}
+} // namespace test
+} // namespace client
+} // namespace fizz
@@ -882,6 +882,60 @@ TEST_F(ClientProtocolTest, TestConnectCachedGroup) {
   EXPECT_EQ(state_.keyExchangers()->at(NamedGroup::secp256r1).get(), mockKex);
 }
 
+TEST_F(ClientProtocolTest, TestConnectGroupHint) {
+  context_->setDefaultShares({NamedGroup::x25519});
+  auto groupHintCache = std::make_shared<SynchronizedLruGroupHintCache>(10);
+  groupHintCache->putGroup("www.hostname.com", NamedGroup::secp256r1);
+  context_->setGroupHintCache(groupHintCache);
+  MockKeyExchange* mockKex;
+  EXPECT_CALL(
+      *factory_,
+      makeKeyExchange(NamedGroup::x25519, Factory::KeyExchangeMode::Client))
+      .Times(0);
+  EXPECT_CALL(
+      *factory_,
+      makeKeyExchange(NamedGroup::secp256r1, Factory::KeyExchangeMode::Client))
+      .WillOnce(InvokeWithoutArgs([&mockKex]() {
+        auto ret = std::make_unique<MockKeyExchange>();
+        EXPECT_CALL(*ret, generateKeyPair());
+        EXPECT_CALL(*ret, getKeyShare()).WillOnce(InvokeWithoutArgs([]() {
+          return folly::IOBuf::copyBuffer("p256share");
+        }));
+        mockKex = ret.get();
+        return ret;
+      }));
+
+  Connect connect;
+  connect.context = context_;
+  connect.sni = "www.hostname.com";
+  fizz::Param param = std::move(connect);
+  auto actions = detail::processEvent(state_, param);
+  expectActions<MutateState, WriteToSocket>(actions);
+  processStateMutations(actions);
+  EXPECT_EQ(state_.state(), StateEnum::ExpectingServerHello);
+  EXPECT_EQ(state_.keyExchangers()->size(), 1);
+  EXPECT_EQ(state_.keyExchangers()->at(NamedGroup::secp256r1).get(), mockKex);
+}
+
+TEST_F(ClientProtocolTest, TestConnectGroupHintUnsupported) {
+  context_->setDefaultShares({NamedGroup::x25519});
+  context_->setSupportedGroups({NamedGroup::x25519, NamedGroup::secp256r1});
+  auto groupHintCache = std::make_shared<SynchronizedLruGroupHintCache>(10);
+  groupHintCache->putGroup("www.hostname.com", NamedGroup::secp521r1);
+  groupHintCache->putGroup("other.hostname.com", NamedGroup::secp256r1);
+  context_->setGroupHintCache(groupHintCache);
+
+  Connect connect;
+  connect.context = context_;
+  connect.sni = "www.hostname.com";
+  fizz::Param param = std::move(connect);
+  auto actions = detail::processEvent(state_, param);
+  expectActions<MutateState, WriteToSocket>(actions);
+  processStateMutations(actions);
+  EXPECT_EQ(state_.keyExchangers()->size(), 1);
+  EXPECT_EQ(state_.keyExchangers()->count(NamedGroup::x25519), 1);
+}
+
 TEST_F(ClientProtocolTest, TestConnectNoShares) {
   context_->setDefaultShares({});
   Connect connect;
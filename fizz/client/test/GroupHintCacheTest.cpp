@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+
+#include <fizz/client/GroupHintCache.h>
+
+namespace fizz {
+namespace client {
+namespace test {
+
+TEST(SynchronizedLruGroupHintCacheTest, TestBasic) {
+  SynchronizedLruGroupHintCache cache(3);
+  EXPECT_FALSE(cache.getGroup("fizz").has_value());
+
+  cache.putGroup("fizz", NamedGroup::secp256r1);
+  EXPECT_EQ(*cache.getGroup("fizz"), NamedGroup::secp256r1);
+
+  cache.putGroup("fizz", NamedGroup::x25519);
+  EXPECT_EQ(*cache.getGroup("fizz"), NamedGroup::x25519);
+
+  cache.removeGroup("fizz");
+  EXPECT_FALSE(cache.getGroup("fizz").has_value());
+}
+
+TEST(SynchronizedLruGroupHintCacheTest, TestEviction) {
+  SynchronizedLruGroupHintCache cache(3);
+  cache.putGroup("host1", NamedGroup::x25519);
+  cache.putGroup("host2", NamedGroup::secp256r1);
+  cache.putGroup("host3", NamedGroup::secp384r1);
+
+  // Looking up host1 makes host2 the least recently used.
+  EXPECT_TRUE(cache.getGroup("host1").has_value());
+  cache.putGroup("host4", NamedGroup::x25519);
+
+  EXPECT_TRUE(cache.getGroup("host1").has_value());
+  EXPECT_FALSE(cache.getGroup("host2").has_value());
+  EXPECT_TRUE(cache.getGroup("host3").has_value());
+  EXPECT_TRUE(cache.getGroup("host4").has_value());
+}
+} // namespace test
+} // namespace client
+} // namespace fizz
@@ -0,0 +1,220 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+
+#include <fizz/client/PersistentPskCache.h>
+#include <fizz/client/test/Utilities.h>
+#include <fizz/protocol/clock/test/Mocks.h>
+#include <fizz/protocol/test/Mocks.h>
+#include <folly/FileUtil.h>
+#include <folly/testing/TestUtil.h>
+
+#include <fcntl.h>
+
+using namespace fizz::test;
+using namespace testing;
+
+namespace fizz {
+namespace client {
+namespace test {
+
+class PersistentPskCacheTest : public Test {
+ public:
+  void SetUp() override {
+    // The store keeps expiration times in seconds.
+    ticketTime_ = std::chrono::time_point_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now());
+    now_ = ticketTime_;
+    factory_ = std::make_shared<MockFactory>();
+    clock_ = std::make_shared<NiceMock<MockClock>>();
+    ON_CALL(*clock_, getCurrentTime()).WillByDefault(Invoke([this]() {
+      return now_;
+    }));
+    path_ = (dir_.path() / "psks").string();
+  }
+
+ protected:
+  std::unique_ptr<PersistentPskCache> makeCache(
+      PersistentPskCacheOptions options = {}) {
+    auto cache =
+        std::make_unique<PersistentPskCache>(path_, factory_, options);
+    cache->setClock(clock_);
+    return cache;
+  }
+
+  CachedPsk getCachedPsk(std::string pskName = "PSK") {
+    return getTestPsk(pskName, ticketTime_);
+  }
+
+  std::string readLog() {
+    std::string contents;
+    EXPECT_TRUE(folly::readFile(path_.c_str(), contents));
+    return contents;
+  }
+
+  void writeLog(const std::string& contents) {
+    EXPECT_TRUE(folly::writeFile(contents, path_.c_str()));
+  }
+
+  folly::test::TemporaryDirectory dir_;
+  std::string path_;
+  std::shared_ptr<Factory> factory_;
+  std::shared_ptr<NiceMock<MockClock>> clock_;
+  std::chrono::system_clock::time_point ticketTime_;
+  std::chrono::system_clock::time_point now_;
+};
+
+TEST_F(PersistentPskCacheTest, TestBasic) {
+  auto cache = makeCache();
+  EXPECT_FALSE(cache->getPsk("fizz"));
+
+  auto psk = getCachedPsk();
+  cache->putPsk("fizz", psk);
+  auto cachedPsk = cache->getPsk("fizz");
+  ASSERT_TRUE(cachedPsk);
+  pskEq(psk, *cachedPsk);
+
+  cache->removePsk("fizz");
+  EXPECT_FALSE(cache->getPsk("fizz"));
+  EXPECT_EQ(cache->size(), 0);
+}
+
+TEST_F(PersistentPskCacheTest, TestSurvivesRestart) {
+  auto psk1 = getCachedPsk("PSK1");
+  auto psk2 = getCachedPsk("PSK2");
+  {
+    auto cache = makeCache();
+    cache->putPsk("fizz", getCachedPsk("old"));
+    cache->putPsk("fizz", psk1);
+    cache->putPsk("facebook", psk2);
+    cache->putPsk("removed", getCachedPsk());
+    cache->removePsk("removed");
+  }
+
+  auto cache = makeCache();
+  EXPECT_EQ(cache->size(), 2);
+  auto cachedPsk1 = cache->getPsk("fizz");
+  ASSERT_TRUE(cachedPsk1);
+  pskEq(psk1, *cachedPsk1);
+  auto cachedPsk2 = cache->getPsk("facebook");
+  ASSERT_TRUE(cachedPsk2);
+  pskEq(psk2, *cachedPsk2);
+  EXPECT_FALSE(cache->getPsk("removed"));
+}
+
+TEST_F(PersistentPskCacheTest, TestExpiration) {
+  auto cache = makeCache();
+  auto psk = getCachedPsk();
+  cache->putPsk("fizz", psk);
+
+  now_ = psk.ticketExpirationTime - std::chrono::seconds(1);
+  EXPECT_TRUE(cache->getPsk("fizz"));
+  now_ = psk.ticketExpirationTime;
+  EXPECT_FALSE(cache->getPsk("fizz"));
+
+  EXPECT_EQ(cache->size(), 1);
+  cache->compact();
+  EXPECT_EQ(cache->size(), 0);
+}
+
+TEST_F(PersistentPskCacheTest, TestSharedBetweenCaches) {
+  auto cache1 = makeCache();
+  auto cache2 = makeCache();
+  auto psk = getCachedPsk();
+
+  cache1->putPsk("fizz", psk);
+  auto cachedPsk = cache2->getPsk("fizz");
+  ASSERT_TRUE(cachedPsk);
+  pskEq(psk, *cachedPsk);
+
+  cache2->removePsk("fizz");
+  EXPECT_FALSE(cache1->getPsk("fizz"));
+
+  // Compaction replaces the file cache2 has open.
+  cache1->putPsk("fizz", psk);
+  EXPECT_TRUE(cache2->getPsk("fizz"));
+  cache1->compact();
+  cache1->putPsk("facebook", getCachedPsk("PSK2"));
+  EXPECT_TRUE(cache2->getPsk("fizz"));
+  EXPECT_TRUE(cache2->getPsk("facebook"));
+
+  cache2->putPsk("instagram", getCachedPsk("PSK3"));
+  EXPECT_TRUE(cache1->getPsk("instagram"));
+  EXPECT_EQ(cache1->size(), 3);
+}
+
+TEST_F(PersistentPskCacheTest, TestTornRecord) {
+  auto psk = getCachedPsk();
+  {
+    auto cache = makeCache();
+    cache->putPsk("fizz", psk);
+    cache->putPsk("facebook", getCachedPsk("PSK2"));
+  }
+
+  // Simulate a crash part way through writing the second record.
+  auto contents = readLog();
+  auto full = contents.size();
+  makeCache()->removePsk("facebook");
+  contents = readLog();
+  writeLog(contents.substr(0, full + (contents.size() - full) / 2));
+
+  auto cache = makeCache();
+  EXPECT_TRUE(cache->getPsk("fizz"));
+  EXPECT_TRUE(cache->getPsk("facebook"));
+
+  // The next write replaces the torn record.
+  cache->putPsk("instagram", getCachedPsk("PSK3"));
+  auto reopened = makeCache();
+  EXPECT_EQ(reopened->size(), 3);
+  auto cachedPsk = reopened->getPsk("instagram");
+  ASSERT_TRUE(cachedPsk);
+  pskEq(getCachedPsk("PSK3"), *cachedPsk);
+}
+
+TEST_F(PersistentPskCacheTest, TestCorruptRecord) {
+  {
+    auto cache = makeCache();
+    cache->putPsk("fizz", getCachedPsk());
+    cache->putPsk("facebook", getCachedPsk("PSK2"));
+  }
+
+  auto contents = readLog();
+  contents.back() ^= 0xff;
+  writeLog(contents);
+
+  auto cache = makeCache();
+  EXPECT_TRUE(cache->getPsk("fizz"));
+  EXPECT_FALSE(cache->getPsk("facebook"));
+}
+
+TEST_F(PersistentPskCacheTest, TestAutomaticCompaction) {
+  PersistentPskCacheOptions options;
+  options.compactionMinBytes = 1;
+  auto cache = makeCache(options);
+  auto psk = getCachedPsk();
+  cache->putPsk("fizz", psk);
+  auto singleEntrySize = readLog().size();
+
+  for (size_t i = 0; i < 10; i++) {
+    cache->putPsk("fizz", psk);
+    EXPECT_LE(readLog().size(), 2 * singleEntrySize);
+  }
+  auto cachedPsk = makeCache()->getPsk("fizz");
+  ASSERT_TRUE(cachedPsk);
+  pskEq(psk, *cachedPsk);
+}
+
+TEST_F(PersistentPskCacheTest, TestNotAPskStore) {
+  writeLog("this is not a psk store");
+  EXPECT_THROW(makeCache(), std::runtime_error);
+}
+} // namespace test
+} // namespace client
+} // namespace fizz
@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+
+#include <fizz/client/PooledPskCache.h>
+#include <fizz/client/test/Utilities.h>
+
+using namespace testing;
+
+namespace fizz {
+namespace client {
+namespace test {
+
+class PooledPskCacheTest : public Test {
+ public:
+  void SetUp() override {
+    ticketTime_ = std::chrono::system_clock::now();
+  }
+
+ protected:
+  CachedPsk getCachedPsk(std::string pskName = "PSK") {
+    return getTestPsk(pskName, ticketTime_);
+  }
+
+  std::chrono::system_clock::time_point ticketTime_;
+};
+
+TEST_F(PooledPskCacheTest, TestBasic) {
+  PooledPskCache cache(100, 4);
+  auto psk = getCachedPsk();
+  cache.putPsk("fizz", psk);
+  EXPECT_EQ(cache.getNumPsks("fizz"), 1);
+  auto cachedPsk = cache.getPsk("fizz");
+  ASSERT_TRUE(cachedPsk);
+  pskEq(psk, *cachedPsk);
+
+  // Handing out a PSK consumes it.
+  EXPECT_EQ(cache.getNumPsks("fizz"), 0);
+  EXPECT_FALSE(cache.getPsk("fizz"));
+}
+
+TEST_F(PooledPskCacheTest, TestDistinctPsks) {
+  PooledPskCache cache(100, 4);
+  for (auto name : {"psk1", "psk2", "psk3"}) {
+    cache.putPsk("fizz", getCachedPsk(name));
+  }
+  EXPECT_EQ(cache.getNumPsks("fizz"), 3);
+
+  // Oldest first.
+  for (auto name : {"psk1", "psk2", "psk3"}) {
+    auto cachedPsk = cache.getPsk("fizz");
+    ASSERT_TRUE(cachedPsk);
+    EXPECT_EQ(cachedPsk->psk, name);
+  }
+  EXPECT_FALSE(cache.getPsk("fizz"));
+}
+
+TEST_F(PooledPskCacheTest, TestPoolLimit) {
+  PooledPskCache cache(100, 2);
+  for (auto name : {"psk1", "psk2", "psk3"}) {
+    cache.putPsk("fizz", getCachedPsk(name));
+  }
+  EXPECT_EQ(cache.getNumPsks("fizz"), 2);
+  EXPECT_EQ(cache.getPsk("fizz")->psk, "psk2");
+  EXPECT_EQ(cache.getPsk("fizz")->psk, "psk3");
+}
+
+TEST_F(PooledPskCacheTest, TestRemove) {
+  PooledPskCache cache(100, 4);
+  cache.putPsk("fizz", getCachedPsk("psk1"));
+  cache.putPsk("fizz", getCachedPsk("psk2"));
+  cache.putPsk("facebook", getCachedPsk("psk3"));
+  cache.removePsk("fizz");
+  EXPECT_FALSE(cache.getPsk("fizz"));
+  EXPECT_TRUE(cache.getPsk("facebook"));
+}
+
+TEST_F(PooledPskCacheTest, TestExpiredSkipped) {
+  PooledPskCache cache(100, 4);
+  auto expired = getCachedPsk("expired");
+  expired.ticketExpirationTime =
+      std::chrono::system_clock::now() - std::chrono::seconds(10);
+  cache.putPsk("fizz", expired);
+  cache.putPsk("fizz", getCachedPsk("valid"));
+
+  auto cachedPsk = cache.getPsk("fizz");
+  ASSERT_TRUE(cachedPsk);
+  EXPECT_EQ(cachedPsk->psk, "valid");
+  EXPECT_EQ(cache.getNumPsks("fizz"), 0);
+
+  cache.putPsk("fizz", expired);
+  EXPECT_FALSE(cache.getPsk("fizz"));
+}
+
+TEST_F(PooledPskCacheTest, TestEviction) {
+  PooledPskCache cache(2, 4);
+  cache.putPsk("psk 1", getCachedPsk("psk 1"));
+  cache.putPsk("psk 2", getCachedPsk("psk 2"));
+  cache.putPsk("psk 2", getCachedPsk("psk 2"));
+  cache.putPsk("psk 3", getCachedPsk("psk 3"));
+
+  EXPECT_EQ(cache.getNumPsks("psk 1"), 0);
+  EXPECT_EQ(cache.getNumPsks("psk 2"), 2);
+  EXPECT_EQ(cache.getNumPsks("psk 3"), 1);
+}
+
+TEST_F(PooledPskCacheTest, TestEmptyPool) {
+  EXPECT_THROW(PooledPskCache(100, 0), std::runtime_error);
+}
+} // namespace test
+} // namespace client
+} // namespace fizz
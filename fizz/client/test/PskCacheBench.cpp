@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/init/Init.h>
+
+#include <fizz/client/ShardedLruPskCache.h>
+#include <fizz/client/SynchronizedLruPskCache.h>
+
+#include <thread>
+
+using namespace fizz;
+using namespace fizz::client;
+
+// Many client threads resuming against a few hundred hosts. Each operation is
+// a getPsk, and every 16th operation also stores a new ticket.
+
+namespace {
+
+const size_t kNumIdentities = 512;
+
+CachedPsk makePsk(const std::string& identity) {
+  CachedPsk psk;
+  psk.psk = identity;
+  psk.secret = std::string(48, 's');
+  psk.type = PskType::Resumption;
+  psk.version = ProtocolVersion::tls_1_3;
+  psk.cipher = CipherSuite::TLS_AES_128_GCM_SHA256;
+  psk.group = NamedGroup::x25519;
+  psk.alpn = "h2";
+  psk.ticketAgeAdd = 0x11111111;
+  psk.ticketIssueTime = std::chrono::system_clock::now();
+  psk.ticketExpirationTime = psk.ticketIssueTime + std::chrono::hours(1);
+  psk.ticketHandshakeTime = psk.ticketIssueTime;
+  return psk;
+}
+
+template <class Cache, class GetFn>
+void runContended(size_t iters, size_t numThreads, GetFn get) {
+  std::unique_ptr<Cache> cache;
+  std::vector<std::string> identities;
+  std::vector<CachedPsk> psks;
+  BENCHMARK_SUSPEND {
+    cache = std::make_unique<Cache>(kNumIdentities * 2);
+    for (size_t i = 0; i < kNumIdentities; i++) {
+      identities.push_back(folly::sformat("host{}.example.com", i));
+      psks.push_back(makePsk(identities.back()));
+      cache->putPsk(identities.back(), psks.back());
+    }
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < numThreads; t++) {
+    threads.emplace_back([&, t]() {
+      size_t ops = iters / numThreads;
+      for (size_t i = 0; i < ops; i++) {
+        size_t index = (i * 31 + t * 7919) % kNumIdentities;
+        if (i % 16 == 0) {
+          cache->putPsk(identities[index], psks[index]);
+        }
+        folly::doNotOptimizeAway(get(*cache, identities[index]));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void synchronizedLru(size_t iters, size_t numThreads) {
+  runContended<SynchronizedLruPskCache>(
+      iters, numThreads, [](auto& cache, const std::string& identity) {
+        return cache.getPsk(identity);
+      });
+}
+
+void shardedLru(size_t iters, size_t numThreads) {
+  runContended<ShardedLruPskCache>(
+      iters, numThreads, [](auto& cache, const std::string& identity) {
+        return cache.getPsk(identity);
+      });
+}
+
+void shardedLruShared(size_t iters, size_t numThreads) {
+  runContended<ShardedLruPskCache>(
+      iters, numThreads, [](auto& cache, const std::string& identity) {
+        return cache.getSharedPsk(identity);
+      });
+}
+} // namespace
+
+BENCHMARK_PARAM(synchronizedLru, 1)
+BENCHMARK_RELATIVE_PARAM(shardedLru, 1)
+BENCHMARK_RELATIVE_PARAM(shardedLruShared, 1)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(synchronizedLru, 8)
+BENCHMARK_RELATIVE_PARAM(shardedLru, 8)
+BENCHMARK_RELATIVE_PARAM(shardedLruShared, 8)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(synchronizedLru, 32)
+BENCHMARK_RELATIVE_PARAM(shardedLru, 32)
+BENCHMARK_RELATIVE_PARAM(shardedLruShared, 32)
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+
+#include <fizz/client/ShardedLruPskCache.h>
+#include <fizz/client/test/Utilities.h>
+#include <folly/Format.h>
+
+using namespace testing;
+
+namespace fizz {
+namespace client {
+namespace test {
+
+class ShardedLruPskCacheTest : public Test {
+ public:
+  void SetUp() override {
+    ticketTime_ = std::chrono::system_clock::now();
+  }
+
+ protected:
+  CachedPsk getCachedPsk(std::string pskName = "PSK") {
+    return getTestPsk(pskName, ticketTime_);
+  }
+
+  std::chrono::system_clock::time_point ticketTime_;
+};
+
+TEST_F(ShardedLruPskCacheTest, TestBasic) {
+  ShardedLruPskCache cache(100);
+  auto psk = getCachedPsk();
+  cache.putPsk("fizz", psk);
+  auto cachedPsk = cache.getPsk("fizz");
+  EXPECT_TRUE(cachedPsk);
+  pskEq(psk, *cachedPsk);
+
+  auto sharedPsk1 = cache.getSharedPsk("fizz");
+  auto sharedPsk2 = cache.getSharedPsk("fizz");
+  ASSERT_TRUE(sharedPsk1);
+  EXPECT_EQ(sharedPsk1, sharedPsk2);
+  pskEq(psk, *sharedPsk1);
+
+  cache.removePsk("fizz");
+  EXPECT_FALSE(cache.getPsk("fizz"));
+  EXPECT_FALSE(cache.getSharedPsk("fizz"));
+
+  // Handed out PSKs are unaffected by removal.
+  pskEq(psk, *sharedPsk1);
+}
+
+TEST_F(ShardedLruPskCacheTest, TestEviction) {
+  // A single shard behaves like SynchronizedLruPskCache.
+  ShardedLruPskCache cache(3, 1);
+  for (int i : {1, 2, 3}) {
+    auto pskName = folly::sformat("psk {}", i);
+    auto psk = getCachedPsk(pskName);
+    cache.putPsk(pskName, psk);
+  }
+
+  // Prime 1 to be evicted
+  cache.getPsk("psk 2");
+  cache.getPsk("psk 3");
+
+  auto evictingPsk = getCachedPsk("psk 4");
+  cache.putPsk("psk 4", evictingPsk);
+
+  EXPECT_FALSE(cache.getPsk("psk 1"));
+  EXPECT_TRUE(cache.getPsk("psk 2"));
+  EXPECT_TRUE(cache.getPsk("psk 3"));
+  EXPECT_TRUE(cache.getPsk("psk 4"));
+}
+
+TEST_F(ShardedLruPskCacheTest, TestManyShards) {
+  ShardedLruPskCache cache(1000, 8);
+  for (int i = 0; i < 100; i++) {
+    auto pskName = folly::sformat("psk {}", i);
+    cache.putPsk(pskName, getCachedPsk(pskName));
+  }
+  for (int i = 0; i < 100; i++) {
+    auto pskName = folly::sformat("psk {}", i);
+    auto psk = cache.getSharedPsk(pskName);
+    ASSERT_TRUE(psk);
+    EXPECT_EQ(psk->psk, pskName);
+  }
+}
+
+TEST_F(ShardedLruPskCacheTest, TestExpiredGet) {
+  ShardedLruPskCache cache(100);
+  auto pskName = "let_it_expire_psk";
+  auto psk = getCachedPsk(pskName);
+  psk.ticketExpirationTime =
+      std::chrono::system_clock::now() - std::chrono::seconds(10);
+  cache.putPsk(pskName, psk);
+  EXPECT_FALSE(cache.getSharedPsk(pskName));
+  EXPECT_FALSE(cache.getPsk(pskName));
+}
+
+TEST_F(ShardedLruPskCacheTest, TestNoShards) {
+  EXPECT_THROW(ShardedLruPskCache(100, 0), std::runtime_error);
+}
+
+} // namespace test
+} // namespace client
+} // namespace fizz
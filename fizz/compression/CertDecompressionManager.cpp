@@ -7,9 +7,30 @@
  */
 
 #include <fizz/compression/CertDecompressionManager.h>
+#include <folly/Utility.h>
+#include <folly/ssl/OpenSSLHash.h>
 
 namespace fizz {
 
+namespace {
+CertificateMsg cloneCertificateMsg(const CertificateMsg& msg) {
+  CertificateMsg clone;
+  if (msg.certificate_request_context) {
+    clone.certificate_request_context =
+        msg.certificate_request_context->clone();
+  }
+  for (const auto& entry : msg.certificate_list) {
+    CertificateEntry entryClone;
+    entryClone.cert_data = entry.cert_data->clone();
+    for (const auto& ext : entry.extensions) {
+      entryClone.extensions.push_back(ext.clone());
+    }
+    clone.certificate_list.push_back(std::move(entryClone));
+  }
+  return clone;
+}
+} // namespace
+
 CertDecompressionManager::CertDecompressionManager() {}
 
 CertDecompressionManager::CertDecompressionManager(
@@ -45,4 +66,65 @@ CertDecompressionManager::getDecompressor(
   }
 }
 
+void CertDecompressionManager::setDecompressedCertCacheSize(
+    size_t maxEntries) {
+  if (maxEntries == 0) {
+    decompressedCache_.reset();
+  } else {
+    decompressedCache_ =
+        std::make_unique<folly::Synchronized<EvictingCertMap>>(
+            EvictingCertMap(maxEntries));
+  }
+}
+
+CertificateMsg CertDecompressionManager::decompress(
+    const CompressedCertificate& cert) const {
+  auto decompressor = getDecompressor(cert.algorithm);
+  if (!decompressor) {
+    throw std::runtime_error(
+        "no decompressor for algorithm: " + toString(cert.algorithm));
+  }
+  if (!decompressedCache_) {
+    return decompressor->decompress(cert);
+  }
+
+  auto key = getCacheKey(cert);
+  {
+    auto cache = decompressedCache_->wlock();
+    auto it = cache->find(key);
+    if (it != cache->end()) {
+      return cloneCertificateMsg(it->second);
+    }
+  }
+
+  auto msg = decompressor->decompress(cert);
+  decompressedCache_->wlock()->set(std::move(key), cloneCertificateMsg(msg));
+  return msg;
+}
+
+/* static */ std::string CertDecompressionManager::getCacheKey(
+    const CompressedCertificate& cert) {
+  std::array<uint8_t, 32> digest;
+  if (cert.compressed_certificate_message) {
+    folly::ssl::OpenSSLHash::sha256(
+        folly::range(digest), *cert.compressed_certificate_message);
+  } else {
+    folly::ssl::OpenSSLHash::sha256(folly::range(digest), folly::ByteRange());
+  }
+
+  // The decompressors reject messages whose uncompressed_length doesn't
+  // match, so it has to be part of the key as well.
+  std::string key;
+  key.reserve(
+      sizeof(cert.algorithm) + sizeof(cert.uncompressed_length) +
+      digest.size());
+  auto algo = folly::to_underlying(cert.algorithm);
+  key.append(reinterpret_cast<const char*>(&algo), sizeof(algo));
+  key.append(
+      reinterpret_cast<const char*>(&cert.uncompressed_length),
+      sizeof(cert.uncompressed_length));
+  key.append(reinterpret_cast<const char*>(digest.data()), digest.size());
+  return key;
+}
+
 } // namespace fizz
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <fizz/compression/CertificateCompressor.h>
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
 
 #include <map>
 #include <vector>
@@ -44,13 +46,34 @@ class CertDecompressionManager {
   std::shared_ptr<CertificateDecompressor> getDecompressor(
       CertificateCompressionAlgorithm algo) const;
 
+  /**
+   * Keep up to maxEntries decompressed certificate messages, keyed by the
+   * algorithm and a hash of the compressed message. Peers usually send the
+   * same compressed chain every time, so repeated messages are not
+   * decompressed again. 0 disables the cache, which is the default.
+   */
+  void setDecompressedCertCacheSize(size_t maxEntries);
+
+  /**
+   * Decompress cert with the decompressor for its algorithm, or return a copy
+   * of the result for an identical compressed message seen before. Throws if
+   * the algorithm is unsupported or decompression fails.
+   */
+  CertificateMsg decompress(const CompressedCertificate& cert) const;
+
  private:
+  using EvictingCertMap = folly::EvictingCacheMap<std::string, CertificateMsg>;
+
+  static std::string getCacheKey(const CompressedCertificate& cert);
+
   std::map<
       CertificateCompressionAlgorithm,
       std::shared_ptr<CertificateDecompressor>>
       decompressors_;
 
   std::vector<CertificateCompressionAlgorithm> supportedAlgos_;
+
+  std::unique_ptr<folly::Synchronized<EvictingCertMap>> decompressedCache_;
 };
 
 } // namespace fizz
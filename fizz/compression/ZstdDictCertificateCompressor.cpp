@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/compression/ZstdDictCertificateCompressor.h>
+#include <zdict.h>
+#include <zstd.h>
+
+using namespace folly;
+
+namespace fizz {
+
+void ZstdDictCertificateCompressor::CDictDeleter::operator()(
+    ZSTD_CDict* dict) const {
+  ZSTD_freeCDict(dict);
+}
+
+ZstdDictCertificateCompressor::ZstdDictCertificateCompressor(
+    int compressLevel,
+    ByteRange dictionary)
+    : dict_(ZSTD_createCDict(
+          dictionary.data(),
+          dictionary.size(),
+          compressLevel)) {
+  if (!dict_) {
+    throw std::runtime_error("Failed to create zstd compression dictionary");
+  }
+}
+
+CertificateCompressionAlgorithm ZstdDictCertificateCompressor::getAlgorithm()
+    const {
+  return CertificateCompressionAlgorithm::zstd_dictionary;
+}
+
+CompressedCertificate ZstdDictCertificateCompressor::compress(
+    const CertificateMsg& cert) {
+  auto encoded = encode(cert);
+  auto certRange = encoded->coalesce();
+  auto compressedCert = IOBuf::create(ZSTD_compressBound(certRange.size()));
+
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> ctx(
+      ZSTD_createCCtx(), &ZSTD_freeCCtx);
+  if (!ctx) {
+    throw std::bad_alloc();
+  }
+
+  auto status = ZSTD_compress_usingCDict(
+      ctx.get(),
+      compressedCert->writableData(),
+      compressedCert->tailroom(),
+      certRange.data(),
+      certRange.size(),
+      dict_.get());
+
+  if (ZSTD_isError(status)) {
+    std::string errorMsg("Failed to compress cert with zstd dictionary: ");
+    errorMsg += ZSTD_getErrorName(status);
+    throw std::runtime_error(std::move(errorMsg));
+  }
+
+  // with successful compression, status holds compressed size
+  compressedCert->append(status);
+
+  CompressedCertificate cc;
+  cc.uncompressed_length = certRange.size();
+  cc.algorithm = getAlgorithm();
+  cc.compressed_certificate_message = std::move(compressedCert);
+  return cc;
+}
+
+/* static */ std::string ZstdDictCertificateCompressor::trainDictionary(
+    const std::vector<CertificateMsg>& samples,
+    size_t maxSize) {
+  std::string sampleData;
+  std::vector<size_t> sampleSizes;
+  for (const auto& sample : samples) {
+    auto encoded = encode(sample);
+    auto range = encoded->coalesce();
+    sampleData.append(
+        reinterpret_cast<const char*>(range.data()), range.size());
+    sampleSizes.push_back(range.size());
+  }
+
+  std::string dictionary(maxSize, '\0');
+  auto status = ZDICT_trainFromBuffer(
+      &dictionary[0],
+      dictionary.size(),
+      sampleData.data(),
+      sampleSizes.data(),
+      sampleSizes.size());
+
+  if (ZDICT_isError(status)) {
+    std::string errorMsg("Failed to train zstd dictionary: ");
+    errorMsg += ZDICT_getErrorName(status);
+    throw std::runtime_error(std::move(errorMsg));
+  }
+
+  dictionary.resize(status);
+  return dictionary;
+}
+
+} // namespace fizz
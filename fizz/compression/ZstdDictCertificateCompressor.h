@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/compression/CertificateCompressor.h>
+
+struct ZSTD_CDict_s;
+
+namespace fizz {
+
+/**
+ * Compresses certificates with zstd and a dictionary that has been shared
+ * with peers out of band, using the private zstd_dictionary code point. With
+ * a dictionary trained on the chains a server sends, common intermediates and
+ * names are encoded as references into the dictionary.
+ */
+class ZstdDictCertificateCompressor : public CertificateCompressor {
+ public:
+  ZstdDictCertificateCompressor(int compressLevel, folly::ByteRange dictionary);
+  ~ZstdDictCertificateCompressor() override = default;
+
+  CertificateCompressionAlgorithm getAlgorithm() const override;
+
+  CompressedCertificate compress(const CertificateMsg&) override;
+
+  /**
+   * Trains a dictionary of at most maxSize bytes on the encoding of the
+   * sample certificate messages. Throws if training fails, for example
+   * because there are too few samples.
+   */
+  static std::string trainDictionary(
+      const std::vector<CertificateMsg>& samples,
+      size_t maxSize);
+
+ private:
+  struct CDictDeleter {
+    void operator()(ZSTD_CDict_s* dict) const;
+  };
+
+  std::unique_ptr<ZSTD_CDict_s, CDictDeleter> dict_;
+};
+} // namespace fizz
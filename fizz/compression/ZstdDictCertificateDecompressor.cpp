@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/compression/ZstdDictCertificateDecompressor.h>
+#include <zstd.h>
+
+using namespace folly;
+
+namespace fizz {
+
+void ZstdDictCertificateDecompressor::DDictDeleter::operator()(
+    ZSTD_DDict* dict) const {
+  ZSTD_freeDDict(dict);
+}
+
+ZstdDictCertificateDecompressor::ZstdDictCertificateDecompressor(
+    ByteRange dictionary)
+    : dict_(ZSTD_createDDict(dictionary.data(), dictionary.size())) {
+  if (!dict_) {
+    throw std::runtime_error("Failed to create zstd decompression dictionary");
+  }
+}
+
+CertificateCompressionAlgorithm ZstdDictCertificateDecompressor::getAlgorithm()
+    const {
+  return CertificateCompressionAlgorithm::zstd_dictionary;
+}
+
+CertificateMsg ZstdDictCertificateDecompressor::decompress(
+    const CompressedCertificate& cc) {
+  if (cc.algorithm != getAlgorithm()) {
+    throw std::runtime_error(
+        "Compressed certificate uses non-zstd_dictionary algorithm: " +
+        toString(cc.algorithm));
+  }
+
+  if (cc.uncompressed_length > kMaxHandshakeSize) {
+    throw std::runtime_error(
+        "Compressed certificate exceeds maximum certificate message size");
+  }
+
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx(
+      ZSTD_createDCtx(), &ZSTD_freeDCtx);
+  if (!ctx) {
+    throw std::bad_alloc();
+  }
+
+  auto rawCertMessage = IOBuf::create(cc.uncompressed_length);
+  auto compRange = cc.compressed_certificate_message->coalesce();
+  auto status = ZSTD_decompress_usingDDict(
+      ctx.get(),
+      rawCertMessage->writableData(),
+      rawCertMessage->tailroom(),
+      compRange.data(),
+      compRange.size(),
+      dict_.get());
+
+  if (ZSTD_isError(status)) {
+    std::string errorMsg("Failed to decompress cert with zstd dictionary: ");
+    errorMsg += ZSTD_getErrorName(status);
+    throw std::runtime_error(std::move(errorMsg));
+  }
+
+  if (status != cc.uncompressed_length) {
+    throw std::runtime_error("Uncompressed length incorrect");
+  }
+
+  if (status == 0) {
+    throw std::runtime_error("Compressed certificate is zero-length");
+  }
+
+  // with successful decompression, status holds uncompressed size
+  rawCertMessage->append(status);
+  return decode<CertificateMsg>(std::move(rawCertMessage));
+}
+
+} // namespace fizz
@@ -0,0 +1,37 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/compression/CertificateCompressor.h>
+
+struct ZSTD_DDict_s;
+
+namespace fizz {
+
+/**
+ * Decompresses certificates compressed by ZstdDictCertificateCompressor. The
+ * dictionary must be the one the peer compressed with.
+ */
+class ZstdDictCertificateDecompressor : public CertificateDecompressor {
+ public:
+  explicit ZstdDictCertificateDecompressor(folly::ByteRange dictionary);
+  ~ZstdDictCertificateDecompressor() override = default;
+
+  CertificateCompressionAlgorithm getAlgorithm() const override;
+
+  CertificateMsg decompress(const CompressedCertificate&) override;
+
+ private:
+  struct DDictDeleter {
+    void operator()(ZSTD_DDict_s* dict) const;
+  };
+
+  std::unique_ptr<ZSTD_DDict_s, DDictDeleter> dict_;
+};
+} // namespace fizz
@@ -78,5 +78,80 @@ TEST_F(CertDecompressionManagerTest, TestSameOverwrites) {
   EXPECT_EQ(decomp3, fetchedDecomp2);
 }
 
+TEST_F(CertDecompressionManagerTest, TestDecompress) {
+  auto decomp = makeMockDecompressor(1);
+  manager_->setDecompressors(
+      {std::static_pointer_cast<CertificateDecompressor>(decomp)});
+
+  CompressedCertificate cc;
+  cc.algorithm = toAlgo(1);
+  cc.uncompressed_length = 5;
+  cc.compressed_certificate_message = folly::IOBuf::copyBuffer("compressed");
+
+  EXPECT_CALL(*decomp, decompress(_))
+      .Times(2)
+      .WillRepeatedly(InvokeWithoutArgs([]() {
+        CertificateMsg msg;
+        msg.certificate_request_context = folly::IOBuf::create(0);
+        return msg;
+      }));
+  manager_->decompress(cc);
+  manager_->decompress(cc);
+
+  cc.algorithm = toAlgo(2);
+  EXPECT_THROW(manager_->decompress(cc), std::runtime_error);
+}
+
+TEST_F(CertDecompressionManagerTest, TestDecompressCached) {
+  auto decomp = makeMockDecompressor(1);
+  manager_->setDecompressors(
+      {std::static_pointer_cast<CertificateDecompressor>(decomp)});
+  manager_->setDecompressedCertCacheSize(10);
+
+  CompressedCertificate cc;
+  cc.algorithm = toAlgo(1);
+  cc.uncompressed_length = 5;
+  cc.compressed_certificate_message = folly::IOBuf::copyBuffer("compressed");
+
+  auto makeMsg = [](const std::string& cert) {
+    CertificateMsg msg;
+    msg.certificate_request_context = folly::IOBuf::create(0);
+    CertificateEntry entry;
+    entry.cert_data = folly::IOBuf::copyBuffer(cert);
+    msg.certificate_list.push_back(std::move(entry));
+    return msg;
+  };
+
+  EXPECT_CALL(*decomp, decompress(_))
+      .WillOnce(InvokeWithoutArgs([&]() { return makeMsg("cert1"); }));
+  auto msg = manager_->decompress(cc);
+  EXPECT_EQ(msg.certificate_list.at(0).cert_data->moveToFbString(), "cert1");
+
+  // Served from the cache, and not affected by consuming the first result.
+  msg = manager_->decompress(cc);
+  EXPECT_EQ(msg.certificate_list.at(0).cert_data->moveToFbString(), "cert1");
+
+  // A different compressed message, or a different claimed length, is
+  // decompressed again.
+  cc.compressed_certificate_message = folly::IOBuf::copyBuffer("compressed2");
+  EXPECT_CALL(*decomp, decompress(_))
+      .WillOnce(InvokeWithoutArgs([&]() { return makeMsg("cert2"); }));
+  msg = manager_->decompress(cc);
+  EXPECT_EQ(msg.certificate_list.at(0).cert_data->moveToFbString(), "cert2");
+
+  cc.uncompressed_length = 6;
+  EXPECT_CALL(*decomp, decompress(_))
+      .WillOnce(InvokeWithoutArgs([]() -> CertificateMsg {
+        throw std::runtime_error("length mismatch");
+      }));
+  EXPECT_THROW(manager_->decompress(cc), std::runtime_error);
+
+  // Failures are not cached.
+  EXPECT_CALL(*decomp, decompress(_))
+      .WillOnce(InvokeWithoutArgs([&]() { return makeMsg("cert3"); }));
+  msg = manager_->decompress(cc);
+  EXPECT_EQ(msg.certificate_list.at(0).cert_data->moveToFbString(), "cert3");
+}
+
 } // namespace test
 } // namespace fizz
@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+
+#include <fizz/backend/openssl/certificate/CertUtils.h>
+#include <fizz/compression/ZstdCertificateCompressor.h>
+#include <fizz/compression/ZstdDictCertificateCompressor.h>
+#include <fizz/compression/ZstdDictCertificateDecompressor.h>
+#include <fizz/crypto/Utils.h>
+#include <fizz/protocol/test/CertUtil.h>
+
+using namespace folly;
+using namespace testing;
+
+namespace fizz {
+namespace test {
+
+class ZstdDictCertificateCompressorTest : public testing::Test {
+ public:
+  void SetUp() override {
+    CryptoUtils::init();
+    root_ = createCert("root", true, nullptr);
+    intermediate_ = createCert("intermediate", true, &root_);
+  }
+
+ protected:
+  static CertificateMsg makeChain(const std::string& cn, CertAndKey& issuer) {
+    auto leaf = createCert(cn, false, &issuer);
+    std::vector<folly::ssl::X509UniquePtr> certs;
+    certs.push_back(std::move(leaf.cert));
+    X509_up_ref(issuer.cert.get());
+    certs.push_back(folly::ssl::X509UniquePtr(issuer.cert.get()));
+    return openssl::CertUtils::getCertMessage(certs, IOBuf::create(0));
+  }
+
+  static std::string trainDictionary(CertAndKey& issuer) {
+    std::vector<CertificateMsg> samples;
+    for (size_t i = 0; i < 32; i++) {
+      samples.push_back(makeChain(folly::to<std::string>("leaf", i), issuer));
+    }
+    return ZstdDictCertificateCompressor::trainDictionary(samples, 4096);
+  }
+
+  CertAndKey root_;
+  CertAndKey intermediate_;
+};
+
+TEST_F(ZstdDictCertificateCompressorTest, TestCompressDecompress) {
+  auto dictionary = trainDictionary(intermediate_);
+  EXPECT_FALSE(dictionary.empty());
+  EXPECT_LE(dictionary.size(), 4096);
+
+  ZstdDictCertificateCompressor compressor(19, StringPiece(dictionary));
+  ZstdDictCertificateDecompressor decompressor{StringPiece(dictionary)};
+
+  auto certMsg = makeChain("fizz", intermediate_);
+  auto compressedCertMsg = compressor.compress(certMsg);
+  EXPECT_EQ(
+      compressedCertMsg.algorithm,
+      CertificateCompressionAlgorithm::zstd_dictionary);
+
+  // The intermediate is in the dictionary, so this should beat plain zstd.
+  auto plainCompressedCertMsg = ZstdCertificateCompressor(19).compress(certMsg);
+  const auto& compressed = compressedCertMsg.compressed_certificate_message;
+  const auto& plainCompressed =
+      plainCompressedCertMsg.compressed_certificate_message;
+  EXPECT_LT(
+      compressed->computeChainDataLength(),
+      plainCompressed->computeChainDataLength());
+
+  auto decompressedCertMsg = decompressor.decompress(compressedCertMsg);
+  EXPECT_EQ(decompressedCertMsg.certificate_list.size(), 2);
+  EXPECT_TRUE(IOBufEqualTo()(encode(certMsg), encode(decompressedCertMsg)));
+}
+
+TEST_F(ZstdDictCertificateCompressorTest, TestWrongDictionary) {
+  auto dictionary = trainDictionary(intermediate_);
+  auto otherIntermediate = createCert("other", true, &root_);
+  auto otherDictionary = trainDictionary(otherIntermediate);
+
+  ZstdDictCertificateCompressor compressor(19, StringPiece(dictionary));
+  ZstdDictCertificateDecompressor decompressor{StringPiece(otherDictionary)};
+
+  auto compressedCertMsg =
+      compressor.compress(makeChain("fizz", intermediate_));
+  EXPECT_THROW(decompressor.decompress(compressedCertMsg), std::runtime_error);
+}
+
+TEST_F(ZstdDictCertificateCompressorTest, TestTrainTooFewSamples) {
+  std::vector<CertificateMsg> samples;
+  samples.push_back(makeChain("fizz", intermediate_));
+  EXPECT_THROW(
+      ZstdDictCertificateCompressor::trainDictionary(samples, 4096),
+      std::runtime_error);
+}
+
+TEST_F(ZstdDictCertificateCompressorTest, TestBadMessageWrongAlgo) {
+  auto dictionary = trainDictionary(intermediate_);
+  ZstdDictCertificateCompressor compressor(19, StringPiece(dictionary));
+  ZstdDictCertificateDecompressor decompressor{StringPiece(dictionary)};
+
+  auto compressedCertMsg =
+      compressor.compress(makeChain("fizz", intermediate_));
+  compressedCertMsg.algorithm = CertificateCompressionAlgorithm::zstd;
+  try {
+    decompressor.decompress(compressedCertMsg);
+    FAIL() << "Decompressor decompressed cert erroneously";
+  } catch (const std::exception& e) {
+    EXPECT_THAT(e.what(), HasSubstr("non-zstd_dictionary algorithm"));
+  }
+}
+} // namespace test
+} // namespace fizz
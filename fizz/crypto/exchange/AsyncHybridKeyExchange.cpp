@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+#include <fizz/crypto/exchange/AsyncHybridKeyExchange.h>
+
+#include <folly/futures/Future.h>
+
+namespace fizz {
+
+namespace {
+AsyncKeyExchange::DoKexResult doKex(KeyExchange& kex, folly::ByteRange peer) {
+  AsyncKeyExchange::DoKexResult result;
+  kex.generateKeyPair();
+  result.sharedSecret = kex.generateSharedSecret(peer);
+  result.ourKeyShare = kex.getKeyShare();
+  return result;
+}
+} // namespace
+
+AsyncHybridKeyExchange::AsyncHybridKeyExchange(
+    std::unique_ptr<KeyExchange> first,
+    std::unique_ptr<KeyExchange> second,
+    std::shared_ptr<folly::Executor> executor)
+    : hybrid_(std::move(first), std::move(second)) {
+  if (executor == nullptr) {
+    throw std::runtime_error("Passing null Executor!");
+  }
+  executor_ = std::move(executor);
+}
+
+void AsyncHybridKeyExchange::generateKeyPair() {
+  hybrid_.generateKeyPair();
+}
+
+std::unique_ptr<folly::IOBuf> AsyncHybridKeyExchange::getKeyShare() const {
+  return hybrid_.getKeyShare();
+}
+
+std::unique_ptr<folly::IOBuf> AsyncHybridKeyExchange::generateSharedSecret(
+    folly::ByteRange keyShare) const {
+  return hybrid_.generateSharedSecret(keyShare);
+}
+
+std::unique_ptr<KeyExchange> AsyncHybridKeyExchange::clone() const {
+  return std::make_unique<AsyncHybridKeyExchange>(
+      hybrid_.getFirstKex().clone(),
+      hybrid_.getSecondKex().clone(),
+      executor_);
+}
+
+std::size_t AsyncHybridKeyExchange::getExpectedKeyShareSize() const {
+  return hybrid_.getExpectedKeyShareSize();
+}
+
+folly::SemiFuture<AsyncKeyExchange::DoKexResult>
+AsyncHybridKeyExchange::doAsyncKexFuture(
+    std::unique_ptr<folly::IOBuf> peerKeyShare) {
+  std::shared_ptr<folly::IOBuf> peer = std::move(peerKeyShare);
+  std::pair<folly::ByteRange, folly::ByteRange> keyShares;
+  try {
+    hybrid_.checkExpectedKeyShareSizes();
+    keyShares = hybrid_.splitKeyShare(peer->coalesce());
+  } catch (const std::exception& e) {
+    return folly::makeSemiFuture<DoKexResult>(
+        folly::exception_wrapper(std::current_exception(), e));
+  }
+
+  auto keepAlive = folly::getKeepAliveToken(executor_.get());
+  auto firstFuture = folly::via(
+      keepAlive, [kex = &hybrid_.getFirstKex(), peer, keyShares]() {
+        return doKex(*kex, keyShares.first);
+      });
+  auto secondFuture = folly::via(
+      keepAlive, [kex = &hybrid_.getSecondKex(), peer, keyShares]() {
+        return doKex(*kex, keyShares.second);
+      });
+  // Both halves use this object, so wait for both even if one fails.
+  return folly::collectAll(std::move(firstFuture), std::move(secondFuture))
+      .semi()
+      .deferValue([](std::tuple<
+                         folly::Try<DoKexResult>,
+                         folly::Try<DoKexResult>> results) {
+        auto& first = std::get<0>(results).value();
+        auto& second = std::get<1>(results).value();
+        DoKexResult combined;
+        combined.sharedSecret = std::move(first.sharedSecret);
+        combined.sharedSecret->appendToChain(std::move(second.sharedSecret));
+        combined.ourKeyShare = std::move(first.ourKeyShare);
+        combined.ourKeyShare->appendToChain(std::move(second.ourKeyShare));
+        return combined;
+      });
+}
+} // namespace fizz
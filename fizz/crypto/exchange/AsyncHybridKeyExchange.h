@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/crypto/exchange/AsyncKeyExchange.h>
+#include <fizz/crypto/exchange/HybridKeyExchange.h>
+#include <folly/Executor.h>
+
+namespace fizz {
+/**
+ * Hybrid key exchange (see HybridKeyExchange) whose server side runs the two
+ * component key exchanges concurrently on an executor. For post-quantum
+ * hybrid groups this hides the classical half behind the KEM half instead of
+ * running them back to back on the IO thread.
+ *
+ * The synchronous KeyExchange methods are those of a HybridKeyExchange over
+ * the same components. Servers opt in by returning this from their
+ * Factory::makeKeyExchange() for hybrid groups.
+ */
+class AsyncHybridKeyExchange : public AsyncKeyExchange {
+ public:
+  AsyncHybridKeyExchange(
+      std::unique_ptr<KeyExchange> first,
+      std::unique_ptr<KeyExchange> second,
+      std::shared_ptr<folly::Executor> executor);
+
+  ~AsyncHybridKeyExchange() override = default;
+
+  void generateKeyPair() override;
+
+  std::unique_ptr<folly::IOBuf> getKeyShare() const override;
+
+  std::unique_ptr<folly::IOBuf> generateSharedSecret(
+      folly::ByteRange keyShare) const override;
+
+  std::unique_ptr<KeyExchange> clone() const override;
+
+  std::size_t getExpectedKeyShareSize() const override;
+
+  /**
+   * Generates key pairs for, and shared secrets with, both component key
+   * exchanges concurrently on the executor. This object must outlive the
+   * returned future.
+   */
+  folly::SemiFuture<DoKexResult> doAsyncKexFuture(
+      std::unique_ptr<folly::IOBuf> peerKeyShare) override;
+
+ private:
+  HybridKeyExchange hybrid_;
+  std::shared_ptr<folly::Executor> executor_;
+};
+} // namespace fizz
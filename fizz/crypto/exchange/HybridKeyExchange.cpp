@@ -22,6 +22,10 @@ HybridKeyExchange::HybridKeyExchange(
 void HybridKeyExchange::generateKeyPair() {
   firstKex_->generateKeyPair();
   secondKex_->generateKeyPair();
+  checkExpectedKeyShareSizes();
+}
+
+void HybridKeyExchange::checkExpectedKeyShareSizes() const {
   if (firstKex_->getExpectedKeyShareSize() == 0 ||
       secondKex_->getExpectedKeyShareSize() == 0) {
     throw std::runtime_error("expected key share size is 0!");
@@ -46,6 +50,15 @@ std::unique_ptr<folly::IOBuf> HybridKeyExchange::getKeyShare() const {
 
 std::unique_ptr<folly::IOBuf> HybridKeyExchange::generateSharedSecret(
     folly::ByteRange keyShare) const {
+  auto keyShares = splitKeyShare(keyShare);
+  auto sharedSecret = firstKex_->generateSharedSecret(keyShares.first);
+  sharedSecret->appendToChain(
+      secondKex_->generateSharedSecret(keyShares.second));
+  return sharedSecret;
+}
+
+std::pair<folly::ByteRange, folly::ByteRange> HybridKeyExchange::splitKeyShare(
+    folly::ByteRange keyShare) const {
   if (keyShare.size() !=
       firstKex_->getExpectedKeyShareSize() +
           secondKex_->getExpectedKeyShareSize()) {
@@ -55,12 +68,9 @@ std::unique_ptr<folly::IOBuf> HybridKeyExchange::generateSharedSecret(
   auto firstKeyShare = folly::ByteRange(
       keyShare.begin(),
       keyShare.begin() + firstKex_->getExpectedKeyShareSize());
-  auto sharedSecret = firstKex_->generateSharedSecret(std::move(firstKeyShare));
   auto secondKeyShare = folly::ByteRange(
       keyShare.end() - secondKex_->getExpectedKeyShareSize(), keyShare.end());
-  sharedSecret->appendToChain(
-      secondKex_->generateSharedSecret(std::move(secondKeyShare)));
-  return sharedSecret;
+  return std::make_pair(firstKeyShare, secondKeyShare);
 }
 
 /**
@@ -36,6 +36,35 @@ class HybridKeyExchange : public KeyExchange {
 
   std::size_t getExpectedKeyShareSize() const override;
 
+  /**
+   * The component key exchanges, for callers that run them separately (see
+   * AsyncHybridKeyExchange).
+   */
+  KeyExchange& getFirstKex() {
+    return *firstKex_;
+  }
+  const KeyExchange& getFirstKex() const {
+    return *firstKex_;
+  }
+  KeyExchange& getSecondKex() {
+    return *secondKex_;
+  }
+  const KeyExchange& getSecondKex() const {
+    return *secondKex_;
+  }
+
+  /**
+   * Throws if either component key exchange does not know its key share size.
+   */
+  void checkExpectedKeyShareSizes() const;
+
+  /**
+   * Splits a peer's hybrid key share into the first and second component
+   * key shares. Throws if the size does not match getExpectedKeyShareSize().
+   */
+  std::pair<folly::ByteRange, folly::ByteRange> splitKeyShare(
+      folly::ByteRange keyShare) const;
+
  private:
   std::unique_ptr<KeyExchange> firstKex_;
   std::unique_ptr<KeyExchange> secondKex_;
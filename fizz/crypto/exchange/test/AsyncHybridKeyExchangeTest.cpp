@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/crypto/exchange/AsyncHybridKeyExchange.h>
+#include <fizz/crypto/exchange/test/Mocks.h>
+#include <folly/executors/InlineExecutor.h>
+#include <folly/executors/ManualExecutor.h>
+#include <folly/portability/GTest.h>
+
+namespace fizz {
+namespace test {
+class AsyncHybridKeyExchangeTest : public testing::Test {
+ public:
+  void SetUp() override {
+    executor_ = std::make_shared<folly::ManualExecutor>();
+    auto firstKex = std::make_unique<MockKeyExchange>();
+    firstKex->setForHybridKeyExchange();
+    first_ = firstKex.get();
+    auto secondKex = std::make_unique<MockKeyExchange>();
+    secondKex->setForHybridKeyExchange();
+    second_ = secondKex.get();
+    kex_ = std::make_unique<AsyncHybridKeyExchange>(
+        std::move(firstKex), std::move(secondKex), executor_);
+  }
+
+ protected:
+  std::shared_ptr<folly::ManualExecutor> executor_;
+  MockKeyExchange* first_;
+  MockKeyExchange* second_;
+  std::unique_ptr<AsyncHybridKeyExchange> kex_;
+};
+
+TEST_F(AsyncHybridKeyExchangeTest, DoAsyncKex) {
+  auto peerShare = folly::IOBuf::copyBuffer("keysharekeyshare");
+  EXPECT_CALL(*first_, generateKeyPair());
+  EXPECT_CALL(*second_, generateKeyPair());
+  auto expectShare = [](folly::ByteRange share) {
+    EXPECT_EQ(folly::StringPiece(share), "keyshare");
+    return folly::IOBuf::copyBuffer("sharedsecret");
+  };
+  EXPECT_CALL(*first_, generateSharedSecret(_)).WillOnce(Invoke(expectShare));
+  EXPECT_CALL(*second_, generateSharedSecret(_)).WillOnce(Invoke(expectShare));
+
+  auto future = kex_->doAsyncKexFuture(std::move(peerShare));
+  EXPECT_FALSE(future.isReady());
+  // Both component key exchanges are scheduled independently.
+  EXPECT_EQ(executor_->run(), 2);
+
+  auto result = std::move(future).via(executor_.get()).getVia(executor_.get());
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      result.sharedSecret,
+      folly::IOBuf::copyBuffer("sharedsecretsharedsecret")));
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      result.ourKeyShare, folly::IOBuf::copyBuffer("keysharekeyshare")));
+}
+
+TEST_F(AsyncHybridKeyExchangeTest, DoAsyncKexInvalidShare) {
+  auto future =
+      kex_->doAsyncKexFuture(folly::IOBuf::copyBuffer("keyshare"));
+  EXPECT_EQ(executor_->run(), 0);
+  EXPECT_THROW(std::move(future).get(), std::runtime_error);
+}
+
+TEST_F(AsyncHybridKeyExchangeTest, DoAsyncKexComponentError) {
+  EXPECT_CALL(*second_, generateSharedSecret(_))
+      .WillOnce(Throw(std::runtime_error("kem failure")));
+  auto future =
+      kex_->doAsyncKexFuture(folly::IOBuf::copyBuffer("keysharekeyshare"));
+  executor_->run();
+  EXPECT_THROW(
+      std::move(future).via(executor_.get()).getVia(executor_.get()),
+      std::runtime_error);
+}
+
+TEST_F(AsyncHybridKeyExchangeTest, DoAsyncKexWaitsForBothHalves) {
+  EXPECT_CALL(*first_, generateSharedSecret(_))
+      .WillOnce(Throw(std::runtime_error("invalid point")));
+  auto future =
+      kex_->doAsyncKexFuture(folly::IOBuf::copyBuffer("keysharekeyshare"))
+          .via(&folly::InlineExecutor::instance());
+  // The caller may destroy the key exchange as soon as the future completes,
+  // so the failed first half must not complete it while the second half is
+  // still queued.
+  EXPECT_CALL(*second_, generateSharedSecret(_))
+      .WillOnce(InvokeWithoutArgs([&future]() {
+        EXPECT_FALSE(future.isReady());
+        return folly::IOBuf::copyBuffer("sharedsecret");
+      }));
+  executor_->run();
+  ASSERT_TRUE(future.isReady());
+  EXPECT_THROW(std::move(future).get(), std::runtime_error);
+}
+
+TEST_F(AsyncHybridKeyExchangeTest, SyncMatchesHybrid) {
+  kex_->generateKeyPair();
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      kex_->getKeyShare(), folly::IOBuf::copyBuffer("keysharekeyshare")));
+  auto sharedSecret = kex_->generateSharedSecret(
+      folly::range(folly::StringPiece("keysharekeyshare")));
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      sharedSecret, folly::IOBuf::copyBuffer("sharedsecretsharedsecret")));
+  EXPECT_THROW(
+      kex_->generateSharedSecret(folly::range(folly::StringPiece("keyshare"))),
+      std::runtime_error);
+}
+
+TEST_F(AsyncHybridKeyExchangeTest, Clone) {
+  kex_->generateKeyPair();
+  auto copy = kex_->clone();
+  EXPECT_NE(dynamic_cast<AsyncHybridKeyExchange*>(copy.get()), nullptr);
+  EXPECT_TRUE(folly::IOBufEqualTo()(kex_->getKeyShare(), copy->getKeyShare()));
+}
+} // namespace test
+} // namespace fizz
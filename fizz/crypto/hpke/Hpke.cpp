@@ -25,29 +25,47 @@ static std::unique_ptr<folly::IOBuf> writeKeyScheduleContext(
   return keyScheduleContext;
 }
 
+std::unique_ptr<folly::IOBuf> makeKeyScheduleContext(
+    Mode mode,
+    std::unique_ptr<folly::IOBuf> pskId,
+    std::unique_ptr<folly::IOBuf> info,
+    fizz::hpke::Hkdf& hkdf,
+    const folly::IOBuf& suiteId) {
+  // Generate hashes for key schedule context
+  std::vector<uint8_t> pskIdHash = hkdf.labeledExtract(
+      folly::IOBuf::copyBuffer(""),
+      folly::ByteRange(folly::StringPiece("psk_id_hash")),
+      std::move(pskId),
+      suiteId.clone());
+  std::vector<uint8_t> infoHash = hkdf.labeledExtract(
+      folly::IOBuf::copyBuffer(""),
+      folly::ByteRange(folly::StringPiece("info_hash")),
+      std::move(info),
+      suiteId.clone());
+  return writeKeyScheduleContext(mode, pskIdHash, infoHash);
+}
+
 std::unique_ptr<HpkeContext> keySchedule(KeyScheduleParams params) {
   auto hkdf = std::move(params.hkdf);
 
   auto psk = params.pskInputs.hasValue()
       ? std::move(params.pskInputs.value().psk)
       : PskInputs::getDefaultPsk();
-  auto pskId = params.pskInputs.hasValue()
-      ? std::move(params.pskInputs.value().id)
-      : PskInputs::getDefaultId();
 
-  // Generate hashes for key schedule context
-  std::vector<uint8_t> pskIdHash = hkdf->labeledExtract(
-      folly::IOBuf::copyBuffer(""),
-      folly::ByteRange(folly::StringPiece("psk_id_hash")),
-      std::move(pskId),
-      params.suiteId->clone());
-  std::vector<uint8_t> infoHash = hkdf->labeledExtract(
-      folly::IOBuf::copyBuffer(""),
-      folly::ByteRange(folly::StringPiece("info_hash")),
-      std::move(params.info),
-      params.suiteId->clone());
-  std::unique_ptr<folly::IOBuf> keyScheduleContext =
-      writeKeyScheduleContext(params.mode, pskIdHash, infoHash);
+  std::unique_ptr<folly::IOBuf> keyScheduleContext;
+  if (params.keyScheduleContext) {
+    keyScheduleContext = std::move(params.keyScheduleContext);
+  } else {
+    auto pskId = params.pskInputs.hasValue()
+        ? std::move(params.pskInputs.value().id)
+        : PskInputs::getDefaultId();
+    keyScheduleContext = makeKeyScheduleContext(
+        params.mode,
+        std::move(pskId),
+        std::move(params.info),
+        *hkdf,
+        *params.suiteId);
+  }
 
   // Generate hashes for cipher key
   std::vector<uint8_t> secret = hkdf->labeledExtract(
@@ -118,7 +136,8 @@ SetupResult setupWithEncap(
       std::move(param.hkdf),
       std::move(param.suiteId),
       HpkeContext::Role::Sender,
-      param.seqNum};
+      param.seqNum,
+      std::move(param.keyScheduleContext)};
 
   SetupResult result{
       std::move(encapResult.enc), keySchedule(std::move(keyScheduleParams))};
@@ -152,7 +171,8 @@ std::unique_ptr<HpkeContext> setupWithDecap(
       std::move(param.hkdf),
       std::move(param.suiteId),
       HpkeContext::Role::Receiver,
-      param.seqNum};
+      param.seqNum,
+      std::move(param.keyScheduleContext)};
 
   return keySchedule(std::move(keyScheduleParams));
 }
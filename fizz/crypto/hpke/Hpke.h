@@ -60,8 +60,23 @@ struct KeyScheduleParams {
   std::unique_ptr<folly::IOBuf> suiteId;
   fizz::hpke::HpkeContext::Role ctxRole{fizz::hpke::HpkeContext::Role::Sender};
   uint64_t seqNum{0};
+  // Result of makeKeyScheduleContext() for this mode, info, psk id and suite.
+  // If set, info and the psk id are not hashed again.
+  std::unique_ptr<folly::IOBuf> keyScheduleContext;
 };
 
+/**
+ * Computes key_schedule_context (mode || psk_id_hash || info_hash, see RFC
+ * 9180 Section 5.1). It only depends on the mode, psk id, info and suite, so
+ * it can be computed once for many contexts set up with the same parameters.
+ */
+std::unique_ptr<folly::IOBuf> makeKeyScheduleContext(
+    Mode mode,
+    std::unique_ptr<folly::IOBuf> pskId,
+    std::unique_ptr<folly::IOBuf> info,
+    fizz::hpke::Hkdf& hkdf,
+    const folly::IOBuf& suiteId);
+
 std::unique_ptr<HpkeContext> keySchedule(KeyScheduleParams params);
 
 struct SetupResult {
@@ -75,6 +90,8 @@ struct SetupParam {
   std::unique_ptr<fizz::hpke::Hkdf> hkdf;
   std::unique_ptr<folly::IOBuf> suiteId;
   uint64_t seqNum{0};
+  // See KeyScheduleParams::keyScheduleContext.
+  std::unique_ptr<folly::IOBuf> keyScheduleContext;
 };
 
 SetupResult setupWithEncap(
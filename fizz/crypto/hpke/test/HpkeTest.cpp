@@ -2183,6 +2183,42 @@ TEST(HpkeTest, TestKeySchedule) {
   }
 }
 
+TEST(HpkeTest, TestKeySchedulePrecomputedContext) {
+  for (const auto& testParam : HPKETestCases) {
+    std::unique_ptr<folly::IOBuf> suiteId =
+        generateHpkeSuiteId(testParam.group, testParam.hash, testParam.suite);
+    auto keyScheduleContext = makeKeyScheduleContext(
+        testParam.mode,
+        toIOBuf(testParam.pskId),
+        toIOBuf(testParam.info),
+        *genHKDF(testParam.hash),
+        *suiteId);
+
+    std::unique_ptr<MockAeadCipher> cipher =
+        std::make_unique<MockAeadCipher>(getCipher(testParam.suite));
+    TrafficKey expectedTrafficKey{
+        toIOBuf(testParam.key), toIOBuf(testParam.iv)};
+    EXPECT_CALL(*cipher, _setKey(TrafficKeyMatcher(&expectedTrafficKey)))
+        .Times(1);
+
+    // Info and the psk id are ignored when the context is precomputed.
+    struct KeyScheduleParams keyScheduleParams {
+      testParam.mode, toIOBuf(testParam.sharedSecret), nullptr,
+          PskInputs(
+              testParam.mode,
+              toIOBuf(testParam.psk),
+              toIOBuf(testParam.pskId)),
+          std::move(cipher), genHKDF(testParam.hash), std::move(suiteId),
+          fizz::hpke::HpkeContext::Role::Sender, 0,
+          std::move(keyScheduleContext)
+    };
+    auto context = keySchedule(std::move(keyScheduleParams));
+
+    EXPECT_TRUE(folly::IOBufEqualTo()(
+        context->getExporterSecret(), toIOBuf(testParam.exporterSecret)));
+  }
+}
+
 } // namespace test
 } // namespace hpke
 } // namespace fizz
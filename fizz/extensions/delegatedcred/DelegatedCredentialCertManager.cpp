@@ -41,6 +41,13 @@ std::shared_ptr<SelfCert> DelegatedCredentialCertManager::getCert(
   return dcRes ? dcRes : CertManager::getCert(identity);
 }
 
+// Falls back to non-delegated if no match.
+std::shared_ptr<SelfCert> DelegatedCredentialCertManager::getCertByIdentityHash(
+    uint64_t identityHash) const {
+  auto dcRes = dcMgr_.getCertByIdentityHash(identityHash);
+  return dcRes ? dcRes : CertManager::getCertByIdentityHash(identityHash);
+}
+
 void DelegatedCredentialCertManager::addDelegatedCredentialAndSetDefault(
     std::shared_ptr<SelfDelegatedCredential> cred) {
   VLOG(8) << "Adding delegated credential";
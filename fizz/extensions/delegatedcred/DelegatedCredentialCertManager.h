@@ -27,6 +27,9 @@ class DelegatedCredentialCertManager : public server::CertManager {
 
   std::shared_ptr<SelfCert> getCert(const std::string& identity) const override;
 
+  std::shared_ptr<SelfCert> getCertByIdentityHash(
+      uint64_t identityHash) const override;
+
   void addDelegatedCredentialAndSetDefault(
       std::shared_ptr<SelfDelegatedCredential> cred);
 
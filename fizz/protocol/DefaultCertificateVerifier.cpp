@@ -48,11 +48,87 @@ DefaultCertificateVerifier::createFromCAFiles(
 
 std::shared_ptr<const Cert> DefaultCertificateVerifier::verify(
     const std::vector<std::shared_ptr<const fizz::PeerCert>>& certs) const {
-  std::ignore = verifyWithX509StoreCtx(certs);
-  // Just return the original cert in the default case
+  if (!verifiedChainCache_ || certs.empty() || !canUseVerifiedChainCache()) {
+    std::ignore = verifyWithX509StoreCtx(certs);
+    // Just return the original cert in the default case
+    return certs.front();
+  }
+
+  auto key = getChainCacheKey(certs);
+  auto now = clock_->getCurrentTime();
+  {
+    auto entries = verifiedChainCache_->entries.wlock();
+    auto it = entries->find(key);
+    if (it != entries->end()) {
+      if (now < it->second) {
+        return certs.front();
+      }
+      entries->erase(it);
+    }
+  }
+
+  auto ctx = verifyWithX509StoreCtx(certs);
+
+  // The result only holds while every certificate in the verified chain,
+  // including the trust anchor from the store, is still valid.
+  auto expiry = now + verifiedChainCache_->ttl;
+  STACK_OF(X509)* chain = X509_STORE_CTX_get0_chain(ctx.get());
+  for (int i = 0; i < sk_X509_num(chain); i++) {
+    auto notAfter = folly::ssl::OpenSSLCertUtils::asnTimeToTimepoint(
+        X509_get0_notAfter(sk_X509_value(chain, i)));
+    expiry = std::min(expiry, notAfter);
+  }
+  if (now < expiry) {
+    verifiedChainCache_->entries.wlock()->set(std::move(key), expiry);
+  }
   return certs.front();
 }
 
+bool DefaultCertificateVerifier::canUseVerifiedChainCache() const {
+  // A cache hit would skip these, so they must run on every verification.
+  if (customVerifyCallback_) {
+    return false;
+  }
+  X509_STORE* store = x509Store_ ? x509Store_.get() : getDefaultX509Store();
+  if (X509_STORE_get_verify_cb(store)) {
+    return false;
+  }
+  auto flags = X509_VERIFY_PARAM_get_flags(X509_STORE_get0_param(store));
+  return (flags & (X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL)) == 0;
+}
+
+std::string DefaultCertificateVerifier::getChainCacheKey(
+    const std::vector<std::shared_ptr<const fizz::PeerCert>>& certs) const {
+  std::string key;
+  key.reserve(1 + certs.size() * SHA256_DIGEST_LENGTH);
+  key.push_back(static_cast<char>(context_));
+  auto digests = verifiedChainCache_->digests.wlock();
+  for (const auto& cert : certs) {
+    auto x509 = cert->getX509();
+    auto it = digests->find(x509.get());
+    if (it == digests->end()) {
+      VerifiedChainCache::CertDigest certDigest;
+      unsigned int digestLength = 0;
+      if (X509_digest(
+              x509.get(),
+              EVP_sha256(),
+              certDigest.digest.data(),
+              &digestLength) != 1 ||
+          digestLength != certDigest.digest.size()) {
+        throw std::runtime_error("failed to hash certificate");
+      }
+      const X509* address = x509.get();
+      certDigest.cert = std::move(x509);
+      digests->set(address, std::move(certDigest));
+      it = digests->find(address);
+    }
+    key.append(
+        reinterpret_cast<const char*>(it->second.digest.data()),
+        it->second.digest.size());
+  }
+  return key;
+}
+
 folly::ssl::X509StoreCtxUniquePtr
 DefaultCertificateVerifier::verifyWithX509StoreCtx(
     const std::vector<std::shared_ptr<const fizz::PeerCert>>& certs) const {
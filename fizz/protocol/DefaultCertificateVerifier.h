@@ -9,8 +9,13 @@
 #pragma once
 
 #include <fizz/protocol/CertificateVerifier.h>
+#include <fizz/protocol/clock/SystemClock.h>
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
 #include <folly/ssl/OpenSSLPtrTypes.h>
 
+#include <array>
+
 namespace fizz {
 
 /**
@@ -56,11 +61,49 @@ class DefaultCertificateVerifier : public CertificateVerifier {
 
   void setCustomVerifyCallback(X509VerifyCallback cb) {
     customVerifyCallback_ = cb;
+    clearVerifiedChainCache();
   }
 
   void setX509Store(folly::ssl::X509StoreUniquePtr&& store) {
     x509Store_ = std::move(store);
     createAuthorities();
+    clearVerifiedChainCache();
+  }
+
+  /**
+   * Remember chains that verify successfully, so that verify() can skip path
+   * building and signature checks when it sees the same chain again. At most
+   * maxEntries chains are kept. An entry is trusted for ttl, or until a
+   * certificate in the verified chain expires if that is sooner. Changing the
+   * store or the verify callback drops all entries.
+   *
+   * A cache hit skips X509_verify_cert() entirely, so nothing that it would
+   * check again is checked: a certificate revoked after its chain was cached
+   * is accepted until the entry expires. The cache is therefore bypassed
+   * while a custom verify callback is set, or while the store has a verify
+   * callback or CRL checking (X509_V_FLAG_CRL_CHECK or
+   * X509_V_FLAG_CRL_CHECK_ALL) enabled.
+   *
+   * verifyWithX509StoreCtx() always performs a full verification, as its
+   * callers need the resulting store context.
+   */
+  void setVerifiedChainCache(size_t maxEntries, std::chrono::seconds ttl) {
+    verifiedChainCache_ =
+        std::make_unique<VerifiedChainCache>(maxEntries, ttl);
+  }
+
+  /**
+   * Drop all cached chains. This must be called if the X509_STORE in use is
+   * modified in place.
+   */
+  void clearVerifiedChainCache() {
+    if (verifiedChainCache_) {
+      verifiedChainCache_->entries.wlock()->clear();
+    }
+  }
+
+  void setClock(std::shared_ptr<Clock> clock) {
+    clock_ = std::move(clock);
   }
 
   std::vector<Extension> getCertificateRequestExtensions() const override;
@@ -76,11 +119,46 @@ class DefaultCertificateVerifier : public CertificateVerifier {
       const std::vector<std::string>& caFile);
 
  private:
+  struct VerifiedChainCache {
+    using EvictingExpiryMap = folly::
+        EvictingCacheMap<std::string, std::chrono::system_clock::time_point>;
+
+    struct CertDigest {
+      // Held so that the X509 address keying the entry is not reused.
+      folly::ssl::X509UniquePtr cert;
+      std::array<unsigned char, SHA256_DIGEST_LENGTH> digest;
+    };
+    using EvictingDigestMap = folly::EvictingCacheMap<const X509*, CertDigest>;
+
+    // Chains are rarely longer than this, so digests of all certificates in
+    // the cached chains usually fit.
+    static constexpr size_t kDigestsPerChain = 4;
+
+    VerifiedChainCache(size_t maxEntries, std::chrono::seconds cacheTtl)
+        : entries(EvictingExpiryMap(maxEntries)),
+          digests(EvictingDigestMap(maxEntries * kDigestsPerChain)),
+          ttl(cacheTtl) {}
+
+    folly::Synchronized<EvictingExpiryMap> entries;
+    // SHA-256 of certificates seen recently, keyed by X509 object. Peer
+    // certificates are immutable, and with the X509 intern cache the same
+    // intermediates are shared by every connection.
+    folly::Synchronized<EvictingDigestMap> digests;
+    std::chrono::seconds ttl;
+  };
+
   void createAuthorities();
 
+  bool canUseVerifiedChainCache() const;
+
+  std::string getChainCacheKey(
+      const std::vector<std::shared_ptr<const fizz::PeerCert>>& certs) const;
+
   CertificateAuthorities authorities_;
   VerificationContext context_;
   folly::ssl::X509StoreUniquePtr x509Store_;
   X509VerifyCallback customVerifyCallback_{nullptr};
+  std::unique_ptr<VerifiedChainCache> verifiedChainCache_;
+  std::shared_ptr<Clock> clock_ = std::make_shared<SystemClock>();
 };
 } // namespace fizz
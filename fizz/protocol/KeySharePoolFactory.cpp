@@ -0,0 +1,207 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/protocol/KeySharePoolFactory.h>
+
+#include <fizz/crypto/exchange/AsyncKeyExchange.h>
+#include <folly/Synchronized.h>
+
+#include <atomic>
+#include <deque>
+
+namespace fizz {
+
+namespace {
+
+/**
+ * Wraps a key exchange whose key pair has already been generated. The first
+ * generateKeyPair() is a no-op so the pre-generated key pair is used.
+ */
+class PregeneratedKeyExchange : public KeyExchange {
+ public:
+  explicit PregeneratedKeyExchange(std::unique_ptr<KeyExchange> kex)
+      : kex_(std::move(kex)) {}
+
+  void generateKeyPair() override {
+    if (pregenerated_) {
+      pregenerated_ = false;
+      return;
+    }
+    kex_->generateKeyPair();
+  }
+
+  std::unique_ptr<folly::IOBuf> getKeyShare() const override {
+    return kex_->getKeyShare();
+  }
+
+  std::unique_ptr<folly::IOBuf> generateSharedSecret(
+      folly::ByteRange keyShare) const override {
+    return kex_->generateSharedSecret(keyShare);
+  }
+
+  std::unique_ptr<KeyExchange> clone() const override {
+    return kex_->clone();
+  }
+
+  std::size_t getExpectedKeyShareSize() const override {
+    return kex_->getExpectedKeyShareSize();
+  }
+
+ private:
+  std::unique_ptr<KeyExchange> kex_;
+  bool pregenerated_{true};
+};
+
+} // namespace
+
+struct KeySharePoolFactory::Pool
+    : public std::enable_shared_from_this<KeySharePoolFactory::Pool> {
+  Pool(
+      std::shared_ptr<Factory> originalIn,
+      std::shared_ptr<folly::Executor> executorIn,
+      NamedGroup groupIn,
+      KeyExchangeMode modeIn,
+      Options optionsIn)
+      : original(std::move(originalIn)),
+        executor(std::move(executorIn)),
+        group(groupIn),
+        mode(modeIn),
+        options(optionsIn) {}
+
+  std::unique_ptr<KeyExchange> take() {
+    std::unique_ptr<KeyExchange> kex;
+    size_t remaining;
+    {
+      auto lockedKeys = keys.wlock();
+      if (!lockedKeys->empty()) {
+        kex = std::move(lockedKeys->front());
+        lockedKeys->pop_front();
+      }
+      remaining = lockedKeys->size();
+    }
+    if (remaining < options.lowWaterMark) {
+      scheduleRefill();
+    }
+    if (!kex) {
+      misses.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return std::make_unique<PregeneratedKeyExchange>(std::move(kex));
+  }
+
+  void scheduleRefill() {
+    if (refillScheduled.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+    try {
+      executor->add([self = shared_from_this()]() { self->refill(); });
+    } catch (const std::exception& ex) {
+      VLOG(2) << "Failed to schedule key share refill: " << ex.what();
+      refillScheduled.store(false, std::memory_order_release);
+    }
+  }
+
+  void refill() {
+    try {
+      while (keys.rlock()->size() < options.poolSize) {
+        auto kex = original->makeKeyExchange(group, mode);
+        kex->generateKeyPair();
+        generated.fetch_add(1, std::memory_order_relaxed);
+        keys.wlock()->push_back(std::move(kex));
+      }
+    } catch (const std::exception& ex) {
+      LOG(ERROR) << "Failed to generate key share for " << toString(group)
+                 << ": " << ex.what();
+    }
+    refillScheduled.store(false, std::memory_order_release);
+  }
+
+  std::shared_ptr<Factory> original;
+  std::shared_ptr<folly::Executor> executor;
+  NamedGroup group;
+  KeyExchangeMode mode;
+  Options options;
+
+  folly::Synchronized<std::deque<std::unique_ptr<KeyExchange>>> keys;
+  std::atomic<bool> refillScheduled{false};
+
+  std::atomic<uint64_t> hits{0};
+  std::atomic<uint64_t> misses{0};
+  std::atomic<uint64_t> generated{0};
+};
+
+KeySharePoolFactory::KeySharePoolFactory(
+    std::shared_ptr<Factory> original,
+    std::shared_ptr<folly::Executor> executor,
+    std::vector<NamedGroup> groups,
+    KeyExchangeMode mode)
+    : KeySharePoolFactory(
+          std::move(original),
+          std::move(executor),
+          std::move(groups),
+          mode,
+          Options()) {}
+
+KeySharePoolFactory::KeySharePoolFactory(
+    std::shared_ptr<Factory> original,
+    std::shared_ptr<folly::Executor> executor,
+    std::vector<NamedGroup> groups,
+    KeyExchangeMode mode,
+    Options options)
+    : original_(std::move(original)), mode_(mode) {
+  for (auto group : groups) {
+    auto kex = original_->makeKeyExchange(group, mode_);
+    if (dynamic_cast<AsyncKeyExchange*>(kex.get())) {
+      VLOG(2) << "Not pooling asynchronous key exchange for "
+              << toString(group);
+      continue;
+    }
+    auto pool =
+        std::make_shared<Pool>(original_, executor, group, mode_, options);
+    pool->scheduleRefill();
+    pools_.emplace(group, std::move(pool));
+  }
+}
+
+KeySharePoolFactory::~KeySharePoolFactory() = default;
+
+std::unique_ptr<KeyExchange> KeySharePoolFactory::makeKeyExchange(
+    NamedGroup group,
+    KeyExchangeMode mode) const {
+  if (mode == mode_) {
+    auto it = pools_.find(group);
+    if (it != pools_.end()) {
+      auto kex = it->second->take();
+      if (kex) {
+        return kex;
+      }
+    }
+  }
+  return original_->makeKeyExchange(group, mode);
+}
+
+size_t KeySharePoolFactory::getAvailable(NamedGroup group) const {
+  auto it = pools_.find(group);
+  if (it == pools_.end()) {
+    return 0;
+  }
+  return it->second->keys.rlock()->size();
+}
+
+KeySharePoolFactory::Stats KeySharePoolFactory::getStats() const {
+  Stats stats;
+  for (const auto& entry : pools_) {
+    const auto& pool = *entry.second;
+    stats.hits += pool.hits.load(std::memory_order_relaxed);
+    stats.misses += pool.misses.load(std::memory_order_relaxed);
+    stats.generated += pool.generated.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+} // namespace fizz
@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/protocol/Factory.h>
+#include <folly/Executor.h>
+
+#include <map>
+
+namespace fizz {
+
+/**
+ * A decorator for an existing Factory that hands out key exchanges whose key
+ * pair was generated ahead of time on an executor, so starting a handshake
+ * doesn't wait on key generation.
+ *
+ * The first generateKeyPair() call on a pooled key exchange keeps the
+ * pre-generated key pair; later calls generate a new one as usual. Every
+ * pre-generated key pair is handed out at most once. When a pool drops below
+ * its low water mark it is refilled on the executor. If a pool is empty the
+ * original factory is used and the key pair is generated by the caller.
+ *
+ * Only the given groups in the given mode are pooled. Groups with
+ * asynchronous key exchanges (AsyncKeyExchange) are never pooled.
+ */
+class KeySharePoolFactory : public Factory {
+ public:
+  struct Options {
+    /**
+     * Number of key pairs a refill generates up to, per group.
+     */
+    size_t poolSize{16};
+
+    /**
+     * A refill is scheduled once a pool holds fewer key pairs than this.
+     */
+    size_t lowWaterMark{4};
+  };
+
+  struct Stats {
+    // Key exchanges handed out with a pre-generated key pair.
+    uint64_t hits{0};
+    // Key exchanges requested for a pooled group while its pool was empty.
+    uint64_t misses{0};
+    // Key pairs generated on the executor.
+    uint64_t generated{0};
+  };
+
+  KeySharePoolFactory(
+      std::shared_ptr<Factory> original,
+      std::shared_ptr<folly::Executor> executor,
+      std::vector<NamedGroup> groups,
+      KeyExchangeMode mode);
+
+  KeySharePoolFactory(
+      std::shared_ptr<Factory> original,
+      std::shared_ptr<folly::Executor> executor,
+      std::vector<NamedGroup> groups,
+      KeyExchangeMode mode,
+      Options options);
+
+  ~KeySharePoolFactory() override;
+
+  std::unique_ptr<PlaintextReadRecordLayer> makePlaintextReadRecordLayer()
+      const override {
+    return original_->makePlaintextReadRecordLayer();
+  }
+
+  std::unique_ptr<PlaintextWriteRecordLayer> makePlaintextWriteRecordLayer()
+      const override {
+    return original_->makePlaintextWriteRecordLayer();
+  }
+
+  std::unique_ptr<EncryptedReadRecordLayer> makeEncryptedReadRecordLayer(
+      EncryptionLevel encryptionLevel) const override {
+    return original_->makeEncryptedReadRecordLayer(encryptionLevel);
+  }
+
+  std::unique_ptr<EncryptedWriteRecordLayer> makeEncryptedWriteRecordLayer(
+      EncryptionLevel encryptionLevel) const override {
+    return original_->makeEncryptedWriteRecordLayer(encryptionLevel);
+  }
+
+  std::unique_ptr<KeyScheduler> makeKeyScheduler(
+      CipherSuite cipher) const override {
+    return original_->makeKeyScheduler(cipher);
+  }
+
+  std::unique_ptr<KeyDerivation> makeKeyDeriver(
+      CipherSuite cipher) const override {
+    return original_->makeKeyDeriver(cipher);
+  }
+
+  std::unique_ptr<HandshakeContext> makeHandshakeContext(
+      CipherSuite cipher) const override {
+    return original_->makeHandshakeContext(cipher);
+  }
+
+  std::unique_ptr<KeyExchange> makeKeyExchange(
+      NamedGroup group,
+      KeyExchangeMode mode) const override;
+
+  std::unique_ptr<Aead> makeAead(CipherSuite cipher) const override {
+    return original_->makeAead(cipher);
+  }
+
+  Random makeRandom() const override {
+    return original_->makeRandom();
+  }
+
+  uint32_t makeTicketAgeAdd() const override {
+    return original_->makeTicketAgeAdd();
+  }
+
+  std::unique_ptr<folly::IOBuf> makeRandomBytes(size_t count) const override {
+    return original_->makeRandomBytes(count);
+  }
+
+  std::unique_ptr<PeerCert> makePeerCert(CertificateEntry certEntry, bool leaf)
+      const override {
+    return original_->makePeerCert(std::move(certEntry), leaf);
+  }
+
+  std::shared_ptr<Cert> makeIdentityOnlyCert(std::string ident) const override {
+    return original_->makeIdentityOnlyCert(std::move(ident));
+  }
+
+  /**
+   * Number of pre-generated key pairs currently available for group.
+   */
+  size_t getAvailable(NamedGroup group) const;
+
+  Stats getStats() const;
+
+ private:
+  struct Pool;
+
+  std::shared_ptr<Factory> original_;
+  KeyExchangeMode mode_;
+  std::map<NamedGroup, std::shared_ptr<Pool>> pools_;
+};
+} // namespace fizz
@@ -73,6 +73,8 @@ struct KeyUpdateInitiation : EventType<Event::KeyUpdateInitiation> {
 
 struct WriteNewSessionTicket : EventType<Event::WriteNewSessionTicket> {
   Buf appToken;
+  // Number of tickets to issue, all carrying appToken.
+  uint32_t count{1};
 };
 
 /**
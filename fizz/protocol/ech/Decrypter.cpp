@@ -8,91 +8,122 @@
 
 #include <fizz/protocol/ech/Decrypter.h>
 
+#include <fizz/crypto/hpke/Utils.h>
+
+#include <atomic>
+
 namespace fizz {
 namespace ech {
 
 namespace {
+// All HPKE AEADs (AES-GCM and ChaCha20-Poly1305) use a 16 byte tag.
+constexpr size_t kHpkeAeadTagLength = 16;
+} // namespace
 
-// Internal result return type. The param reference is valid since we're only
-// ever using it while holding a const reference to its parent container,
-// guaranteeing its lifetime while we use it (since it's internal to this unit)
-struct DecrypterLookupResult {
-  ech::OuterECHClientHello echExtension;
-  const DecrypterParams& matchingParam;
+struct ECHConfigManager::Counters {
+  std::atomic<uint64_t> accepted{0};
+  std::atomic<uint64_t> grease{0};
+  std::atomic<uint64_t> failed{0};
+  std::atomic<uint64_t> capped{0};
+  std::atomic<uint64_t> attempts{0};
 };
 
-// Tries to find a config in our decrypter params that matches the config ID
-// in the passed in extension. If one is found, returns the extension and the
-// matching config.
-//
-// Can return folly::none if no matching config is found.
-folly::Optional<DecrypterLookupResult> decodeAndGetParam(
-    const Extension& encodedECHExtension,
-    const std::vector<DecrypterParams>& decrypterParams) {
-  folly::io::Cursor cursor(encodedECHExtension.extension_data.get());
-  for (const auto& param : decrypterParams) {
-    switch (param.echConfig.version) {
-      case ECHVersion::Draft15: {
-        auto echExtension = getExtension<ech::OuterECHClientHello>(cursor);
-        auto& echConfig = param.echConfig;
-        auto currentConfigDraft = decode<ECHConfigContentDraft>(
-            echConfig.ech_config_content->clone());
-        if (echExtension.config_id != currentConfigDraft.key_config.config_id) {
-          continue;
-        }
-        return DecrypterLookupResult{std::move(echExtension), param};
-      }
-      default: {
-        continue;
+ECHConfigManager::ECHConfigManager() : ECHConfigManager(Options()) {}
+
+ECHConfigManager::ECHConfigManager(Options options)
+    : options_(std::move(options)), counters_(std::make_unique<Counters>()) {}
+
+ECHConfigManager::~ECHConfigManager() = default;
+
+const DecryptionSetup* ECHConfigManager::DecryptionConfig::getSetup(
+    const HpkeSymmetricCipherSuite& cipherSuite) const {
+  for (const auto& setup : setups) {
+    if (setup.cipherSuite == cipherSuite) {
+      return &setup;
+    }
+  }
+  return nullptr;
+}
+
+ECHConfigManager::Candidates ECHConfigManager::getCandidates(
+    const OuterECHClientHello& echExtension,
+    bool hrr) const {
+  auto encLength = echExtension.enc->computeChainDataLength();
+  auto payloadLength = echExtension.payload->computeChainDataLength();
+  auto usable = [&](const DecryptionConfig& config) {
+    return encLength == (hrr ? 0 : config.encLength) &&
+        payloadLength > kHpkeAeadTagLength &&
+        config.getSetup(echExtension.cipher_suite);
+  };
+
+  Candidates candidates;
+  for (auto index : configIdIndex_[echExtension.config_id]) {
+    if (usable(configs_[index])) {
+      candidates.push_back(&configs_[index]);
+    }
+  }
+  if (options_.trialDecryption) {
+    for (const auto& config : configs_) {
+      if (config.content.key_config.config_id != echExtension.config_id &&
+          usable(config)) {
+        candidates.push_back(&config);
       }
     }
   }
-  // No match
-  return folly::none;
+  return candidates;
 }
 
-folly::Optional<DecrypterResult> tryToDecodeECH(
+folly::Optional<DecrypterResult> ECHConfigManager::tryToDecodeECH(
     const ClientHello& clientHelloOuter,
-    const Extension& encodedECHExtension,
-    const std::vector<DecrypterParams>& decrypterParams) {
-  auto configIdResult = decodeAndGetParam(encodedECHExtension, decrypterParams);
+    const Extension& encodedECHExtension) {
+  folly::io::Cursor cursor(encodedECHExtension.extension_data.get());
+  auto echExtension = getExtension<ech::OuterECHClientHello>(cursor);
+  auto candidates = getCandidates(echExtension);
 
-  if (!configIdResult.has_value()) {
+  if (candidates.empty()) {
+    counters_->grease.fetch_add(1, std::memory_order_relaxed);
     return folly::none;
   }
+  if (candidates.size() > options_.maxDecryptionAttempts) {
+    counters_->capped.fetch_add(1, std::memory_order_relaxed);
+    candidates.resize(options_.maxDecryptionAttempts);
+  }
 
-  try {
-    auto context = setupDecryptionContext(
-        configIdResult->matchingParam.echConfig,
-        configIdResult->echExtension.cipher_suite,
-        configIdResult->echExtension.enc,
-        configIdResult->matchingParam.kex->clone(),
-        0);
-    auto chlo = decryptECHWithContext(
-        clientHelloOuter,
-        configIdResult->matchingParam.echConfig,
-        configIdResult->echExtension.cipher_suite,
-        configIdResult->echExtension.enc->clone(),
-        configIdResult->echExtension.config_id,
-        configIdResult->echExtension.payload->clone(),
-        ECHVersion::Draft15,
-        context);
-    return DecrypterResult{
-        std::move(chlo),
-        configIdResult->echExtension.config_id,
-        std::move(context)};
-  } catch (const OuterExtensionsError& e) {
-    throw FizzException(e.what(), AlertDescription::illegal_parameter);
-  } catch (const std::exception&) {
-    return folly::none;
+  for (const auto* config : candidates) {
+    counters_->attempts.fetch_add(1, std::memory_order_relaxed);
+    try {
+      auto context = setupDecryptionContext(
+          *config->getSetup(echExtension.cipher_suite),
+          echExtension.enc,
+          config->params.kex->clone(),
+          0);
+      auto chlo = decryptECHWithContext(
+          clientHelloOuter,
+          config->params.echConfig,
+          echExtension.cipher_suite,
+          echExtension.enc->clone(),
+          echExtension.config_id,
+          echExtension.payload->clone(),
+          ECHVersion::Draft15,
+          context);
+      counters_->accepted.fetch_add(1, std::memory_order_relaxed);
+      return DecrypterResult{
+          std::move(chlo), echExtension.config_id, std::move(context)};
+    } catch (const OuterExtensionsError& e) {
+      counters_->failed.fetch_add(1, std::memory_order_relaxed);
+      throw FizzException(e.what(), AlertDescription::illegal_parameter);
+    } catch (const std::exception&) {
+      continue;
+    }
   }
+  counters_->failed.fetch_add(1, std::memory_order_relaxed);
+  return folly::none;
 }
 
-ClientHello decodeClientHelloHRR(
+ClientHello ECHConfigManager::decodeClientHelloHRR(
     const ClientHello& chlo,
     const std::unique_ptr<folly::IOBuf>& encapsulatedKey,
-    std::unique_ptr<hpke::HpkeContext>& context,
-    const std::vector<DecrypterParams>& decrypterParams) {
+    std::unique_ptr<hpke::HpkeContext>& context) const {
   // Check for the ECH extension. If not found, throw.
   auto it =
       findExtension(chlo.extensions, ExtensionType::encrypted_client_hello);
@@ -101,9 +132,11 @@ ClientHello decodeClientHelloHRR(
         "ech not sent for hrr", AlertDescription::missing_extension);
   }
 
-  auto configIdResult = decodeAndGetParam(*it, decrypterParams);
+  folly::io::Cursor cursor(it->extension_data.get());
+  auto echExtension = getExtension<ech::OuterECHClientHello>(cursor);
+  auto candidates = getCandidates(echExtension, true);
 
-  if (!configIdResult.has_value()) {
+  if (candidates.empty()) {
     throw FizzException(
         "failed to decrypt hrr ech", AlertDescription::decrypt_error);
   }
@@ -112,29 +145,44 @@ ClientHello decodeClientHelloHRR(
     if (context) {
       return decryptECHWithContext(
           chlo,
-          configIdResult->matchingParam.echConfig,
-          configIdResult->echExtension.cipher_suite,
-          configIdResult->echExtension.enc->clone(),
-          configIdResult->echExtension.config_id,
-          configIdResult->echExtension.payload->clone(),
+          candidates.front()->params.echConfig,
+          echExtension.cipher_suite,
+          echExtension.enc->clone(),
+          echExtension.config_id,
+          echExtension.payload->clone(),
           ECHVersion::Draft15,
           context);
-    } else {
-      auto recreatedContext = setupDecryptionContext(
-          configIdResult->matchingParam.echConfig,
-          configIdResult->echExtension.cipher_suite,
-          encapsulatedKey,
-          configIdResult->matchingParam.kex->clone(),
-          1);
-      return decryptECHWithContext(
-          chlo,
-          configIdResult->matchingParam.echConfig,
-          configIdResult->echExtension.cipher_suite,
-          configIdResult->echExtension.enc->clone(),
-          configIdResult->echExtension.config_id,
-          configIdResult->echExtension.payload->clone(),
-          ECHVersion::Draft15,
-          recreatedContext);
+    }
+    if (candidates.size() > options_.maxDecryptionAttempts) {
+      candidates.resize(options_.maxDecryptionAttempts);
+    }
+    auto encapsulatedKeyLength = encapsulatedKey
+        ? encapsulatedKey->computeChainDataLength()
+        : 0;
+    for (const auto* config : candidates) {
+      if (encapsulatedKeyLength != config->encLength) {
+        continue;
+      }
+      try {
+        auto recreatedContext = setupDecryptionContext(
+            *config->getSetup(echExtension.cipher_suite),
+            encapsulatedKey,
+            config->params.kex->clone(),
+            1);
+        return decryptECHWithContext(
+            chlo,
+            config->params.echConfig,
+            echExtension.cipher_suite,
+            echExtension.enc->clone(),
+            echExtension.config_id,
+            echExtension.payload->clone(),
+            ECHVersion::Draft15,
+            recreatedContext);
+      } catch (const OuterExtensionsError&) {
+        throw;
+      } catch (const std::exception& ex) {
+        VLOG(8) << "Failed to decrypt hrr ech: " << ex.what();
+      }
     }
   } catch (const OuterExtensionsError& e) {
     throw FizzException(e.what(), AlertDescription::illegal_parameter);
@@ -144,10 +192,30 @@ ClientHello decodeClientHelloHRR(
       "failed to decrypt hrr ech", AlertDescription::decrypt_error);
 }
 
-} // namespace
-
 void ECHConfigManager::addDecryptionConfig(DecrypterParams decrypterParams) {
-  configs_.push_back(std::move(decrypterParams));
+  DecryptionConfig config;
+  config.params = std::move(decrypterParams);
+  switch (config.params.echConfig.version) {
+    case ECHVersion::Draft15: {
+      config.content = decode<ECHConfigContentDraft>(
+          config.params.echConfig.ech_config_content->clone());
+      const auto& keyConfig = config.content.key_config;
+      auto info = makeHpkeContextInfoParam(config.params.echConfig);
+      for (const auto& suite : keyConfig.cipher_suites) {
+        try {
+          config.setups.push_back(
+              makeDecryptionSetup(keyConfig.kem_id, suite, info->clone()));
+        } catch (const std::exception& ex) {
+          VLOG(8) << "Skipping unsupported ech cipher suite: " << ex.what();
+        }
+      }
+      config.encLength = hpke::nenc(keyConfig.kem_id);
+      configIdIndex_[config.content.key_config.config_id].push_back(
+          configs_.size());
+      break;
+    }
+  }
+  configs_.push_back(std::move(config));
 }
 
 folly::Optional<DecrypterResult> ECHConfigManager::decryptClientHello(
@@ -156,7 +224,7 @@ folly::Optional<DecrypterResult> ECHConfigManager::decryptClientHello(
   auto it =
       findExtension(chlo.extensions, ExtensionType::encrypted_client_hello);
   if (it != chlo.extensions.end()) {
-    return tryToDecodeECH(chlo, *it, configs_);
+    return tryToDecodeECH(chlo, *it);
   }
 
   return folly::none;
@@ -165,20 +233,30 @@ folly::Optional<DecrypterResult> ECHConfigManager::decryptClientHello(
 ClientHello ECHConfigManager::decryptClientHelloHRR(
     const ClientHello& chlo,
     std::unique_ptr<hpke::HpkeContext>& context) {
-  return decodeClientHelloHRR(chlo, nullptr, context, configs_);
+  return decodeClientHelloHRR(chlo, nullptr, context);
 }
 
 ClientHello ECHConfigManager::decryptClientHelloHRR(
     const ClientHello& chlo,
     const std::unique_ptr<folly::IOBuf>& encapsulatedKey) {
   std::unique_ptr<hpke::HpkeContext> dummy;
-  return decodeClientHelloHRR(chlo, encapsulatedKey, dummy, configs_);
+  return decodeClientHelloHRR(chlo, encapsulatedKey, dummy);
+}
+
+ECHConfigManager::Stats ECHConfigManager::getStats() const {
+  Stats stats;
+  stats.accepted = counters_->accepted.load(std::memory_order_relaxed);
+  stats.grease = counters_->grease.load(std::memory_order_relaxed);
+  stats.failed = counters_->failed.load(std::memory_order_relaxed);
+  stats.capped = counters_->capped.load(std::memory_order_relaxed);
+  stats.attempts = counters_->attempts.load(std::memory_order_relaxed);
+  return stats;
 }
 
 std::vector<ech::ECHConfig> ECHConfigManager::getRetryConfigs() const {
   std::vector<ech::ECHConfig> retryConfigs;
   for (const auto& cfg : configs_) {
-    retryConfigs.push_back(cfg.echConfig);
+    retryConfigs.push_back(cfg.params.echConfig);
   }
   return retryConfigs;
 }
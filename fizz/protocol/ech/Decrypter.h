@@ -10,6 +10,9 @@
 
 #include <fizz/protocol/ech/Encryption.h>
 #include <fizz/protocol/ech/Types.h>
+#include <folly/small_vector.h>
+
+#include <array>
 
 namespace fizz {
 namespace ech {
@@ -44,8 +47,57 @@ class Decrypter {
   virtual std::vector<ech::ECHConfig> getRetryConfigs() const = 0;
 };
 
+/**
+ * Decrypter over a set of ECH configs. Configs are decoded once when added
+ * and indexed by config_id, so finding the config for a ClientHello does not
+ * depend on the number of configs.
+ *
+ * Every decryption attempt costs a KEM decapsulation and an AEAD open, so
+ * the number of attempts per ClientHello is bounded, and extensions whose enc
+ * or payload can't be valid for a config are rejected without attempting
+ * decryption.
+ */
 class ECHConfigManager : public Decrypter {
  public:
+  struct Options {
+    /**
+     * Maximum number of configs to attempt decryption with for a single
+     * ClientHello.
+     */
+    size_t maxDecryptionAttempts{1};
+
+    /**
+     * Whether to also attempt decryption with configs whose config_id does
+     * not match the one sent by the client, after the matching ones. Needed
+     * for clients that randomize config_id, at the cost of also attempting
+     * to decrypt GREASE extensions.
+     */
+    bool trialDecryption{false};
+  };
+
+  /**
+   * Outcomes of decryptClientHello(). HelloRetryRequest decryption is not
+   * counted.
+   */
+  struct Stats {
+    // ClientHellos successfully decrypted.
+    uint64_t accepted{0};
+    // ClientHellos with no config able to decrypt them. This is what GREASE
+    // ECH (and ECH for configs we no longer have) looks like.
+    uint64_t grease{0};
+    // ClientHellos where every decryption attempt failed.
+    uint64_t failed{0};
+    // ClientHellos that had more candidate configs than
+    // Options::maxDecryptionAttempts allowed trying.
+    uint64_t capped{0};
+    // Total decryption attempts.
+    uint64_t attempts{0};
+  };
+
+  ECHConfigManager();
+  explicit ECHConfigManager(Options options);
+  ~ECHConfigManager() override;
+
   void addDecryptionConfig(DecrypterParams decrypterParams);
   folly::Optional<DecrypterResult> decryptClientHello(
       const ClientHello& chlo) override;
@@ -57,8 +109,48 @@ class ECHConfigManager : public Decrypter {
       const std::unique_ptr<folly::IOBuf>& encapsulatedKey) override;
   std::vector<ech::ECHConfig> getRetryConfigs() const override;
 
+  Stats getStats() const;
+
  private:
-  std::vector<DecrypterParams> configs_;
+  struct DecryptionConfig {
+    DecrypterParams params;
+    // Decoded ech_config_content (public name, KEM and cipher suites).
+    ECHConfigContentDraft content;
+    // Precomputed HPKE setup for each supported cipher suite of the config.
+    std::vector<DecryptionSetup> setups;
+    // Length of enc for this config's KEM.
+    size_t encLength{0};
+
+    const DecryptionSetup* getSetup(
+        const HpkeSymmetricCipherSuite& cipherSuite) const;
+  };
+
+  using Candidates = folly::small_vector<const DecryptionConfig*, 2>;
+
+  // On the HelloRetryRequest path enc is empty, as the client reuses the
+  // context from the first ClientHello.
+  Candidates getCandidates(
+      const OuterECHClientHello& echExtension,
+      bool hrr = false) const;
+
+  folly::Optional<DecrypterResult> tryToDecodeECH(
+      const ClientHello& clientHelloOuter,
+      const Extension& encodedECHExtension);
+
+  ClientHello decodeClientHelloHRR(
+      const ClientHello& chlo,
+      const std::unique_ptr<folly::IOBuf>& encapsulatedKey,
+      std::unique_ptr<hpke::HpkeContext>& context) const;
+
+  Options options_;
+
+  // All configs, in the order they were added.
+  std::vector<DecryptionConfig> configs_;
+  // Indices into configs_ of the supported configs for each config_id.
+  std::array<std::vector<size_t>, 256> configIdIndex_;
+
+  struct Counters;
+  std::unique_ptr<Counters> counters_;
 };
 
 } // namespace ech
@@ -64,24 +64,6 @@ std::unique_ptr<folly::IOBuf> extractEncodedClientHelloInner(
   return encodedClientHelloInner;
 }
 
-std::unique_ptr<folly::IOBuf> makeHpkeContextInfoParam(
-    const ECHConfig& echConfig) {
-  switch (echConfig.version) {
-    case ECHVersion::Draft15: {
-      // The "info" parameter to setupWithEncap is the
-      // concatenation of "tls ech", a zero byte, and the serialized
-      // ECHConfig.
-      std::string tlsEchPrefix = "tls ech";
-      tlsEchPrefix += '\0';
-      auto bufContents = folly::IOBuf::copyBuffer(tlsEchPrefix);
-      bufContents->prependChain(encode(echConfig));
-
-      return bufContents;
-    }
-  }
-  return nullptr;
-}
-
 bool isValidPublicName(const std::string& publicName) {
   // Starts/ends with a dot.
   if (publicName.front() == '.' || publicName.back() == '.') {
@@ -107,6 +89,24 @@ bool isValidPublicName(const std::string& publicName) {
 
 } // namespace
 
+std::unique_ptr<folly::IOBuf> makeHpkeContextInfoParam(
+    const ECHConfig& echConfig) {
+  switch (echConfig.version) {
+    case ECHVersion::Draft15: {
+      // The "info" parameter to setupWithEncap is the
+      // concatenation of "tls ech", a zero byte, and the serialized
+      // ECHConfig.
+      std::string tlsEchPrefix = "tls ech";
+      tlsEchPrefix += '\0';
+      auto bufContents = folly::IOBuf::copyBuffer(tlsEchPrefix);
+      bufContents->prependChain(encode(echConfig));
+
+      return bufContents;
+    }
+  }
+  return nullptr;
+}
+
 // We currently don't support any extensions to alter ECH behavior. As such,
 // just check that there are no mandatory extensions. (Extensions with the high
 // order bit set). Since the integer has been converted from network order to
@@ -688,36 +688,82 @@ std::unique_ptr<hpke::HpkeContext> setupDecryptionContext(
     const std::unique_ptr<folly::IOBuf>& encapsulatedKey,
     std::unique_ptr<KeyExchange> kex,
     uint64_t seqNum) {
+  folly::io::Cursor echConfigCursor(echConfig.ech_config_content.get());
+  auto decodedConfigContent = decode<ECHConfigContentDraft>(echConfigCursor);
+  return setupDecryptionContext(
+      decodedConfigContent.key_config.kem_id,
+      cipherSuite,
+      encapsulatedKey,
+      std::move(kex),
+      makeHpkeContextInfoParam(echConfig),
+      seqNum);
+}
+
+std::unique_ptr<hpke::HpkeContext> setupDecryptionContext(
+    hpke::KEMId kemId,
+    HpkeSymmetricCipherSuite cipherSuite,
+    const std::unique_ptr<folly::IOBuf>& encapsulatedKey,
+    std::unique_ptr<KeyExchange> kex,
+    std::unique_ptr<folly::IOBuf> info,
+    uint64_t seqNum) {
+  return setupDecryptionContext(
+      makeDecryptionSetup(kemId, cipherSuite, std::move(info)),
+      encapsulatedKey,
+      std::move(kex),
+      seqNum);
+}
+
+DecryptionSetup makeDecryptionSetup(
+    hpke::KEMId kemId,
+    HpkeSymmetricCipherSuite cipherSuite,
+    std::unique_ptr<folly::IOBuf> info) {
+  DecryptionSetup setup;
+  setup.kemId = kemId;
+  setup.cipherSuite = cipherSuite;
+  setup.suiteId = hpke::generateHpkeSuiteId(
+      hpke::getKexGroup(kemId),
+      hpke::getHashFunction(cipherSuite.kdf_id),
+      hpke::getCipherSuite(cipherSuite.aead_id));
+
+  auto hkdf = hpke::makeHpkeHkdf(
+      folly::IOBuf::copyBuffer("HPKE-v1"), cipherSuite.kdf_id);
+  setup.keyScheduleContext = hpke::makeKeyScheduleContext(
+      hpke::Mode::Base,
+      hpke::PskInputs::getDefaultId(),
+      std::move(info),
+      *hkdf,
+      *setup.suiteId);
+  return setup;
+}
+
+std::unique_ptr<hpke::HpkeContext> setupDecryptionContext(
+    const DecryptionSetup& setup,
+    const std::unique_ptr<folly::IOBuf>& encapsulatedKey,
+    std::unique_ptr<KeyExchange> kex,
+    uint64_t seqNum) {
   const std::unique_ptr<folly::IOBuf> prefix =
       folly::IOBuf::copyBuffer("HPKE-v1");
 
   // Get crypto primitive types used for decrypting
-  hpke::KDFId kdfId = cipherSuite.kdf_id;
-  folly::io::Cursor echConfigCursor(echConfig.ech_config_content.get());
-  auto decodedConfigContent = decode<ECHConfigContentDraft>(echConfigCursor);
-  auto kemId = decodedConfigContent.key_config.kem_id;
-  NamedGroup group = hpke::getKexGroup(kemId);
+  hpke::KDFId kdfId = setup.cipherSuite.kdf_id;
+  NamedGroup group = hpke::getKexGroup(setup.kemId);
 
   auto dhkem = std::make_unique<DHKEM>(
       std::move(kex), group, hpke::makeHpkeHkdf(prefix->clone(), kdfId));
-  auto aeadId = cipherSuite.aead_id;
-  auto suiteId = hpke::generateHpkeSuiteId(
-      group, hpke::getHashFunction(kdfId), hpke::getCipherSuite(aeadId));
 
   hpke::SetupParam setupParam{
       std::move(dhkem),
-      makeCipher(aeadId),
+      makeCipher(setup.cipherSuite.aead_id),
       hpke::makeHpkeHkdf(prefix->clone(), kdfId),
-      std::move(suiteId),
-      seqNum};
-
-  std::unique_ptr<folly::IOBuf> info = makeHpkeContextInfoParam(echConfig);
+      setup.suiteId->clone(),
+      seqNum,
+      setup.keyScheduleContext->clone()};
 
   return hpke::setupWithDecap(
       hpke::Mode::Base,
       encapsulatedKey->coalesce(),
       folly::none,
-      std::move(info),
+      nullptr,
       folly::none,
       std::move(setupParam));
 }
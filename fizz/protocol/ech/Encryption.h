@@ -37,6 +37,9 @@ folly::Optional<SupportedECHConfig> selectECHConfig(
     std::vector<hpke::KEMId> supportedKEMs,
     std::vector<hpke::AeadId> supportedAeads);
 
+std::unique_ptr<folly::IOBuf> makeHpkeContextInfoParam(
+    const ECHConfig& echConfig);
+
 hpke::SetupResult constructHpkeSetupResult(
     std::unique_ptr<KeyExchange> kex,
     const SupportedECHConfig& supportedConfig);
@@ -119,6 +122,45 @@ std::unique_ptr<hpke::HpkeContext> setupDecryptionContext(
     std::unique_ptr<KeyExchange> kex,
     uint64_t seqNum);
 
+/**
+ * Same as above, but takes the KEM and the HPKE info parameter (see
+ * makeHpkeContextInfoParam()) directly so callers that have already decoded
+ * the config don't need to decode it again.
+ */
+std::unique_ptr<hpke::HpkeContext> setupDecryptionContext(
+    hpke::KEMId kemId,
+    HpkeSymmetricCipherSuite cipherSuite,
+    const std::unique_ptr<folly::IOBuf>& encapsulatedKey,
+    std::unique_ptr<KeyExchange> kex,
+    std::unique_ptr<folly::IOBuf> info,
+    uint64_t seqNum);
+
+/**
+ * The parts of setting up an HPKE decryption context that only depend on the
+ * ECH config and the cipher suite: the HPKE suite_id and the key schedule
+ * context (which covers psk_id_hash and info_hash of the config's info).
+ * Servers can compute these once per config and cipher suite, leaving only
+ * the KEM decapsulation and the secret, key and nonce derivations for each
+ * ClientHello.
+ */
+struct DecryptionSetup {
+  hpke::KEMId kemId;
+  HpkeSymmetricCipherSuite cipherSuite;
+  std::unique_ptr<folly::IOBuf> suiteId;
+  std::unique_ptr<folly::IOBuf> keyScheduleContext;
+};
+
+DecryptionSetup makeDecryptionSetup(
+    hpke::KEMId kemId,
+    HpkeSymmetricCipherSuite cipherSuite,
+    std::unique_ptr<folly::IOBuf> info);
+
+std::unique_ptr<hpke::HpkeContext> setupDecryptionContext(
+    const DecryptionSetup& setup,
+    const std::unique_ptr<folly::IOBuf>& encapsulatedKey,
+    std::unique_ptr<KeyExchange> kex,
+    uint64_t seqNum);
+
 std::unique_ptr<folly::IOBuf> getRecordDigest(
     const ECHConfig& echConfig,
     hpke::KDFId id);
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <fizz/backend/openssl/OpenSSL.h>
+#include <fizz/crypto/test/TestUtil.h>
+#include <fizz/protocol/ech/Decrypter.h>
+#include <fizz/protocol/ech/test/TestUtil.h>
+#include <fizz/protocol/test/TestUtil.h>
+#include <fizz/record/Extensions.h>
+
+using namespace fizz;
+using namespace fizz::ech;
+using namespace fizz::test;
+
+// Server side cost of ECH: setting up the HPKE context for a ClientHello, and
+// decrypting the whole ClientHello through ECHConfigManager.
+
+namespace {
+
+const size_t kNumClientHellos = 64;
+
+std::unique_ptr<KeyExchange> makeKex() {
+  auto kex = openssl::makeOpenSSLECKeyExchange<P256>();
+  kex->setPrivateKey(getPrivateKey(kP256Key));
+  return kex;
+}
+
+HpkeSymmetricCipherSuite getCipherSuite() {
+  return HpkeSymmetricCipherSuite{
+      hpke::KDFId::Sha256, hpke::AeadId::TLS_AES_128_GCM_SHA256};
+}
+
+std::vector<ClientHello> makeClientHellos() {
+  auto echConfigContent = ech::test::getECHConfigContent();
+  SupportedECHConfig supportedConfig{
+      ech::test::getECHConfig(),
+      echConfigContent.key_config.config_id,
+      echConfigContent.maximum_name_length,
+      getCipherSuite()};
+
+  std::vector<ClientHello> chlos;
+  for (size_t i = 0; i < kNumClientHellos; i++) {
+    // Encapsulation generates a fresh client key pair for every ClientHello.
+    auto clientKex = openssl::makeOpenSSLECKeyExchange<P256>();
+    auto setupResult =
+        constructHpkeSetupResult(std::move(clientKex), supportedConfig);
+
+    auto chloInner = TestMessages::clientHello();
+    chloInner.extensions.push_back(encodeExtension(InnerECHClientHello()));
+    auto chloOuter = ech::test::getClientHelloOuter();
+    chloOuter.legacy_session_id = folly::IOBuf::create(0);
+    auto echExt = encryptClientHello(
+        supportedConfig, chloInner, chloOuter, setupResult, folly::none, {});
+    chloOuter.extensions.push_back(encodeExtension(echExt));
+    chlos.push_back(std::move(chloOuter));
+  }
+  return chlos;
+}
+
+std::vector<Buf> makeEncs() {
+  std::vector<Buf> encs;
+  for (const auto& chlo : makeClientHellos()) {
+    auto ext = getExtension<OuterECHClientHello>(chlo.extensions);
+    encs.push_back(std::move(ext->enc));
+  }
+  return encs;
+}
+} // namespace
+
+BENCHMARK(SetupDecryptionContext, iters) {
+  std::vector<Buf> encs;
+  std::unique_ptr<KeyExchange> kex;
+  hpke::KEMId kemId;
+  BENCHMARK_SUSPEND {
+    encs = makeEncs();
+    kex = makeKex();
+    kemId = ech::test::getECHConfigContent().key_config.kem_id;
+  }
+  auto echConfig = ech::test::getECHConfig();
+  for (size_t i = 0; i < iters; i++) {
+    auto context = setupDecryptionContext(
+        kemId,
+        getCipherSuite(),
+        encs[i % encs.size()],
+        kex->clone(),
+        makeHpkeContextInfoParam(echConfig),
+        0);
+    folly::doNotOptimizeAway(context);
+  }
+}
+
+BENCHMARK_RELATIVE(SetupDecryptionContextPrecomputed, iters) {
+  std::vector<Buf> encs;
+  std::unique_ptr<KeyExchange> kex;
+  folly::Optional<DecryptionSetup> setup;
+  BENCHMARK_SUSPEND {
+    encs = makeEncs();
+    kex = makeKex();
+    setup = makeDecryptionSetup(
+        ech::test::getECHConfigContent().key_config.kem_id,
+        getCipherSuite(),
+        makeHpkeContextInfoParam(ech::test::getECHConfig()));
+  }
+  for (size_t i = 0; i < iters; i++) {
+    auto context = setupDecryptionContext(
+        *setup, encs[i % encs.size()], kex->clone(), 0);
+    folly::doNotOptimizeAway(context);
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(DecryptClientHello, iters) {
+  std::vector<ClientHello> chlos;
+  ECHConfigManager decrypter;
+  BENCHMARK_SUSPEND {
+    chlos = makeClientHellos();
+    decrypter.addDecryptionConfig(
+        DecrypterParams{ech::test::getECHConfig(), makeKex()});
+  }
+  for (size_t i = 0; i < iters; i++) {
+    auto result = decrypter.decryptClientHello(chlos[i % chlos.size()]);
+    folly::doNotOptimizeAway(result);
+  }
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -20,12 +20,14 @@ using namespace fizz::test;
 namespace fizz {
 namespace ech {
 namespace test {
-ClientHello getChloOuterWithExt(std::unique_ptr<KeyExchange> kex) {
+ClientHello getChloOuterWithExt(
+    std::unique_ptr<KeyExchange> kex,
+    folly::Optional<uint8_t> configId = folly::none) {
   // Setup ECH extension
   auto echConfigContent = getECHConfigContent();
   auto supportedECHConfig = SupportedECHConfig{
       getECHConfig(),
-      echConfigContent.key_config.config_id,
+      configId.value_or(echConfigContent.key_config.config_id),
       echConfigContent.maximum_name_length,
       HpkeSymmetricCipherSuite{
           hpke::KDFId::Sha256, hpke::AeadId::TLS_AES_128_GCM_SHA256}};
@@ -94,6 +96,18 @@ ClientHello getChloOuterHRRWithExt(
   return chloOuter;
 }
 
+ECHConfig getECHConfigWith(
+    uint8_t configId,
+    std::vector<HpkeSymmetricCipherSuite> cipherSuites) {
+  auto echConfigContent = getECHConfigContent();
+  echConfigContent.key_config.config_id = configId;
+  echConfigContent.key_config.cipher_suites = std::move(cipherSuites);
+  ECHConfig config;
+  config.version = ECHVersion::Draft15;
+  config.ech_config_content = encode(std::move(echConfigContent));
+  return config;
+}
+
 TEST(DecrypterTest, TestDecodeSuccess) {
   auto kex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
   kex->setPrivateKey(getPrivateKey(kP256Key));
@@ -171,6 +185,200 @@ TEST(DecrypterTest, TestDecodeHRRWithContextSuccess) {
       encodeHandshake(gotChloHRR), encodeHandshake(expectedChloInner)));
 }
 
+TEST(DecrypterTest, TestDecodeSuccessMultipleConfigs) {
+  auto kex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
+  kex->setPrivateKey(getPrivateKey(kP256Key));
+  HpkeSymmetricCipherSuite suite{
+      hpke::KDFId::Sha256, hpke::AeadId::TLS_AES_128_GCM_SHA256};
+
+  ECHConfigManager decrypter;
+  decrypter.addDecryptionConfig(
+      DecrypterParams{getECHConfigWith(0x01, {suite}), kex->clone()});
+  decrypter.addDecryptionConfig(
+      DecrypterParams{getECHConfigWith(0x02, {suite}), kex->clone()});
+  decrypter.addDecryptionConfig(DecrypterParams{getECHConfig(), kex->clone()});
+  auto gotChlo =
+      decrypter.decryptClientHello(getChloOuterWithExt(kex->clone()));
+  ASSERT_TRUE(gotChlo.has_value());
+  EXPECT_EQ(gotChlo->configId, 0xFB);
+
+  auto retryConfigs = decrypter.getRetryConfigs();
+  ASSERT_EQ(retryConfigs.size(), 3);
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      retryConfigs[0].ech_config_content,
+      getECHConfigWith(0x01, {suite}).ech_config_content));
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      retryConfigs[2].ech_config_content, getECHConfig().ech_config_content));
+}
+
+TEST(DecrypterTest, TestDecodeConfigIdCollision) {
+  auto kex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
+  kex->setPrivateKey(getPrivateKey(kP256Key));
+
+  // Same config id, but not offering the cipher suite the client used.
+  ECHConfigManager decrypter;
+  decrypter.addDecryptionConfig(DecrypterParams{
+      getECHConfigWith(
+          0xFB,
+          {HpkeSymmetricCipherSuite{
+              hpke::KDFId::Sha256, hpke::AeadId::TLS_AES_256_GCM_SHA384}}),
+      kex->clone()});
+  decrypter.addDecryptionConfig(DecrypterParams{getECHConfig(), kex->clone()});
+  auto gotChlo =
+      decrypter.decryptClientHello(getChloOuterWithExt(kex->clone()));
+  ASSERT_TRUE(gotChlo.has_value());
+  EXPECT_EQ(gotChlo->configId, 0xFB);
+}
+
+TEST(DecrypterTest, TestDecodeCipherSuiteMismatch) {
+  auto kex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
+  kex->setPrivateKey(getPrivateKey(kP256Key));
+
+  ECHConfigManager decrypter;
+  decrypter.addDecryptionConfig(DecrypterParams{
+      getECHConfigWith(
+          0xFB,
+          {HpkeSymmetricCipherSuite{
+              hpke::KDFId::Sha256, hpke::AeadId::TLS_AES_256_GCM_SHA384}}),
+      kex->clone()});
+  auto gotChlo =
+      decrypter.decryptClientHello(getChloOuterWithExt(kex->clone()));
+  EXPECT_FALSE(gotChlo.has_value());
+}
+
+TEST(DecrypterTest, TestStatsAccepted) {
+  auto kex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
+  kex->setPrivateKey(getPrivateKey(kP256Key));
+
+  ECHConfigManager decrypter;
+  decrypter.addDecryptionConfig(DecrypterParams{getECHConfig(), kex->clone()});
+  EXPECT_TRUE(decrypter.decryptClientHello(getChloOuterWithExt(kex->clone()))
+                  .has_value());
+  auto stats = decrypter.getStats();
+  EXPECT_EQ(stats.accepted, 1);
+  EXPECT_EQ(stats.attempts, 1);
+  EXPECT_EQ(stats.grease, 0);
+  EXPECT_EQ(stats.failed, 0);
+}
+
+TEST(DecrypterTest, TestUnknownConfigIdNotAttempted) {
+  auto kex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
+  kex->setPrivateKey(getPrivateKey(kP256Key));
+
+  ECHConfigManager decrypter;
+  decrypter.addDecryptionConfig(DecrypterParams{getECHConfig(), kex->clone()});
+  EXPECT_FALSE(
+      decrypter.decryptClientHello(getChloOuterWithExt(kex->clone(), 0x42))
+          .has_value());
+  auto stats = decrypter.getStats();
+  EXPECT_EQ(stats.grease, 1);
+  EXPECT_EQ(stats.attempts, 0);
+}
+
+TEST(DecrypterTest, TestInvalidEncLengthNotAttempted) {
+  auto kex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
+  kex->setPrivateKey(getPrivateKey(kP256Key));
+
+  ECHConfigManager decrypter;
+  decrypter.addDecryptionConfig(DecrypterParams{getECHConfig(), kex->clone()});
+  auto chloOuter = getChloOuterWithExt(kex->clone());
+  auto it = findExtension(
+      chloOuter.extensions, ExtensionType::encrypted_client_hello);
+  folly::io::Cursor cursor(it->extension_data.get());
+  auto echExt = getExtension<OuterECHClientHello>(cursor);
+  echExt.enc->trimEnd(1);
+  *it = encodeExtension(echExt);
+
+  EXPECT_FALSE(decrypter.decryptClientHello(chloOuter).has_value());
+  auto stats = decrypter.getStats();
+  EXPECT_EQ(stats.grease, 1);
+  EXPECT_EQ(stats.attempts, 0);
+}
+
+TEST(DecrypterTest, TestDecryptionAttemptsCapped) {
+  auto kex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
+  kex->setPrivateKey(getPrivateKey(kP256Key));
+  auto otherKex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
+  otherKex->generateKeyPair();
+
+  // Two configs with the same config_id, the first with the wrong key.
+  ECHConfigManager decrypter;
+  decrypter.addDecryptionConfig(
+      DecrypterParams{getECHConfig(), otherKex->clone()});
+  decrypter.addDecryptionConfig(DecrypterParams{getECHConfig(), kex->clone()});
+  EXPECT_FALSE(decrypter.decryptClientHello(getChloOuterWithExt(kex->clone()))
+                   .has_value());
+  auto stats = decrypter.getStats();
+  EXPECT_EQ(stats.failed, 1);
+  EXPECT_EQ(stats.capped, 1);
+  EXPECT_EQ(stats.attempts, 1);
+
+  ECHConfigManager::Options options;
+  options.maxDecryptionAttempts = 2;
+  ECHConfigManager decrypter2(options);
+  decrypter2.addDecryptionConfig(
+      DecrypterParams{getECHConfig(), otherKex->clone()});
+  decrypter2.addDecryptionConfig(
+      DecrypterParams{getECHConfig(), kex->clone()});
+  EXPECT_TRUE(decrypter2.decryptClientHello(getChloOuterWithExt(kex->clone()))
+                  .has_value());
+  stats = decrypter2.getStats();
+  EXPECT_EQ(stats.accepted, 1);
+  EXPECT_EQ(stats.capped, 0);
+  EXPECT_EQ(stats.attempts, 2);
+}
+
+TEST(DecrypterTest, TestTrialDecryption) {
+  auto kex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
+  kex->setPrivateKey(getPrivateKey(kP256Key));
+
+  ECHConfigManager::Options options;
+  options.trialDecryption = true;
+  ECHConfigManager decrypter(options);
+  decrypter.addDecryptionConfig(DecrypterParams{getECHConfig(), kex->clone()});
+  auto gotChlo =
+      decrypter.decryptClientHello(getChloOuterWithExt(kex->clone(), 0x42));
+  ASSERT_TRUE(gotChlo.has_value());
+  EXPECT_EQ(gotChlo->configId, 0x42);
+  EXPECT_EQ(decrypter.getStats().accepted, 1);
+}
+
+TEST(DecrypterTest, TestDecodeHRRMultipleCandidates) {
+  auto kex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
+  kex->setPrivateKey(getPrivateKey(kP256Key));
+  auto otherKex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
+  otherKex->generateKeyPair();
+
+  ECHConfigManager::Options options;
+  options.maxDecryptionAttempts = 3;
+  options.trialDecryption = true;
+  ECHConfigManager decrypter(options);
+  // Trial decryption adds the config with the other config_id last.
+  decrypter.addDecryptionConfig(
+      DecrypterParams{getECHConfig(), otherKex->clone()});
+  HpkeSymmetricCipherSuite suite{
+      hpke::KDFId::Sha256, hpke::AeadId::TLS_AES_128_GCM_SHA256};
+  decrypter.addDecryptionConfig(
+      DecrypterParams{getECHConfigWith(0x42, {suite}), otherKex->clone()});
+  decrypter.addDecryptionConfig(DecrypterParams{getECHConfig(), kex->clone()});
+  Buf enc;
+  ClientHello initialChlo;
+  auto chloOuter = getChloOuterHRRWithExt(kex->clone(), enc, initialChlo);
+
+  auto gotChlo = decrypter.decryptClientHelloHRR(chloOuter, enc);
+  TestMessages::removeExtension(gotChlo, ExtensionType::encrypted_client_hello);
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      encodeHandshake(gotChlo), encodeHandshake(TestMessages::clientHello())));
+
+  // The right config is past the attempt limit.
+  options.maxDecryptionAttempts = 1;
+  ECHConfigManager capped(options);
+  capped.addDecryptionConfig(
+      DecrypterParams{getECHConfig(), otherKex->clone()});
+  capped.addDecryptionConfig(DecrypterParams{getECHConfig(), kex->clone()});
+  EXPECT_THROW(capped.decryptClientHelloHRR(chloOuter, enc), FizzException);
+}
+
 TEST(DecrypterTest, TestDecodeFailure) {
   auto echConfig = getECHConfig();
   auto kex = openssl::makeOpenSSLECKeyExchange<fizz::P256>();
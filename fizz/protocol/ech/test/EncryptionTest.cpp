@@ -355,6 +355,42 @@ TEST(EncryptionTest, TestTryToDecryptECH) {
   checkDecodedChlo(std::move(chlo), std::move(expectedChlo));
 }
 
+TEST(EncryptionTest, TestTryToDecryptECHWithDecryptionSetup) {
+  auto setup = makeDecryptionSetup(
+      getECHConfigContent().key_config.kem_id,
+      getTestOuterECHClientHello().cipher_suite,
+      makeHpkeContextInfoParam(getECHConfig()));
+
+  // The same setup can be used for any number of ClientHellos.
+  for (int i = 0; i < 2; i++) {
+    auto expectedChlo = TestMessages::clientHello();
+    expectedChlo.legacy_session_id =
+        folly::IOBuf::copyBuffer("test legacy session id");
+
+    auto chloOuter = getClientHelloOuter();
+    auto testECH = getTestOuterECHClientHello();
+    chloOuter.extensions.push_back(encodeExtension(testECH));
+
+    auto kex = std::make_unique<MockOpenSSLECKeyExchange256>();
+    kex->setPrivateKey(getPrivateKey(kP256Key));
+
+    auto context =
+        setupDecryptionContext(setup, testECH.enc, std::move(kex), 0);
+
+    auto chlo = decryptECHWithContext(
+        chloOuter,
+        getECHConfig(),
+        testECH.cipher_suite,
+        std::move(testECH.enc),
+        std::move(testECH.config_id),
+        std::move(testECH.payload),
+        ECHVersion::Draft15,
+        context);
+
+    checkDecodedChlo(std::move(chlo), std::move(expectedChlo));
+  }
+}
+
 TEST(EncryptionTest, TestInnerClientHelloOuterExtensionsSuccess) {
   auto innerChlo = TestMessages::clientHello();
 
@@ -11,6 +11,7 @@
 #include <fizz/backend/openssl/certificate/CertUtils.h>
 #include <fizz/backend/openssl/certificate/OpenSSLPeerCertImpl.h>
 #include <fizz/backend/openssl/certificate/OpenSSLSelfCertImpl.h>
+#include <fizz/backend/openssl/certificate/X509InternCache.h>
 #include <fizz/crypto/test/TestUtil.h>
 #include <folly/String.h>
 
@@ -213,6 +214,48 @@ TEST(CertTest, PeerCertGetX509) {
   EXPECT_NE(x509.get(), nullptr);
 }
 
+TEST(CertTest, X509InternCache) {
+  openssl::X509InternCache cache;
+  auto der = getCertData(kP256Certificate);
+  auto otherDer = getCertData(kRSACertificate);
+
+  // Disabled by default.
+  auto cert1 = cache.parse(der->coalesce());
+  auto cert2 = cache.parse(der->coalesce());
+  EXPECT_NE(cert1.get(), cert2.get());
+  EXPECT_EQ(cache.size(), 0);
+
+  cache.setCapacity(100);
+  cert1 = cache.parse(der->coalesce());
+  cert2 = cache.parse(der->coalesce());
+  EXPECT_EQ(cert1.get(), cert2.get());
+  auto cert3 = cache.parse(otherDer->coalesce());
+  EXPECT_NE(cert1.get(), cert3.get());
+  EXPECT_EQ(cache.size(), 2);
+
+  EXPECT_THROW(
+      cache.parse(IOBuf::copyBuffer("blah")->coalesce()), std::runtime_error);
+  EXPECT_EQ(cache.size(), 2);
+
+  // Handed out references stay valid after the cache drops them.
+  cache.setCapacity(0);
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_NE(X509_get_subject_name(cert1.get()), nullptr);
+  EXPECT_EQ(X509_cmp(cert1.get(), cert2.get()), 0);
+}
+
+TEST(CertTest, MakePeerCertInterned) {
+  auto& cache = openssl::X509InternCache::get();
+  cache.setCapacity(100);
+  auto peerCert1 =
+      openssl::CertUtils::makePeerCert(getCertData(kP256Certificate));
+  auto peerCert2 =
+      openssl::CertUtils::makePeerCert(getCertData(kP256Certificate));
+  EXPECT_EQ(peerCert1->getX509().get(), peerCert2->getX509().get());
+  EXPECT_EQ(peerCert1->getIdentity(), peerCert2->getIdentity());
+  cache.setCapacity(0);
+}
+
 TEST(CertTest, GetIdentityLogic) {
   auto selfCert = openssl::CertUtils::makeSelfCert(
       kCertWithNoCNButWithSANs.str(), kCertWithNoCNButWithSANsKey.str(), "");
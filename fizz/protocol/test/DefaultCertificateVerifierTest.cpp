@@ -9,6 +9,7 @@
 #include <folly/portability/GTest.h>
 
 #include <fizz/protocol/DefaultCertificateVerifier.h>
+#include <fizz/protocol/clock/test/Mocks.h>
 #include <fizz/protocol/test/CertUtil.h>
 #include <folly/ssl/OpenSSLCertUtils.h>
 
@@ -24,6 +25,7 @@ class DefaultCertificateVerifierTest : public testing::Test {
     rootCertAndKey_ = createCert("root", true, nullptr);
     leafCertAndKey_ = createCert("leaf", false, &rootCertAndKey_);
     ASSERT_EQ(X509_STORE_add_cert(store.get(), rootCertAndKey_.cert.get()), 1);
+    store_ = store.get();
     verifier_ = std::make_unique<DefaultCertificateVerifier>(
         VerificationContext::Client, std::move(store));
   }
@@ -38,12 +40,46 @@ class DefaultCertificateVerifierTest : public testing::Test {
     return ok;
   }
 
+  static int countingCallback(int ok, X509_STORE_CTX* /* ctx */) {
+    callbackCount_++;
+    return ok;
+  }
+
+  // The cache is bypassed while a verify callback is set, so cached tests
+  // count verifications through issuer lookups instead.
+  static int
+  countingGetIssuer(X509** issuer, X509_STORE_CTX* ctx, X509* cert) {
+    callbackCount_++;
+    return X509_STORE_CTX_get1_issuer(issuer, ctx, cert);
+  }
+
+  void setUpCache(std::chrono::seconds ttl) {
+    callbackCount_ = 0;
+    clock_ = std::make_shared<testing::NiceMock<MockClock>>();
+    ON_CALL(*clock_, getCurrentTime()).WillByDefault(testing::Invoke([this]() {
+      return now_;
+    }));
+    verifier_->setClock(clock_);
+    X509_STORE_set_get_issuer(
+        store_, &DefaultCertificateVerifierTest::countingGetIssuer);
+    verifier_->setVerifiedChainCache(10, ttl);
+  }
+
+  static size_t callbackCount_;
+
  protected:
   CertAndKey rootCertAndKey_;
   CertAndKey leafCertAndKey_;
   std::unique_ptr<DefaultCertificateVerifier> verifier_;
+  // Owned by verifier_.
+  X509_STORE* store_{nullptr};
+  std::shared_ptr<testing::NiceMock<MockClock>> clock_;
+  std::chrono::system_clock::time_point now_{
+      std::chrono::system_clock::now()};
 };
 
+size_t DefaultCertificateVerifierTest::callbackCount_ = 0;
+
 TEST_F(DefaultCertificateVerifierTest, TestVerifySuccess) {
   verifier_->verify({getPeerCert(leafCertAndKey_)});
 
@@ -118,5 +154,111 @@ TEST_F(DefaultCertificateVerifierTest, TestVerifyWithBadRoot) {
       verifier_->verify({getPeerCert(subleaf), getPeerCert(subauth)}),
       std::runtime_error);
 }
+
+TEST_F(DefaultCertificateVerifierTest, TestVerifyNoCache) {
+  verifier_->setCustomVerifyCallback(
+      &DefaultCertificateVerifierTest::countingCallback);
+  callbackCount_ = 0;
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+  auto count = callbackCount_;
+  EXPECT_GT(count, 0);
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+  EXPECT_EQ(callbackCount_, 2 * count);
+}
+
+TEST_F(DefaultCertificateVerifierTest, TestVerifyCached) {
+  setUpCache(std::chrono::hours(1));
+  auto subauth = createCert("subauth", true, &rootCertAndKey_);
+  auto subleaf = createCert("subleaf", false, &subauth);
+
+  verifier_->verify({getPeerCert(subleaf), getPeerCert(subauth)});
+  auto count = callbackCount_;
+  EXPECT_GT(count, 0);
+  verifier_->verify({getPeerCert(subleaf), getPeerCert(subauth)});
+  EXPECT_EQ(callbackCount_, count);
+
+  // A different chain for the same leaf is verified separately.
+  EXPECT_THROW(verifier_->verify({getPeerCert(subleaf)}), std::runtime_error);
+  EXPECT_GT(callbackCount_, count);
+
+  // verifyWithX509StoreCtx always verifies.
+  count = callbackCount_;
+  auto ctx = verifier_->verifyWithX509StoreCtx(
+      {getPeerCert(subleaf), getPeerCert(subauth)});
+  EXPECT_GT(callbackCount_, count);
+}
+
+TEST_F(DefaultCertificateVerifierTest, TestVerifyCacheFailureNotCached) {
+  setUpCache(std::chrono::hours(1));
+  auto selfsigned = createCert("self", false, nullptr);
+  EXPECT_THROW(
+      verifier_->verify({getPeerCert(selfsigned)}), std::runtime_error);
+  auto count = callbackCount_;
+  EXPECT_THROW(
+      verifier_->verify({getPeerCert(selfsigned)}), std::runtime_error);
+  EXPECT_GT(callbackCount_, count);
+}
+
+TEST_F(DefaultCertificateVerifierTest, TestVerifyCacheTtl) {
+  setUpCache(std::chrono::minutes(5));
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+  auto count = callbackCount_;
+
+  now_ += std::chrono::minutes(4);
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+  EXPECT_EQ(callbackCount_, count);
+
+  now_ += std::chrono::minutes(2);
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+  EXPECT_GT(callbackCount_, count);
+}
+
+TEST_F(DefaultCertificateVerifierTest, TestVerifyCacheCertExpiry) {
+  // createCert issues certificates valid for a year.
+  setUpCache(std::chrono::hours(24 * 400));
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+  auto count = callbackCount_;
+
+  now_ += std::chrono::hours(24 * 300);
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+  EXPECT_EQ(callbackCount_, count);
+
+  now_ += std::chrono::hours(24 * 70);
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+  EXPECT_GT(callbackCount_, count);
+}
+
+TEST_F(DefaultCertificateVerifierTest, TestVerifyCacheStoreChange) {
+  setUpCache(std::chrono::hours(1));
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+
+  // The new store does not trust the root, so a cached result must not be
+  // used.
+  verifier_->setX509Store(folly::ssl::X509StoreUniquePtr(X509_STORE_new()));
+  EXPECT_THROW(
+      verifier_->verify({getPeerCert(leafCertAndKey_)}), std::runtime_error);
+}
+
+TEST_F(DefaultCertificateVerifierTest, TestVerifyCacheBypassedWithCallback) {
+  setUpCache(std::chrono::hours(1));
+  verifier_->setCustomVerifyCallback(
+      &DefaultCertificateVerifierTest::countingCallback);
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+  auto count = callbackCount_;
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+  EXPECT_GT(callbackCount_, count);
+}
+
+TEST_F(DefaultCertificateVerifierTest, TestVerifyCacheBypassedWithCrlCheck) {
+  setUpCache(std::chrono::hours(1));
+  verifier_->verify({getPeerCert(leafCertAndKey_)});
+
+  // Enabling revocation checks must apply to chains verified before, even
+  // without clearing the cache. There is no CRL in the store, so
+  // verification now fails.
+  ASSERT_EQ(X509_STORE_set_flags(store_, X509_V_FLAG_CRL_CHECK), 1);
+  EXPECT_THROW(
+      verifier_->verify({getPeerCert(leafCertAndKey_)}), std::runtime_error);
+}
 } // namespace test
 } // namespace fizz
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/executors/ManualExecutor.h>
+#include <folly/portability/GTest.h>
+
+#include <fizz/protocol/DefaultFactory.h>
+#include <fizz/protocol/KeySharePoolFactory.h>
+
+namespace fizz {
+namespace test {
+
+class KeySharePoolFactoryTest : public testing::Test {
+ public:
+  void SetUp() override {
+    executor_ = std::make_shared<folly::ManualExecutor>();
+    options_.poolSize = 4;
+    options_.lowWaterMark = 2;
+  }
+
+  std::unique_ptr<KeySharePoolFactory> makeFactory() {
+    return std::make_unique<KeySharePoolFactory>(
+        std::make_shared<DefaultFactory>(),
+        executor_,
+        std::vector<NamedGroup>{NamedGroup::x25519, NamedGroup::secp256r1},
+        Factory::KeyExchangeMode::Client,
+        options_);
+  }
+
+ protected:
+  std::shared_ptr<folly::ManualExecutor> executor_;
+  KeySharePoolFactory::Options options_;
+};
+
+TEST_F(KeySharePoolFactoryTest, TestInitialFill) {
+  auto factory = makeFactory();
+  EXPECT_EQ(factory->getAvailable(NamedGroup::x25519), 0);
+  EXPECT_EQ(executor_->run(), 2);
+  EXPECT_EQ(factory->getAvailable(NamedGroup::x25519), 4);
+  EXPECT_EQ(factory->getAvailable(NamedGroup::secp256r1), 4);
+  EXPECT_EQ(factory->getStats().generated, 8);
+}
+
+TEST_F(KeySharePoolFactoryTest, TestPregeneratedKeyKept) {
+  auto factory = makeFactory();
+  executor_->run();
+
+  auto kex = factory->makeKeyExchange(
+      NamedGroup::x25519, Factory::KeyExchangeMode::Client);
+  auto pregenerated = kex->getKeyShare();
+  kex->generateKeyPair();
+  EXPECT_TRUE(folly::IOBufEqualTo()(pregenerated, kex->getKeyShare()));
+
+  // Later calls generate a new key pair.
+  kex->generateKeyPair();
+  EXPECT_FALSE(folly::IOBufEqualTo()(pregenerated, kex->getKeyShare()));
+  EXPECT_EQ(factory->getStats().hits, 1);
+}
+
+TEST_F(KeySharePoolFactoryTest, TestSingleUse) {
+  auto factory = makeFactory();
+  executor_->run();
+
+  std::vector<std::unique_ptr<folly::IOBuf>> shares;
+  for (size_t i = 0; i < options_.poolSize; i++) {
+    auto kex = factory->makeKeyExchange(
+        NamedGroup::secp256r1, Factory::KeyExchangeMode::Client);
+    kex->generateKeyPair();
+    auto share = kex->getKeyShare();
+    for (const auto& previous : shares) {
+      EXPECT_FALSE(folly::IOBufEqualTo()(previous, share));
+    }
+    shares.push_back(std::move(share));
+  }
+  EXPECT_EQ(factory->getAvailable(NamedGroup::secp256r1), 0);
+}
+
+TEST_F(KeySharePoolFactoryTest, TestLowWaterMarkRefill) {
+  auto factory = makeFactory();
+  executor_->run();
+
+  factory->makeKeyExchange(
+      NamedGroup::x25519, Factory::KeyExchangeMode::Client);
+  EXPECT_EQ(factory->getAvailable(NamedGroup::x25519), 3);
+  EXPECT_EQ(executor_->run(), 0);
+
+  factory->makeKeyExchange(
+      NamedGroup::x25519, Factory::KeyExchangeMode::Client);
+  factory->makeKeyExchange(
+      NamedGroup::x25519, Factory::KeyExchangeMode::Client);
+  EXPECT_EQ(factory->getAvailable(NamedGroup::x25519), 1);
+  // Only a single refill is scheduled.
+  EXPECT_EQ(executor_->run(), 1);
+  EXPECT_EQ(factory->getAvailable(NamedGroup::x25519), 4);
+}
+
+TEST_F(KeySharePoolFactoryTest, TestEmptyPoolFallsBack) {
+  auto factory = makeFactory();
+  auto kex = factory->makeKeyExchange(
+      NamedGroup::x25519, Factory::KeyExchangeMode::Client);
+  ASSERT_TRUE(kex);
+  kex->generateKeyPair();
+  EXPECT_TRUE(kex->getKeyShare());
+  auto stats = factory->getStats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.hits, 0);
+}
+
+TEST_F(KeySharePoolFactoryTest, TestUnpooled) {
+  auto factory = makeFactory();
+  executor_->run();
+
+  // Not a pooled group.
+  auto kex = factory->makeKeyExchange(
+      NamedGroup::secp384r1, Factory::KeyExchangeMode::Client);
+  kex->generateKeyPair();
+  EXPECT_TRUE(kex->getKeyShare());
+  // Not the pooled mode.
+  factory->makeKeyExchange(
+      NamedGroup::x25519, Factory::KeyExchangeMode::Server);
+  EXPECT_EQ(factory->getAvailable(NamedGroup::x25519), 4);
+  EXPECT_EQ(factory->getStats().hits, 0);
+}
+} // namespace test
+} // namespace fizz
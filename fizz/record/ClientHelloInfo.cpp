@@ -0,0 +1,224 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/record/ClientHelloInfo.h>
+
+#include <folly/hash/Hash.h>
+
+namespace fizz {
+
+namespace {
+
+/**
+ * Bounds checked reader over a contiguous range. Every method returns false,
+ * without consuming anything, if the data is too short.
+ */
+class Reader {
+ public:
+  explicit Reader(folly::ByteRange data) : data_(data) {}
+
+  bool read(uint8_t& out) {
+    if (data_.size() < 1) {
+      return false;
+    }
+    out = data_[0];
+    data_.advance(1);
+    return true;
+  }
+
+  bool read(uint16_t& out) {
+    if (data_.size() < 2) {
+      return false;
+    }
+    out = static_cast<uint16_t>((data_[0] << 8) | data_[1]);
+    data_.advance(2);
+    return true;
+  }
+
+  template <class LengthType>
+  bool readVector(folly::ByteRange& out) {
+    LengthType length;
+    if (!read(length) || data_.size() < length) {
+      return false;
+    }
+    out = data_.subpiece(0, length);
+    data_.advance(length);
+    return true;
+  }
+
+  bool skip(size_t length) {
+    if (data_.size() < length) {
+      return false;
+    }
+    data_.advance(length);
+    return true;
+  }
+
+  bool empty() const {
+    return data_.empty();
+  }
+
+ private:
+  folly::ByteRange data_;
+};
+
+// RFC 8701 reserves values of the form 0x?a?a with equal bytes.
+bool isGrease(uint16_t value) {
+  return (value & 0x0f0f) == 0x0a0a && (value >> 8) == (value & 0xff);
+}
+
+// Hashes a list of 16 bit values in order, skipping GREASE values. Returns
+// false if the list has an odd length.
+bool hashList(folly::ByteRange list, uint64_t& hash, size_t* count = nullptr) {
+  if (list.size() % 2 != 0) {
+    return false;
+  }
+  Reader reader(list);
+  uint16_t value;
+  while (reader.read(value)) {
+    if (!isGrease(value)) {
+      hash = folly::hash::hash_128_to_64(hash, value);
+      if (count) {
+        (*count)++;
+      }
+    }
+  }
+  return true;
+}
+
+bool parseSni(folly::ByteRange data, ClientHelloInfo& info) {
+  Reader reader(data);
+  folly::ByteRange list;
+  if (!reader.readVector<uint16_t>(list) || !reader.empty()) {
+    return false;
+  }
+  Reader names(list);
+  while (!names.empty()) {
+    uint8_t type;
+    folly::ByteRange name;
+    if (!names.read(type) || !names.readVector<uint16_t>(name)) {
+      return false;
+    }
+    // host_name
+    if (type == 0 && !info.sni) {
+      info.sni = folly::StringPiece(name);
+    }
+  }
+  return true;
+}
+
+bool parseListExtension(folly::ByteRange data, uint64_t& hash) {
+  Reader reader(data);
+  folly::ByteRange list;
+  return reader.readVector<uint16_t>(list) && reader.empty() &&
+      hashList(list, hash);
+}
+} // namespace
+
+bool ClientHelloInfo::offersAlpn(folly::StringPiece protocol) const {
+  if (!alpn) {
+    return false;
+  }
+  Reader reader(*alpn);
+  folly::ByteRange name;
+  while (reader.readVector<uint8_t>(name)) {
+    if (folly::StringPiece(name) == protocol) {
+      return true;
+    }
+  }
+  return false;
+}
+
+folly::Optional<ClientHelloInfo> parseClientHelloInfo(folly::ByteRange data) {
+  constexpr size_t kRandomSize = 32;
+
+  ClientHelloInfo info;
+  Reader reader(data);
+  uint16_t version;
+  folly::ByteRange sessionId;
+  folly::ByteRange cipherSuites;
+  folly::ByteRange compressionMethods;
+  if (!reader.read(version) || !reader.skip(kRandomSize) ||
+      !reader.readVector<uint8_t>(sessionId) ||
+      !reader.readVector<uint16_t>(cipherSuites) ||
+      !reader.readVector<uint8_t>(compressionMethods)) {
+    return folly::none;
+  }
+  info.legacyVersion = static_cast<ProtocolVersion>(version);
+
+  uint64_t cipherHash = 0;
+  if (!hashList(cipherSuites, cipherHash, &info.numCipherSuites)) {
+    return folly::none;
+  }
+
+  // Extension types are summed after mixing so that their order does not
+  // matter. Groups and signature algorithms keep the client's order.
+  uint64_t extensionHash = 0;
+  uint64_t groupHash = 0;
+  uint64_t sigSchemeHash = 0;
+  if (!reader.empty()) {
+    folly::ByteRange extensions;
+    if (!reader.readVector<uint16_t>(extensions) || !reader.empty()) {
+      return folly::none;
+    }
+    Reader extReader(extensions);
+    while (!extReader.empty()) {
+      uint16_t type;
+      folly::ByteRange extData;
+      if (!extReader.read(type) || !extReader.readVector<uint16_t>(extData)) {
+        return folly::none;
+      }
+      if (isGrease(type)) {
+        continue;
+      }
+      info.numExtensions++;
+      extensionHash += folly::hash::twang_mix64(type);
+
+      bool valid = true;
+      switch (static_cast<ExtensionType>(type)) {
+        case ExtensionType::server_name:
+          valid = parseSni(extData, info);
+          break;
+        case ExtensionType::application_layer_protocol_negotiation: {
+          Reader alpnReader(extData);
+          folly::ByteRange list;
+          valid = alpnReader.readVector<uint16_t>(list) && alpnReader.empty();
+          info.alpn = list;
+          break;
+        }
+        case ExtensionType::supported_groups:
+          valid = parseListExtension(extData, groupHash);
+          break;
+        case ExtensionType::signature_algorithms:
+          valid = parseListExtension(extData, sigSchemeHash);
+          break;
+        case ExtensionType::pre_shared_key:
+          info.hasPsk = true;
+          break;
+        case ExtensionType::early_data:
+          info.hasEarlyData = true;
+          break;
+        case ExtensionType::encrypted_client_hello:
+          info.hasEch = true;
+          break;
+        default:
+          break;
+      }
+      if (!valid) {
+        return folly::none;
+      }
+    }
+  }
+
+  auto hash = folly::hash::hash_128_to_64(version, cipherHash);
+  hash = folly::hash::hash_128_to_64(hash, extensionHash);
+  hash = folly::hash::hash_128_to_64(hash, groupHash);
+  info.fingerprint = folly::hash::hash_128_to_64(hash, sigSchemeHash);
+  return info;
+}
+} // namespace fizz
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/record/Types.h>
+#include <folly/Optional.h>
+#include <folly/Range.h>
+
+namespace fizz {
+
+/**
+ * Summary of a ClientHello, read straight from its encoding without decoding
+ * the message. All ranges point into the buffer that was parsed.
+ */
+struct ClientHelloInfo {
+  ProtocolVersion legacyVersion{ProtocolVersion::tls_1_2};
+
+  // First host_name in the server_name extension.
+  folly::Optional<folly::StringPiece> sni;
+
+  // Encoded protocol_name_list of the ALPN extension, without its length.
+  folly::Optional<folly::ByteRange> alpn;
+
+  bool hasPsk{false};
+  bool hasEarlyData{false};
+  bool hasEch{false};
+
+  // Number of cipher suites and extensions, GREASE values excluded.
+  size_t numCipherSuites{0};
+  size_t numExtensions{0};
+
+  // Hash of the version, cipher suites, extension types, supported groups and
+  // signature algorithms. GREASE values are skipped and the extension types
+  // are hashed without regard to their order, so clients that randomize
+  // either keep a stable fingerprint.
+  uint64_t fingerprint{0};
+
+  /**
+   * Returns true if the client offered protocol in the ALPN extension.
+   */
+  bool offersAlpn(folly::StringPiece protocol) const;
+};
+
+/**
+ * Parses the body of a ClientHello handshake message (without the handshake
+ * header). Does not allocate. Returns none if the message is malformed.
+ *
+ * Only the framing of the message and of the extensions listed in
+ * ClientHelloInfo is checked; the full decode remains responsible for
+ * validating the rest.
+ */
+folly::Optional<ClientHelloInfo> parseClientHelloInfo(folly::ByteRange data);
+} // namespace fizz
@@ -39,6 +39,53 @@ inline folly::Optional<T> getExtension(
   return ret;
 }
 
+inline ExtensionIndex::ExtensionIndex(const std::vector<Extension>& extensions)
+    : begin_(extensions.data()), end_(extensions.data() + extensions.size()) {
+  for (const auto& extension : extensions) {
+    auto type = static_cast<size_t>(extension.extension_type);
+    if (type < kMaxIndexedType && !index_[type]) {
+      index_[type] = &extension;
+    }
+  }
+}
+
+inline const Extension* ExtensionIndex::find(ExtensionType type) const {
+  auto indexedType = static_cast<size_t>(type);
+  if (indexedType < kMaxIndexedType) {
+    return index_[indexedType];
+  }
+  for (auto it = begin_; it != end_; ++it) {
+    if (it->extension_type == type) {
+      return it;
+    }
+  }
+  return nullptr;
+}
+
+template <class T>
+inline folly::Optional<T> getExtension(const ExtensionIndex& index) {
+  auto extension = index.find(T::extension_type);
+  if (!extension) {
+    return folly::none;
+  }
+  folly::io::Cursor cs{extension->extension_data.get()};
+  auto ret = getExtension<T>(cs);
+  if (!cs.isAtEnd()) {
+    throw std::runtime_error("didn't read entire extension");
+  }
+  return ret;
+}
+
+template <class... Ts>
+template <class T>
+inline const folly::Optional<T>& CachedExtensions<Ts...>::get() {
+  auto& parsed = std::get<folly::Optional<folly::Optional<T>>>(parsed_);
+  if (!parsed) {
+    parsed.emplace(getExtension<T>(index_));
+  }
+  return *parsed;
+}
+
 template <>
 inline SignatureAlgorithms getExtension(folly::io::Cursor& cs) {
   SignatureAlgorithms sigs;
@@ -166,7 +213,8 @@ template <>
 inline Extension encodeExtension(const SignatureAlgorithms& sig) {
   Extension ext;
   ext.extension_type = ExtensionType::signature_algorithms;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data = folly::IOBuf::create(
+      detail::getVectorSize<uint16_t>(sig.supported_signature_algorithms));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeVector<uint16_t>(sig.supported_signature_algorithms, appender);
   return ext;
@@ -176,7 +224,8 @@ template <>
 inline Extension encodeExtension(const SupportedGroups& groups) {
   Extension ext;
   ext.extension_type = ExtensionType::supported_groups;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data = folly::IOBuf::create(
+      detail::getVectorSize<uint16_t>(groups.named_group_list));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeVector<uint16_t>(groups.named_group_list, appender);
   return ext;
@@ -186,7 +235,8 @@ template <>
 inline Extension encodeExtension(const ClientKeyShare& share) {
   Extension ext;
   ext.extension_type = ExtensionType::key_share;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data = folly::IOBuf::create(
+      detail::getVectorSize<uint16_t>(share.client_shares));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeVector<uint16_t>(share.client_shares, appender);
   return ext;
@@ -196,7 +246,8 @@ template <>
 inline Extension encodeExtension(const ServerKeyShare& share) {
   Extension ext;
   ext.extension_type = ExtensionType::key_share;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data =
+      folly::IOBuf::create(detail::getSize(share.server_share));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::write(share.server_share, appender);
   return ext;
@@ -206,7 +257,8 @@ template <>
 inline Extension encodeExtension(const HelloRetryRequestKeyShare& share) {
   Extension ext;
   ext.extension_type = ExtensionType::key_share;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data =
+      folly::IOBuf::create(detail::getSize(share.selected_group));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::write(share.selected_group, appender);
   return ext;
@@ -216,7 +268,9 @@ template <>
 inline Extension encodeExtension(const ClientPresharedKey& share) {
   Extension ext;
   ext.extension_type = ExtensionType::pre_shared_key;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data = folly::IOBuf::create(
+      detail::getVectorSize<uint16_t>(share.identities) +
+      detail::getVectorSize<uint16_t>(share.binders));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeVector<uint16_t>(share.identities, appender);
   detail::writeVector<uint16_t>(share.binders, appender);
@@ -227,7 +281,8 @@ template <>
 inline Extension encodeExtension(const ServerPresharedKey& share) {
   Extension ext;
   ext.extension_type = ExtensionType::pre_shared_key;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data =
+      folly::IOBuf::create(detail::getSize(share.selected_identity));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::write(share.selected_identity, appender);
   return ext;
@@ -253,7 +308,8 @@ template <>
 inline Extension encodeExtension(const TicketEarlyData& early) {
   Extension ext;
   ext.extension_type = ExtensionType::early_data;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data =
+      folly::IOBuf::create(detail::getSize(early.max_early_data_size));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::write(early.max_early_data_size, appender);
   return ext;
@@ -263,7 +319,8 @@ template <>
 inline Extension encodeExtension(const Cookie& cookie) {
   Extension ext;
   ext.extension_type = ExtensionType::cookie;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data =
+      folly::IOBuf::create(detail::getBufSize<uint16_t>(cookie.cookie));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeBuf<uint16_t>(cookie.cookie, appender);
   return ext;
@@ -273,7 +330,8 @@ template <>
 inline Extension encodeExtension(const SupportedVersions& versions) {
   Extension ext;
   ext.extension_type = ExtensionType::supported_versions;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data =
+      folly::IOBuf::create(detail::getVectorSize<uint8_t>(versions.versions));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeVector<uint8_t>(versions.versions, appender);
   return ext;
@@ -283,7 +341,8 @@ template <>
 inline Extension encodeExtension(const ServerSupportedVersions& versions) {
   Extension ext;
   ext.extension_type = ExtensionType::supported_versions;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data =
+      folly::IOBuf::create(detail::getSize(versions.selected_version));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::write(versions.selected_version, appender);
   return ext;
@@ -293,7 +352,8 @@ template <>
 inline Extension encodeExtension(const PskKeyExchangeModes& modes) {
   Extension ext;
   ext.extension_type = ExtensionType::psk_key_exchange_modes;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data =
+      folly::IOBuf::create(detail::getVectorSize<uint8_t>(modes.modes));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeVector<uint8_t>(modes.modes, appender);
   return ext;
@@ -303,7 +363,8 @@ template <>
 inline Extension encodeExtension(const ProtocolNameList& names) {
   Extension ext;
   ext.extension_type = ExtensionType::application_layer_protocol_negotiation;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data = folly::IOBuf::create(
+      detail::getVectorSize<uint16_t>(names.protocol_name_list));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeVector<uint16_t>(names.protocol_name_list, appender);
   return ext;
@@ -313,7 +374,8 @@ template <>
 inline Extension encodeExtension(const ServerNameList& names) {
   Extension ext;
   ext.extension_type = ExtensionType::server_name;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data = folly::IOBuf::create(
+      detail::getVectorSize<uint16_t>(names.server_name_list));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeVector<uint16_t>(names.server_name_list, appender);
   return ext;
@@ -323,7 +385,8 @@ template <>
 inline Extension encodeExtension(const CertificateAuthorities& authorities) {
   Extension ext;
   ext.extension_type = ExtensionType::certificate_authorities;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data = folly::IOBuf::create(
+      detail::getVectorSize<uint16_t>(authorities.authorities));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeVector<uint16_t>(authorities.authorities, appender);
   return ext;
@@ -333,7 +396,8 @@ template <>
 inline Extension encodeExtension(const CertificateCompressionAlgorithms& cca) {
   Extension ext;
   ext.extension_type = ExtensionType::compress_certificate;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data =
+      folly::IOBuf::create(detail::getVectorSize<uint8_t>(cca.algorithms));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeVector<uint8_t>(cca.algorithms, appender);
   return ext;
@@ -343,7 +407,8 @@ template <>
 inline Extension encodeExtension(const EchOuterExtensions& outerExt) {
   Extension ext;
   ext.extension_type = outerExt.extension_type;
-  ext.extension_data = folly::IOBuf::create(0);
+  ext.extension_data = folly::IOBuf::create(
+      detail::getVectorSize<uint8_t>(outerExt.extensionTypes));
   folly::io::Appender appender(ext.extension_data.get(), 10);
   detail::writeVector<uint8_t>(outerExt.extensionTypes, appender);
   return ext;
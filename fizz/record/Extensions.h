@@ -11,6 +11,9 @@
 #include <fizz/record/Types.h>
 #include <folly/Optional.h>
 
+#include <array>
+#include <tuple>
+
 namespace fizz {
 
 struct SignatureAlgorithms {
@@ -164,6 +167,63 @@ std::vector<Extension>::const_iterator findExtension(
     const std::vector<Extension>& extensions,
     ExtensionType type);
 
+/**
+ * Index over a list of extensions, for messages whose extensions are looked
+ * up repeatedly (such as the ClientHello on the server). Extension types below
+ * kMaxIndexedType, which covers all the standard ones fizz negotiates, are
+ * found without scanning the list. Like findExtension(), the first extension
+ * of a given type is returned.
+ *
+ * The index points at the elements of the vector it was built from, so that
+ * vector must not be modified while the index is in use. Moving it is fine.
+ */
+class ExtensionIndex {
+ public:
+  explicit ExtensionIndex(const std::vector<Extension>& extensions);
+
+  /**
+   * Returns the extension of the given type, or nullptr if there is none.
+   */
+  const Extension* find(ExtensionType type) const;
+
+ private:
+  static constexpr size_t kMaxIndexedType = 64;
+
+  const Extension* begin_;
+  const Extension* end_;
+  std::array<const Extension*, kMaxIndexedType> index_{};
+};
+
+template <class T>
+folly::Optional<T> getExtension(const ExtensionIndex& index);
+
+/**
+ * Decodes each of the extensions Ts at most once, the first time it is asked
+ * for, and keeps the result. The same lifetime rules as for ExtensionIndex
+ * apply to the vector it is built from.
+ */
+template <class... Ts>
+class CachedExtensions {
+ public:
+  explicit CachedExtensions(const std::vector<Extension>& extensions)
+      : index_(extensions) {}
+
+  const ExtensionIndex& index() const {
+    return index_;
+  }
+
+  /**
+   * Returns the decoded extension T, which must be one of Ts. Throws if the
+   * extension is malformed.
+   */
+  template <class T>
+  const folly::Optional<T>& get();
+
+ private:
+  ExtensionIndex index_;
+  std::tuple<folly::Optional<folly::Optional<Ts>>...> parsed_;
+};
+
 size_t getBinderLength(const ClientHello& chlo);
 } // namespace fizz
 
@@ -100,6 +100,45 @@ EncryptionLevel PlaintextReadRecordLayer::getEncryptionLevel() const {
   return EncryptionLevel::Plaintext;
 }
 
+void PlaintextReadRecordLayer::inspectHandshakeData(
+    const folly::IOBufQueue& data) {
+  if (!clientHelloCallback_) {
+    return;
+  }
+  folly::io::Cursor cursor(data.front());
+  if (!cursor.canAdvance(detail::kHandshakeHeaderSize)) {
+    return;
+  }
+  auto type = static_cast<HandshakeType>(cursor.read<uint8_t>());
+  auto length = detail::readBits24(cursor);
+  if (type == HandshakeType::client_hello && !cursor.canAdvance(length)) {
+    return;
+  }
+
+  // Only the first message is inspected. Anything other than a ClientHello is
+  // left for the decode to reject.
+  auto callback = std::move(clientHelloCallback_);
+  clientHelloCallback_ = nullptr;
+  if (type != HandshakeType::client_hello) {
+    return;
+  }
+
+  // The record layer buffers handshake data contiguously, so this only copies
+  // if the message arrived chained.
+  folly::ByteRange body = cursor.peekBytes();
+  Buf coalesced;
+  if (body.size() < length) {
+    cursor.clone(coalesced, length);
+    body = coalesced->coalesce();
+  }
+  auto info = parseClientHelloInfo(body.subpiece(0, length));
+  if (!info) {
+    throw FizzException(
+        "malformed client hello", AlertDescription::decode_error);
+  }
+  callback(*info);
+}
+
 TLSContent PlaintextWriteRecordLayer::write(
     TLSMessage&& msg,
     Aead::AeadOptions /*options*/) const {
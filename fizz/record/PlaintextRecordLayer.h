@@ -8,8 +8,11 @@
 
 #pragma once
 
+#include <fizz/record/ClientHelloInfo.h>
 #include <fizz/record/RecordLayer.h>
 
+#include <functional>
+
 namespace fizz {
 
 class PlaintextReadRecordLayer : public ReadRecordLayer {
@@ -36,8 +39,26 @@ class PlaintextReadRecordLayer : public ReadRecordLayer {
 
   EncryptionLevel getEncryptionLevel() const override;
 
+  using ClientHelloCallback = std::function<void(const ClientHelloInfo&)>;
+
+  /**
+   * Calls callback once the first handshake message has been fully received,
+   * if it is a ClientHello, before the message is decoded. The callback may
+   * throw to fail the read. The info only remains valid during the call.
+   *
+   * A ClientHello that cannot be summarized fails the read with a decode_error
+   * alert.
+   */
+  void setClientHelloCallback(ClientHelloCallback callback) {
+    clientHelloCallback_ = std::move(callback);
+  }
+
+ protected:
+  void inspectHandshakeData(const folly::IOBufQueue& data) override;
+
  private:
   bool skipEncryptedRecords_{false};
+  ClientHelloCallback clientHelloCallback_;
 
   folly::Optional<ProtocolVersion> receivedRecordVersion_;
 };
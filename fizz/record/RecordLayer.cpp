@@ -19,6 +19,7 @@ ReadRecordLayer::ReadResult<Param> ReadRecordLayer::readEvent(
     folly::IOBufQueue& socketBuf,
     Aead::AeadOptions options) {
   if (!unparsedHandshakeData_.empty()) {
+    inspectHandshakeData(unparsedHandshakeData_);
     auto param = decodeHandshakeMessage(unparsedHandshakeData_);
     if (param) {
       VLOG(8) << "Received handshake message "
@@ -80,6 +81,7 @@ ReadRecordLayer::ReadResult<Param> ReadRecordLayer::readEvent(
             message->fragment->length());
         handshakeMessage->append(message->fragment->length());
         unparsedHandshakeData_.append(std::move(handshakeMessage));
+        inspectHandshakeData(unparsedHandshakeData_);
         auto param = decodeHandshakeMessage(unparsedHandshakeData_);
         if (param) {
           VLOG(8) << "Received handshake message "
@@ -132,6 +132,14 @@ class ReadRecordLayer {
 
   static folly::Optional<Param> decodeHandshakeMessage(folly::IOBufQueue& buf);
 
+ protected:
+  /**
+   * Called by readEvent() with the buffered handshake data before each attempt
+   * to decode a message from it, so the data may not hold a complete message
+   * yet. May throw to fail the read.
+   */
+  virtual void inspectHandshakeData(const folly::IOBufQueue& /* data */) {}
+
  private:
   folly::IOBufQueue unparsedHandshakeData_{
       folly::IOBufQueue::cacheChainLength()};
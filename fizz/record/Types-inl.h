@@ -31,12 +31,12 @@ struct Sizer {
 
 template <class N>
 size_t getBufSize(const Buf& buf) {
-  return sizeof(N) + buf->computeChainDataLength();
+  return sizeof(N) + (buf ? buf->computeChainDataLength() : 0);
 }
 
 template <>
 inline size_t getBufSize<bits24>(const Buf& buf) {
-  return bits24::size + buf->computeChainDataLength();
+  return bits24::size + (buf ? buf->computeChainDataLength() : 0);
 }
 
 template <class T>
@@ -44,6 +44,25 @@ size_t getSize(const T& t) {
   return Sizer<T>().template getSize<T>(t);
 }
 
+template <class N, class T>
+size_t getVectorSize(const std::vector<T>& data) {
+  size_t len = std::is_same<N, bits24>::value ? bits24::size : sizeof(N);
+  for (const auto& t : data) {
+    len += getSize<T>(t);
+  }
+  return len;
+}
+
+// Encoded handshake messages leave room in front for the handshake header so
+// that encodeHandshake() can write it in place.
+constexpr size_t kHandshakeHeaderSize = sizeof(HandshakeType) + bits24::size;
+
+inline Buf createHandshakeBody(size_t size) {
+  auto buf = folly::IOBuf::create(kHandshakeHeaderSize + size);
+  buf->advance(kHandshakeHeaderSize);
+  return buf;
+}
+
 template <>
 struct Sizer<Extension> {
   template <class T>
@@ -344,8 +363,13 @@ struct Reader<CertificateEntry> {
 
 template <>
 inline Buf encode<ServerHello>(ServerHello&& shlo) {
-  auto buf = folly::IOBuf::create(
-      sizeof(ProtocolVersion) + sizeof(Random) + sizeof(CipherSuite) + 20);
+  auto size = sizeof(ProtocolVersion) + sizeof(Random) + sizeof(CipherSuite) +
+      detail::getVectorSize<uint16_t>(shlo.extensions);
+  if (shlo.legacy_session_id_echo) {
+    size += detail::getBufSize<uint8_t>(shlo.legacy_session_id_echo) +
+        sizeof(shlo.legacy_compression_method);
+  }
+  auto buf = detail::createHandshakeBody(size);
   folly::io::Appender appender(buf.get(), 20);
   detail::write(shlo.legacy_version, appender);
   detail::write(shlo.random, appender);
@@ -362,8 +386,11 @@ inline Buf encode<ServerHello>(ServerHello&& shlo) {
 
 template <>
 inline Buf encode<HelloRetryRequest>(HelloRetryRequest&& shlo) {
-  auto buf = folly::IOBuf::create(
-      sizeof(ProtocolVersion) + sizeof(Random) + sizeof(CipherSuite) + 20);
+  auto buf = detail::createHandshakeBody(
+      sizeof(ProtocolVersion) + sizeof(Random) +
+      detail::getBufSize<uint8_t>(shlo.legacy_session_id_echo) +
+      sizeof(CipherSuite) + sizeof(shlo.legacy_compression_method) +
+      detail::getVectorSize<uint16_t>(shlo.extensions));
   folly::io::Appender appender(buf.get(), 20);
   detail::write(shlo.legacy_version, appender);
   detail::write(HelloRetryRequest::HrrRandom, appender);
@@ -376,12 +403,13 @@ inline Buf encode<HelloRetryRequest>(HelloRetryRequest&& shlo) {
 
 template <>
 inline Buf encode<EndOfEarlyData>(EndOfEarlyData&&) {
-  return folly::IOBuf::create(0);
+  return detail::createHandshakeBody(0);
 }
 
 template <>
 inline Buf encode<EncryptedExtensions>(EncryptedExtensions&& extensions) {
-  auto buf = folly::IOBuf::create(20);
+  auto buf = detail::createHandshakeBody(
+      detail::getVectorSize<uint16_t>(extensions.extensions));
   folly::io::Appender appender(buf.get(), 20);
   detail::writeVector<uint16_t>(extensions.extensions, appender);
   return buf;
@@ -389,7 +417,9 @@ inline Buf encode<EncryptedExtensions>(EncryptedExtensions&& extensions) {
 
 template <>
 inline Buf encode<CertificateRequest>(CertificateRequest&& cr) {
-  auto buf = folly::IOBuf::create(20);
+  auto buf = detail::createHandshakeBody(
+      detail::getBufSize<uint8_t>(cr.certificate_request_context) +
+      detail::getVectorSize<uint16_t>(cr.extensions));
   folly::io::Appender appender(buf.get(), 20);
   detail::writeBuf<uint8_t>(cr.certificate_request_context, appender);
   detail::writeVector<uint16_t>(cr.extensions, appender);
@@ -398,7 +428,9 @@ inline Buf encode<CertificateRequest>(CertificateRequest&& cr) {
 
 template <>
 inline Buf encode<const CertificateMsg&>(const CertificateMsg& cert) {
-  auto buf = folly::IOBuf::create(20);
+  auto buf = detail::createHandshakeBody(
+      detail::getBufSize<uint8_t>(cert.certificate_request_context) +
+      detail::getVectorSize<detail::bits24>(cert.certificate_list));
   folly::io::Appender appender(buf.get(), 20);
   detail::writeBuf<uint8_t>(cert.certificate_request_context, appender);
   detail::writeVector<detail::bits24>(cert.certificate_list, appender);
@@ -417,7 +449,9 @@ inline Buf encode<CertificateMsg>(CertificateMsg&& cert) {
 
 template <>
 inline Buf encode<CompressedCertificate&>(CompressedCertificate& cc) {
-  auto buf = folly::IOBuf::create(20);
+  auto buf = detail::createHandshakeBody(
+      sizeof(cc.algorithm) + detail::bits24::size +
+      detail::getBufSize<detail::bits24>(cc.compressed_certificate_message));
   folly::io::Appender appender(buf.get(), 20);
   detail::write(cc.algorithm, appender);
   detail::writeBits24(cc.uncompressed_length, appender);
@@ -432,7 +466,9 @@ inline Buf encode<CompressedCertificate>(CompressedCertificate&& cc) {
 
 template <>
 inline Buf encode<CertificateVerify>(CertificateVerify&& certVerify) {
-  auto buf = folly::IOBuf::create(20);
+  auto buf = detail::createHandshakeBody(
+      sizeof(certVerify.algorithm) +
+      detail::getBufSize<uint16_t>(certVerify.signature));
   folly::io::Appender appender(buf.get(), 20);
   detail::write(certVerify.algorithm, appender);
   detail::writeBuf<uint16_t>(certVerify.signature, appender);
@@ -450,9 +486,12 @@ inline Buf encode<Alert>(Alert&& alert) {
 
 template <>
 inline Buf encode<const ClientHello&>(const ClientHello& chlo) {
-  auto buf = folly::IOBuf::create(
-      sizeof(ProtocolVersion) + sizeof(Random) + sizeof(uint8_t) +
-      sizeof(CipherSuite) * chlo.cipher_suites.size() + sizeof(uint8_t) + 20);
+  auto buf = detail::createHandshakeBody(
+      sizeof(ProtocolVersion) + sizeof(Random) +
+      detail::getBufSize<uint8_t>(chlo.legacy_session_id) +
+      detail::getVectorSize<uint16_t>(chlo.cipher_suites) +
+      detail::getVectorSize<uint8_t>(chlo.legacy_compression_methods) +
+      detail::getVectorSize<uint16_t>(chlo.extensions));
   folly::io::Appender appender(buf.get(), 20);
   detail::write(chlo.legacy_version, appender);
   detail::write(chlo.random, appender);
@@ -480,7 +519,13 @@ inline Buf encode<Finished>(Finished&& fin) {
 
 template <>
 inline Buf encode<NewSessionTicket>(NewSessionTicket&& nst) {
-  auto buf = folly::IOBuf::create(20);
+  auto size = sizeof(nst.ticket_lifetime) + sizeof(nst.ticket_age_add) +
+      detail::getBufSize<uint16_t>(nst.ticket) +
+      detail::getVectorSize<uint16_t>(nst.extensions);
+  if (nst.ticket_nonce) {
+    size += detail::getBufSize<uint8_t>(nst.ticket_nonce);
+  }
+  auto buf = detail::createHandshakeBody(size);
   folly::io::Appender appender(buf.get(), 20);
   detail::write(nst.ticket_lifetime, appender);
   detail::write(nst.ticket_age_add, appender);
@@ -507,7 +552,7 @@ inline Buf encodeHkdfLabel(
 
 template <>
 inline Buf encode<KeyUpdate>(KeyUpdate&& keyUpdate) {
-  auto buf = folly::IOBuf::create(20);
+  auto buf = detail::createHandshakeBody(sizeof(keyUpdate.request_update));
   folly::io::Appender appender(buf.get(), 20);
   detail::write(keyUpdate.request_update, appender);
   return buf;
@@ -521,11 +566,21 @@ inline Buf encode<message_hash>(message_hash&& hash) {
 template <class T>
 Buf encodeHandshake(T&& handshakeMsg) {
   auto body = encode(std::forward<T>(handshakeMsg));
-  auto buf = folly::IOBuf::create(sizeof(HandshakeType) + detail::bits24::size);
-  folly::io::Appender appender(buf.get(), 0);
+  std::array<uint8_t, detail::kHandshakeHeaderSize> headerBuf;
+  auto header = folly::IOBuf::wrapBufferAsValue(folly::range(headerBuf));
+  header.clear();
+  folly::io::Appender appender(&header, 0);
   constexpr auto handshakeType = std::remove_reference<T>::type::handshake_type;
   detail::write(handshakeType, appender);
   detail::writeBits24(body->computeChainDataLength(), appender);
+  if (!body->isSharedOne() &&
+      body->headroom() >= detail::kHandshakeHeaderSize) {
+    // Write the header into the room the encoder left for it.
+    body->prepend(detail::kHandshakeHeaderSize);
+    memcpy(body->writableData(), header.data(), header.length());
+    return body;
+  }
+  auto buf = folly::IOBuf::copyBuffer(header.data(), header.length());
   buf->prependChain(std::move(body));
   return buf;
 }
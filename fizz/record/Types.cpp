@@ -279,6 +279,8 @@ std::string toString(CertificateCompressionAlgorithm algo) {
       return "brotli";
     case CertificateCompressionAlgorithm::zstd:
       return "zstd";
+    case CertificateCompressionAlgorithm::zstd_dictionary:
+      return "zstd_dictionary";
   }
   return enumToHex(algo);
 }
@@ -173,6 +173,8 @@ enum class CertificateCompressionAlgorithm : uint16_t {
   zlib = 1,
   brotli = 2,
   zstd = 3,
+  // Private use code point: zstd with a dictionary shared out of band.
+  zstd_dictionary = 0xff00,
 };
 
 std::string toString(CertificateCompressionAlgorithm);
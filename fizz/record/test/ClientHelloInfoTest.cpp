@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+
+#include <fizz/protocol/test/TestUtil.h>
+#include <fizz/record/ClientHelloInfo.h>
+#include <folly/String.h>
+
+#include <algorithm>
+
+using namespace folly;
+
+namespace fizz {
+namespace test {
+
+class ClientHelloInfoTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    chlo_ = TestMessages::clientHello();
+  }
+
+  folly::Optional<ClientHelloInfo> parse() {
+    encoded_ = encode(chlo_);
+    return parseClientHelloInfo(encoded_->coalesce());
+  }
+
+  ClientHello chlo_;
+  Buf encoded_;
+};
+
+TEST_F(ClientHelloInfoTest, TestParse) {
+  auto info = parse();
+  ASSERT_TRUE(info.has_value());
+  EXPECT_EQ(info->legacyVersion, ProtocolVersion::tls_1_2);
+  ASSERT_TRUE(info->sni.has_value());
+  EXPECT_EQ(*info->sni, "www.hostname.com");
+  EXPECT_TRUE(info->offersAlpn("h2"));
+  EXPECT_FALSE(info->offersAlpn("h3"));
+  EXPECT_EQ(info->numCipherSuites, 2);
+  EXPECT_EQ(info->numExtensions, chlo_.extensions.size());
+  EXPECT_FALSE(info->hasPsk);
+  EXPECT_FALSE(info->hasEarlyData);
+  EXPECT_FALSE(info->hasEch);
+}
+
+TEST_F(ClientHelloInfoTest, TestFlags) {
+  TestMessages::addPsk(chlo_);
+  chlo_.extensions.push_back(encodeExtension(ClientEarlyData()));
+  Extension ech;
+  ech.extension_type = ExtensionType::encrypted_client_hello;
+  ech.extension_data = IOBuf::copyBuffer("ech");
+  chlo_.extensions.push_back(std::move(ech));
+  auto info = parse();
+  ASSERT_TRUE(info.has_value());
+  EXPECT_TRUE(info->hasPsk);
+  EXPECT_TRUE(info->hasEarlyData);
+  EXPECT_TRUE(info->hasEch);
+}
+
+TEST_F(ClientHelloInfoTest, TestNoExtensions) {
+  chlo_.extensions.clear();
+  auto info = parse();
+  ASSERT_TRUE(info.has_value());
+  EXPECT_FALSE(info->sni.has_value());
+  EXPECT_FALSE(info->offersAlpn("h2"));
+  EXPECT_EQ(info->numExtensions, 0);
+
+  // TLS 1.2 clients may omit the extensions entirely.
+  encoded_->trimEnd(2);
+  EXPECT_TRUE(parseClientHelloInfo(encoded_->coalesce()).has_value());
+}
+
+TEST_F(ClientHelloInfoTest, TestFingerprintIgnoresExtensionOrder) {
+  auto fingerprint = parse()->fingerprint;
+  std::reverse(chlo_.extensions.begin(), chlo_.extensions.end());
+  EXPECT_EQ(parse()->fingerprint, fingerprint);
+
+  std::reverse(chlo_.cipher_suites.begin(), chlo_.cipher_suites.end());
+  EXPECT_NE(parse()->fingerprint, fingerprint);
+}
+
+TEST_F(ClientHelloInfoTest, TestFingerprintIgnoresGrease) {
+  auto info = parse();
+  chlo_.cipher_suites.insert(
+      chlo_.cipher_suites.begin(), static_cast<CipherSuite>(0x2a2a));
+  Extension grease;
+  grease.extension_type = static_cast<ExtensionType>(0x1a1a);
+  grease.extension_data = IOBuf::create(0);
+  chlo_.extensions.insert(chlo_.extensions.begin(), std::move(grease));
+  auto greased = parse();
+  ASSERT_TRUE(greased.has_value());
+  EXPECT_EQ(greased->fingerprint, info->fingerprint);
+  EXPECT_EQ(greased->numCipherSuites, info->numCipherSuites);
+  EXPECT_EQ(greased->numExtensions, info->numExtensions);
+}
+
+TEST_F(ClientHelloInfoTest, TestFingerprintDiffers) {
+  auto fingerprint = parse()->fingerprint;
+  chlo_.extensions.push_back(encodeExtension(ClientEarlyData()));
+  EXPECT_NE(parse()->fingerprint, fingerprint);
+}
+
+TEST_F(ClientHelloInfoTest, TestTruncated) {
+  parse();
+  auto data = encoded_->coalesce();
+  EXPECT_FALSE(parseClientHelloInfo(data.subpiece(0, data.size() - 1)));
+  EXPECT_FALSE(parseClientHelloInfo(data.subpiece(0, 10)));
+  EXPECT_FALSE(parseClientHelloInfo(ByteRange()));
+}
+
+TEST_F(ClientHelloInfoTest, TestMalformedExtension) {
+  Extension sni;
+  sni.extension_type = ExtensionType::server_name;
+  sni.extension_data = IOBuf::copyBuffer(unhexlify("0003000010"));
+  chlo_.extensions.clear();
+  chlo_.extensions.push_back(std::move(sni));
+  EXPECT_FALSE(parse().has_value());
+}
+} // namespace test
+} // namespace fizz
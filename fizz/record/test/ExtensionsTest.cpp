@@ -132,5 +132,59 @@ TEST_F(ExtensionsTest, TestBadlyFormedExtension) {
   exts.push_back(std::move(ext));
   EXPECT_THROW(getExtension<ServerNameList>(exts), std::runtime_error);
 }
+
+TEST_F(ExtensionsTest, TestExtensionIndex) {
+  auto exts = getExtensions(sni);
+  auto alpnExts = getExtensions(alpn);
+  exts.push_back(std::move(alpnExts.front()));
+  Extension testExt;
+  testExt.extension_type = ExtensionType::test_extension;
+  testExt.extension_data = folly::IOBuf::create(0);
+  exts.push_back(std::move(testExt));
+  Extension duplicate;
+  duplicate.extension_type = ExtensionType::server_name;
+  duplicate.extension_data = folly::IOBuf::create(0);
+  exts.push_back(std::move(duplicate));
+
+  ExtensionIndex index(exts);
+  EXPECT_EQ(index.find(ExtensionType::server_name), &exts[0]);
+  EXPECT_EQ(
+      index.find(ExtensionType::application_layer_protocol_negotiation),
+      &exts[1]);
+  EXPECT_EQ(index.find(ExtensionType::test_extension), &exts[2]);
+  EXPECT_EQ(index.find(ExtensionType::key_share), nullptr);
+  EXPECT_EQ(index.find(ExtensionType::encrypted_client_hello), nullptr);
+
+  auto ext = getExtension<ServerNameList>(index);
+  ASSERT_TRUE(ext.has_value());
+  EXPECT_EQ(
+      StringPiece(ext->server_name_list[0].hostname->coalesce()),
+      StringPiece("www.facebook.com"));
+  EXPECT_FALSE(getExtension<Cookie>(index).has_value());
+}
+
+TEST_F(ExtensionsTest, TestCachedExtensions) {
+  auto exts = getExtensions(sni);
+  CachedExtensions<ServerNameList, ProtocolNameList> cached(exts);
+
+  // Moving the vector leaves its elements in place.
+  auto moved = std::move(exts);
+  const auto& ext = cached.get<ServerNameList>();
+  ASSERT_TRUE(ext.has_value());
+  EXPECT_EQ(ext->server_name_list.size(), 1);
+  EXPECT_EQ(&cached.get<ServerNameList>(), &ext);
+  EXPECT_FALSE(cached.get<ProtocolNameList>().has_value());
+
+  auto buf = getBuf(sni);
+  buf->reserve(0, 1);
+  buf->append(1);
+  std::vector<Extension> badExts;
+  Extension badExt;
+  badExt.extension_type = ExtensionType::server_name;
+  badExt.extension_data = std::move(buf);
+  badExts.push_back(std::move(badExt));
+  CachedExtensions<ServerNameList> badCached(badExts);
+  EXPECT_THROW(badCached.get<ServerNameList>(), std::runtime_error);
+}
 } // namespace test
 } // namespace fizz
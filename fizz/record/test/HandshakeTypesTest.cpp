@@ -262,5 +262,57 @@ TEST_F(HandshakeTypesTest, EncodeAndDecodeCompressedCertificate) {
   auto reencoded = encodeHex(std::move(cc));
   EXPECT_EQ(reencoded, encodedCompressedCertificate);
 }
+
+TEST_F(HandshakeTypesTest, EncodeHandshakeSingleBuffer) {
+  auto clientHello = decodeHex<ClientHello>(chlo);
+  auto encodedChlo = encodeHandshake(std::move(clientHello));
+  EXPECT_FALSE(encodedChlo->isChained());
+  EXPECT_EQ(
+      hexlify(encodedChlo->to<std::string>()),
+      folly::to<std::string>("01000213", chlo));
+
+  auto cert = decodeHex<CertificateMsg>(encodedCertificate);
+  auto encodedCert = encodeHandshake(std::move(cert));
+  EXPECT_FALSE(encodedCert->isChained());
+  EXPECT_EQ(
+      hexlify(encodedCert->to<std::string>()),
+      folly::to<std::string>("0b0001b9", encodedCertificate));
+
+  auto ticket = decodeHex<NewSessionTicket>(nst);
+  auto encodedNst = encodeHandshake(std::move(ticket));
+  EXPECT_FALSE(encodedNst->isChained());
+  EXPECT_EQ(
+      hexlify(encodedNst->to<std::string>()),
+      folly::to<std::string>("040000a7", nst));
+
+  Finished finished;
+  finished.verify_data = IOBuf::copyBuffer("verifydata");
+  auto encodedFinished = encodeHandshake(std::move(finished));
+  std::string finishedHeader("\x14\x00\x00\x0a", 4);
+  EXPECT_EQ(encodedFinished->to<std::string>(), finishedHeader + "verifydata");
+}
+
+TEST_F(HandshakeTypesTest, EncodeLargeMessagesSingleBuffer) {
+  // Large enough that growing the output in small steps would have produced
+  // a chain of buffers.
+  Extension large;
+  large.extension_type = ExtensionType::cookie;
+  large.extension_data = IOBuf::create(4096);
+  large.extension_data->append(4096);
+  memset(large.extension_data->writableData(), 0x42, 4096);
+
+  auto shlo = decodeHex<ServerHello>(encodedShlo);
+  shlo.extensions.push_back(large.clone());
+  auto encodedShloSize = 4 + encodedShlo.size() / 2 + 4 + 4096;
+  auto encoded = encodeHandshake(std::move(shlo));
+  EXPECT_FALSE(encoded->isChained());
+  EXPECT_EQ(encoded->length(), encodedShloSize);
+
+  EncryptedExtensions ee;
+  ee.extensions.push_back(std::move(large));
+  encoded = encodeHandshake(std::move(ee));
+  EXPECT_FALSE(encoded->isChained());
+  EXPECT_EQ(encoded->length(), 4 + 2 + 4 + 4096);
+}
 } // namespace test
 } // namespace fizz
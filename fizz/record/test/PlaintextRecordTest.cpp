@@ -9,6 +9,7 @@
 #include <folly/portability/GMock.h>
 #include <folly/portability/GTest.h>
 
+#include <fizz/protocol/test/TestUtil.h>
 #include <fizz/record/PlaintextRecordLayer.h>
 
 #include <folly/String.h>
@@ -38,6 +39,11 @@ class PlaintextRecordTest : public testing::Test {
     queue_.append(getBuf(hex));
   }
 
+  void addHandshakeRecord(Buf handshake) {
+    TLSMessage msg{ContentType::handshake, std::move(handshake)};
+    queue_.append(write_.write(std::move(msg), Aead::AeadOptions()).data);
+  }
+
   void expectSame(const Buf& buf, const std::string& hex) {
     auto str = buf->to<std::string>();
     EXPECT_EQ(hexlify(str), hex);
@@ -198,5 +204,63 @@ TEST_F(PlaintextRecordTest, TestFragmentedWrite) {
   IOBufEqualTo eq;
   EXPECT_TRUE(eq(write.data, write1.data));
 }
+
+TEST_F(PlaintextRecordTest, TestClientHelloCallback) {
+  size_t calls = 0;
+  read_.setClientHelloCallback([&calls](const ClientHelloInfo& info) {
+    calls++;
+    EXPECT_EQ(info.sni.value_or(""), "www.hostname.com");
+    EXPECT_TRUE(info.offersAlpn("h2"));
+  });
+
+  // Split across records so that the header arrives before the body.
+  auto handshake = encodeHandshake(TestMessages::clientHello());
+  handshake->coalesce();
+  auto rest = handshake->clone();
+  handshake->trimEnd(handshake->length() - 10);
+  rest->trimStart(10);
+  addHandshakeRecord(std::move(handshake));
+  EXPECT_FALSE(read_.readEvent(queue_, Aead::AeadOptions()).has_value());
+  EXPECT_EQ(calls, 0);
+
+  addHandshakeRecord(std::move(rest));
+  auto param = read_.readEvent(queue_, Aead::AeadOptions());
+  ASSERT_TRUE(param.has_value());
+  EXPECT_NE(param->asClientHello(), nullptr);
+  EXPECT_EQ(calls, 1);
+
+  addHandshakeRecord(encodeHandshake(TestMessages::clientHello()));
+  EXPECT_TRUE(read_.readEvent(queue_, Aead::AeadOptions()).has_value());
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(PlaintextRecordTest, TestClientHelloCallbackThrows) {
+  read_.setClientHelloCallback([](const ClientHelloInfo&) {
+    throw std::runtime_error("rejected");
+  });
+  addHandshakeRecord(encodeHandshake(TestMessages::clientHello()));
+  EXPECT_THROW(
+      read_.readEvent(queue_, Aead::AeadOptions()), std::runtime_error);
+}
+
+TEST_F(PlaintextRecordTest, TestClientHelloCallbackOtherMessage) {
+  bool called = false;
+  read_.setClientHelloCallback(
+      [&called](const ClientHelloInfo&) { called = true; });
+  addHandshakeRecord(encodeHandshake(TestMessages::finished()));
+  EXPECT_TRUE(read_.readEvent(queue_, Aead::AeadOptions()).has_value());
+  addHandshakeRecord(encodeHandshake(TestMessages::clientHello()));
+  EXPECT_TRUE(read_.readEvent(queue_, Aead::AeadOptions()).has_value());
+  EXPECT_FALSE(called);
+}
+
+TEST_F(PlaintextRecordTest, TestClientHelloCallbackMalformed) {
+  bool called = false;
+  read_.setClientHelloCallback(
+      [&called](const ClientHelloInfo&) { called = true; });
+  addToQueue("1603010006010000020303");
+  EXPECT_THROW(read_.readEvent(queue_, Aead::AeadOptions()), FizzException);
+  EXPECT_FALSE(called);
+}
 } // namespace test
 } // namespace fizz
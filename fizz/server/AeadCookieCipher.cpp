@@ -84,8 +84,12 @@ inline CookieState decodeCookie(Buf cookie) {
 }
 } // namespace detail
 
-boost::variant<AppToken, StatelessHelloRetryRequest>
-AeadCookieCipher::getTokenOrRetry(Buf clientHello, Buf appToken) const {
+boost::variant<AppToken, StatelessHelloRetryRequest> getTokenOrStatelessRetry(
+    const FizzServerContext& context,
+    Buf clientHello,
+    Buf appToken,
+    folly::FunctionRef<Buf(Buf cookie)> getCookieToken,
+    folly::FunctionRef<Buf(const CookieState& state)> encodeCookie) {
   folly::IOBufQueue queue{folly::IOBufQueue::cacheChainLength()};
   queue.append(std::move(clientHello));
   auto msg = PlaintextReadRecordLayer().readEvent(queue, Aead::AeadOptions());
@@ -101,18 +105,49 @@ AeadCookieCipher::getTokenOrRetry(Buf clientHello, Buf appToken) const {
 
   auto cookie = getExtension<Cookie>(chlo.extensions);
   if (cookie) {
-    auto state = decrypt(std::move(cookie->cookie));
-    if (!state) {
-      throw std::runtime_error("cookie could not be decrypted");
-    }
     AppToken token;
-    token.token = std::move(state->appToken);
+    token.token = getCookieToken(std::move(cookie->cookie));
     return std::move(token);
-  } else {
-    StatelessHelloRetryRequest hrr;
-    hrr.data = getStatelessResponse(chlo, std::move(appToken));
-    return std::move(hrr);
   }
+
+  auto state = getCookieState(
+      *context.getFactory(),
+      context.getSupportedVersions(),
+      context.getSupportedCiphers(),
+      context.getSupportedGroups(),
+      chlo,
+      std::move(appToken));
+
+  auto statelessMessage = getStatelessHelloRetryRequest(
+      state.version, state.cipher, state.group, encodeCookie(state));
+
+  StatelessHelloRetryRequest hrr;
+  hrr.data = PlaintextWriteRecordLayer()
+                 .writeHandshake(std::move(statelessMessage))
+                 .data;
+  return std::move(hrr);
+}
+
+boost::variant<AppToken, StatelessHelloRetryRequest>
+AeadCookieCipher::getTokenOrRetry(Buf clientHello, Buf appToken) const {
+  return getTokenOrStatelessRetry(
+      *context_,
+      std::move(clientHello),
+      std::move(appToken),
+      [this](Buf cookie) {
+        auto state = decrypt(std::move(cookie));
+        if (!state) {
+          throw std::runtime_error("cookie could not be decrypted");
+        }
+        return std::move(state->appToken);
+      },
+      [this](const CookieState& state) {
+        auto cookie = tokenCipher_->encrypt(detail::encodeCookie(state));
+        if (!cookie) {
+          throw std::runtime_error("could not encrypt cookie");
+        }
+        return std::move(*cookie);
+      });
 }
 
 folly::Optional<CookieState> AeadCookieCipher::decrypt(Buf cookie) const {
@@ -123,30 +158,5 @@ folly::Optional<CookieState> AeadCookieCipher::decrypt(Buf cookie) const {
     return folly::none;
   }
 }
-
-Buf AeadCookieCipher::getStatelessResponse(
-    const ClientHello& chlo,
-    Buf appToken) const {
-  auto state = getCookieState(
-      *context_->getFactory(),
-      context_->getSupportedVersions(),
-      context_->getSupportedCiphers(),
-      context_->getSupportedGroups(),
-      chlo,
-      std::move(appToken));
-
-  auto encoded = detail::encodeCookie(state);
-  auto cookie = tokenCipher_->encrypt(std::move(encoded));
-  if (!cookie) {
-    throw std::runtime_error("could not encrypt cookie");
-  }
-
-  auto statelessMessage = getStatelessHelloRetryRequest(
-      state.version, state.cipher, state.group, std::move(*cookie));
-
-  return PlaintextWriteRecordLayer()
-      .writeHandshake(std::move(statelessMessage))
-      .data;
-}
 } // namespace server
 } // namespace fizz
@@ -13,6 +13,7 @@
 #include <fizz/server/CookieCipher.h>
 #include <fizz/server/FizzServerContext.h>
 #include <fizz/server/TokenCipher.h>
+#include <folly/Function.h>
 
 namespace fizz {
 namespace server {
@@ -25,6 +26,22 @@ struct StatelessHelloRetryRequest {
   Buf data;
 };
 
+/**
+ * Shared implementation of getTokenOrRetry() for the cookie ciphers.
+ *
+ * If the ClientHello in clientHello carries a cookie, returns the app token
+ * that getCookieToken() extracts from it. getCookieToken() must throw if the
+ * cookie is not valid. Otherwise negotiates the cookie state using context and
+ * returns a stateless HelloRetryRequest carrying the cookie encodeCookie()
+ * makes from it.
+ */
+boost::variant<AppToken, StatelessHelloRetryRequest> getTokenOrStatelessRetry(
+    const FizzServerContext& context,
+    Buf clientHello,
+    Buf appToken,
+    folly::FunctionRef<Buf(Buf cookie)> getCookieToken,
+    folly::FunctionRef<Buf(const CookieState& state)> encodeCookie);
+
 class AeadCookieCipher : public CookieCipher {
  public:
   explicit AeadCookieCipher(std::unique_ptr<TokenCipher> tokenCipher)
@@ -58,8 +75,6 @@ class AeadCookieCipher : public CookieCipher {
   folly::Optional<CookieState> decrypt(Buf cookie) const override;
 
  private:
-  Buf getStatelessResponse(const ClientHello& chlo, Buf appToken) const;
-
   std::unique_ptr<TokenCipher> tokenCipher_;
 
   const FizzServerContext* context_ = nullptr;
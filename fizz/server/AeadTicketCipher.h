@@ -88,6 +88,17 @@ class TicketCipherImpl : public TicketCipher {
 
   folly::SemiFuture<std::pair<PskType, folly::Optional<ResumptionState>>>
   decrypt(std::unique_ptr<folly::IOBuf> encryptedTicket) const override {
+    return doDecrypt(std::move(encryptedTicket));
+  }
+
+  folly::Optional<std::pair<PskType, folly::Optional<ResumptionState>>>
+  decryptSync(const folly::IOBuf& encryptedTicket) const override {
+    return doDecrypt(encryptedTicket.clone());
+  }
+
+ private:
+  std::pair<PskType, folly::Optional<ResumptionState>> doDecrypt(
+      std::unique_ptr<folly::IOBuf> encryptedTicket) const {
     auto plaintext = tokenCipher_.decrypt(std::move(encryptedTicket));
     if (!plaintext) {
       return std::make_pair(PskType::Rejected, folly::none);
@@ -110,7 +121,6 @@ class TicketCipherImpl : public TicketCipher {
     return std::make_pair(PskType::Resumption, std::move(resState));
   }
 
- private:
   TokenCipherType tokenCipher_;
   TicketPolicy policy_;
 
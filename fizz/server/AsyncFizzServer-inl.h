@@ -309,6 +309,10 @@ void AsyncFizzServerT<SM>::ActionMoveVisitor::operator()(
   if (server_.handshakeCallback_) {
     auto callback = server_.handshakeCallback_;
     server_.handshakeCallback_ = nullptr;
+    if (server_.getState().handshakeTimings()) {
+      callback->fizzHandshakeTimings(
+          &server_, *server_.getState().handshakeTimings());
+    }
     callback->fizzHandshakeSuccess(&server_);
   }
 }
@@ -333,6 +337,10 @@ void AsyncFizzServerT<SM>::ActionMoveVisitor::operator()(
   if (server_.handshakeCallback_) {
     auto callback = server_.handshakeCallback_;
     server_.handshakeCallback_ = nullptr;
+    if (server_.getState().handshakeTimings()) {
+      callback->fizzHandshakeTimings(
+          &server_, *server_.getState().handshakeTimings());
+    }
     callback->fizzHandshakeSuccess(&server_);
   }
 }
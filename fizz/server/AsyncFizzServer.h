@@ -33,6 +33,16 @@ class AsyncFizzServerT : public AsyncFizzBase {
 
     virtual void fizzHandshakeAttemptFallback(
         AttemptVersionFallback fallback) = 0;
+
+    /**
+     * Called right before fizzHandshakeSuccess if handshake timings are
+     * enabled with FizzServerContext::setRecordHandshakeTimings(). When early
+     * data is accepted this happens before the client Finished is received;
+     * the complete timings are available from getState() afterwards.
+     */
+    virtual void fizzHandshakeTimings(
+        AsyncFizzServerT* /* transport */,
+        const HandshakeTimings& /* timings */) noexcept {}
   };
 
   using UniquePtr =
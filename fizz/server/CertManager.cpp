@@ -9,24 +9,40 @@
 #include <fizz/server/CertManager.h>
 
 #include <folly/String.h>
+#include <folly/hash/Hash.h>
+#include <folly/small_vector.h>
+
+#include <algorithm>
 
 using namespace folly;
 
 namespace fizz {
 namespace server {
 
-// Find a matching cert given a key.
+namespace {
+template <typename Certs>
+auto findScheme(Certs& certs, SignatureScheme scheme) {
+  return std::lower_bound(
+      certs.begin(), certs.end(), scheme, [](const auto& entry, auto s) {
+        return entry.first < s;
+      });
+}
+} // namespace
+
+// Find a matching cert given a key. Schemes are tried in the order of
+// supportedSigSchemes, the certs themselves are only sorted for lookup.
 CertManager::CertMatch CertManager::findCert(
-    const std::string& key,
+    StringPiece key,
     const std::vector<SignatureScheme>& supportedSigSchemes,
     const std::vector<SignatureScheme>& peerSigSchemes) const {
   auto it = certs_.find(key);
   if (it == certs_.end()) {
     return none;
   }
+  const auto& certs = it->second;
   for (auto scheme : supportedSigSchemes) {
-    auto cert = it->second.find(scheme);
-    if (cert == it->second.end()) {
+    auto cert = findScheme(certs, scheme);
+    if (cert == certs.end() || cert->first != scheme) {
       continue;
     }
     if (std::find(peerSigSchemes.begin(), peerSigSchemes.end(), scheme) !=
@@ -43,8 +59,11 @@ CertManager::CertMatch CertManager::getCert(
     const std::vector<SignatureScheme>& peerSigSchemes,
     const std::vector<Extension>& /*peerExtensions*/) const {
   if (sni) {
-    auto key = *sni;
-    toLowerAscii(key);
+    // Host names fit in the inline storage, so this normally stays on the
+    // stack.
+    small_vector<char, 256> lowered(sni->begin(), sni->end());
+    toLowerAscii(lowered.data(), lowered.size());
+    StringPiece key(lowered.data(), lowered.size());
 
     auto ret = findCert(key, supportedSigSchemes, peerSigSchemes);
     if (ret) {
@@ -52,9 +71,9 @@ CertManager::CertMatch CertManager::getCert(
       return ret;
     }
 
-    auto dot = key.find_first_of('.');
-    if (dot != std::string::npos) {
-      std::string wildcardKey(key, dot);
+    auto dot = key.find('.');
+    if (dot != StringPiece::npos) {
+      auto wildcardKey = key.subpiece(dot);
       ret = findCert(wildcardKey, supportedSigSchemes, peerSigSchemes);
       if (ret) {
         VLOG(8) << "Found wildcard SNI match for: " << key;
@@ -84,6 +103,19 @@ std::shared_ptr<SelfCert> CertManager::getCert(
   return it->second;
 }
 
+std::shared_ptr<SelfCert> CertManager::getCertByIdentityHash(
+    uint64_t identityHash) const {
+  auto it = identHashMap_.find(identityHash);
+  if (it == identHashMap_.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+uint64_t CertManager::getIdentityHash(StringPiece identity) {
+  return folly::hash::fnv64_buf(identity.data(), identity.size());
+}
+
 std::string CertManager::getKeyFromIdent(const std::string& ident) {
   if (ident.empty()) {
     throw std::runtime_error("empty identity");
@@ -110,12 +142,13 @@ void CertManager::addCertIdentity(
   }
 
   auto sigSchemes = cert->getSigSchemes();
-  auto& schemeMap = certs_[key];
+  auto& schemeCerts = certs_[key];
   for (auto sigScheme : sigSchemes) {
-    if (schemeMap.find(sigScheme) != schemeMap.end()) {
+    auto it = findScheme(schemeCerts, sigScheme);
+    if (it != schemeCerts.end() && it->first == sigScheme) {
       VLOG(8) << "Skipping duplicate certificate for " << key;
     } else {
-      schemeMap[sigScheme] = cert;
+      schemeCerts.emplace(it, sigScheme, cert);
     }
   }
 }
@@ -145,6 +178,17 @@ void CertManager::addCert(std::shared_ptr<SelfCert> cert, bool defaultCert) {
 
   if (identMap_.find(primaryIdent) == identMap_.end()) {
     identMap_[primaryIdent] = cert;
+
+    // A hash collision between two distinct primary identities makes the
+    // hash ambiguous, so neither identity can be resolved through it.
+    auto hash = getIdentityHash(primaryIdent);
+    auto hashIt = identHashMap_.find(hash);
+    if (hashIt == identHashMap_.end()) {
+      identHashMap_[hash] = cert;
+    } else if (hashIt->second) {
+      VLOG(1) << "Identity hash collision for " << primaryIdent;
+      hashIt->second = nullptr;
+    }
   }
 }
 } // namespace server
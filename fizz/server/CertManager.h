@@ -8,10 +8,10 @@
 
 #pragma once
 
-#include <map>
 #include <unordered_map>
 
 #include <fizz/protocol/CertManagerBase.h>
+#include <folly/container/F14Map.h>
 
 namespace fizz {
 namespace server {
@@ -36,13 +36,36 @@ class CertManager : public CertManagerBase {
    */
   virtual std::shared_ptr<SelfCert> getCert(const std::string& identity) const;
 
+  /**
+   * Return a certificate whose primary identity hashes to identityHash (see
+   * getIdentityHash()). Will return nullptr if no matching cert is found, or
+   * if more than one primary identity maps to the same hash.
+   */
+  virtual std::shared_ptr<SelfCert> getCertByIdentityHash(
+      uint64_t identityHash) const;
+
+  /**
+   * Stable, process independent hash of a certificate identity. This can be
+   * persisted (for example in session tickets) in place of the identity.
+   */
+  static uint64_t getIdentityHash(folly::StringPiece identity);
+
   void addCertAndSetDefault(std::shared_ptr<SelfCert> cert);
 
   void addCert(std::shared_ptr<SelfCert> cert);
 
  protected:
+  /**
+   * Certs registered for a single SNI key, kept sorted by SignatureScheme
+   * value so a scheme can be found by binary search. This is not a
+   * preference order: findCert() walks supportedSigSchemes, which holds the
+   * server's preference, and looks each scheme up in this vector.
+   */
+  using SigSchemeCerts =
+      std::vector<std::pair<SignatureScheme, std::shared_ptr<SelfCert>>>;
+
   CertMatch findCert(
-      const std::string& key,
+      folly::StringPiece key,
       const std::vector<SignatureScheme>& supportedSigSchemes,
       const std::vector<SignatureScheme>& peerSigSchemes) const;
 
@@ -54,8 +77,12 @@ class CertManager : public CertManagerBase {
 
   static std::string getKeyFromIdent(const std::string& ident);
 
-  std::unordered_map<std::string, SigSchemeMap> certs_;
+  // Keyed by lowercased identity, with wildcard identities stored as their
+  // suffix (".example.com"). Supports lookup by StringPiece so SNI matching
+  // does not allocate.
+  folly::F14FastMap<std::string, SigSchemeCerts> certs_;
   std::unordered_map<std::string, std::shared_ptr<SelfCert>> identMap_;
+  std::unordered_map<uint64_t, std::shared_ptr<SelfCert>> identHashMap_;
   std::string default_;
 };
 } // namespace server
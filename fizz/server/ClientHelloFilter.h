@@ -0,0 +1,39 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/record/ClientHelloInfo.h>
+
+namespace fizz {
+namespace server {
+
+enum class ClientHelloFilterResult {
+  Accept,
+  Reject,
+};
+
+/**
+ * Screens connections by their ClientHello before the server does any work on
+ * it. The filter is called by the plaintext record layer as soon as the
+ * ClientHello has been received, before the message is decoded and before any
+ * ECH decryption, key exchange or signing. Only the first ClientHello of a
+ * connection is filtered.
+ *
+ * Rejected handshakes fail with a handshake_failure alert. The filter runs on
+ * the connection's thread, which also makes it the place to throttle or
+ * otherwise deprioritize clients it accepts.
+ */
+class ClientHelloFilter {
+ public:
+  virtual ~ClientHelloFilter() = default;
+
+  virtual ClientHelloFilterResult filter(const ClientHelloInfo& info) = 0;
+};
+} // namespace server
+} // namespace fizz
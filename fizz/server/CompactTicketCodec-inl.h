@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+namespace fizz {
+namespace server {
+
+// out-of-line definition of constexpr static data member is redundant in C++17
+// and is deprecated
+#if __cplusplus < 201703L
+template <CertificateStorage Storage>
+constexpr folly::StringPiece CompactTicketCodec<Storage>::Label;
+template <CertificateStorage Storage>
+constexpr uint8_t CompactTicketCodec<Storage>::kFormatVersion;
+template <CertificateStorage Storage>
+constexpr size_t CompactTicketCodec<Storage>::kFixedHeaderLength;
+#endif // __cplusplus < 201703L
+
+template <CertificateStorage Storage>
+Buf CompactTicketCodec<Storage>::encode(ResumptionState resState) {
+  auto secretLength = resState.resumptionSecret
+      ? resState.resumptionSecret->computeChainDataLength()
+      : 0;
+  auto alpnLength = resState.alpn ? resState.alpn->size() : 0;
+  auto appTokenLength =
+      resState.appToken ? resState.appToken->computeChainDataLength() : 0;
+  if (secretLength > std::numeric_limits<uint8_t>::max() ||
+      alpnLength > std::numeric_limits<uint8_t>::max() ||
+      appTokenLength > std::numeric_limits<uint16_t>::max()) {
+    throw std::runtime_error("ticket field too large for compact encoding");
+  }
+
+  uint64_t identityHash = 0;
+  if (resState.serverCert) {
+    identityHash =
+        CertManager::getIdentityHash(resState.serverCert->getIdentity());
+  }
+
+  uint64_t ticketIssueTime = std::chrono::duration_cast<std::chrono::seconds>(
+                                 resState.ticketIssueTime.time_since_epoch())
+                                 .count();
+  uint64_t handshakeTime = std::chrono::duration_cast<std::chrono::seconds>(
+                               resState.handshakeTime.time_since_epoch())
+                               .count();
+
+  auto capacity =
+      kFixedHeaderLength + secretLength + alpnLength + appTokenLength + 1;
+  auto buf = folly::IOBuf::create(capacity);
+  folly::io::Appender appender(buf.get(), capacity);
+
+  fizz::detail::write(kFormatVersion, appender);
+  fizz::detail::write(resState.version, appender);
+  fizz::detail::write(resState.cipher, appender);
+  fizz::detail::write(resState.ticketAgeAdd, appender);
+  fizz::detail::write(ticketIssueTime, appender);
+  fizz::detail::write(handshakeTime, appender);
+  fizz::detail::write(identityHash, appender);
+  fizz::detail::write(static_cast<uint8_t>(secretLength), appender);
+  fizz::detail::write(static_cast<uint8_t>(alpnLength), appender);
+  fizz::detail::write(static_cast<uint16_t>(appTokenLength), appender);
+
+  if (resState.resumptionSecret) {
+    for (auto range : *resState.resumptionSecret) {
+      appender.push(range.data(), range.size());
+    }
+  }
+  if (resState.alpn) {
+    appender.push(
+        reinterpret_cast<const uint8_t*>(resState.alpn->data()), alpnLength);
+  }
+  if (resState.appToken) {
+    for (auto range : *resState.appToken) {
+      appender.push(range.data(), range.size());
+    }
+  }
+  appendClientCertificate(Storage, resState.clientCert, appender);
+  return buf;
+}
+
+template <CertificateStorage Storage>
+ResumptionState CompactTicketCodec<Storage>::decode(
+    Buf encoded,
+    const Factory& factory,
+    const CertManager& certManager) {
+  // Tickets come out of the token cipher as a single buffer, so this is
+  // normally a no-op.
+  encoded->coalesce();
+  folly::io::Cursor cursor(encoded.get());
+
+  if (cursor.read<uint8_t>() != kFormatVersion) {
+    throw std::runtime_error("unsupported compact ticket format");
+  }
+
+  ResumptionState resState;
+  resState.version = static_cast<ProtocolVersion>(cursor.readBE<uint16_t>());
+  resState.cipher = static_cast<CipherSuite>(cursor.readBE<uint16_t>());
+  resState.ticketAgeAdd = cursor.readBE<uint32_t>();
+  resState.ticketIssueTime = std::chrono::time_point<std::chrono::system_clock>(
+      std::chrono::seconds(cursor.readBE<uint64_t>()));
+  resState.handshakeTime = std::chrono::time_point<std::chrono::system_clock>(
+      std::chrono::seconds(cursor.readBE<uint64_t>()));
+  auto identityHash = cursor.readBE<uint64_t>();
+  auto secretLength = cursor.read<uint8_t>();
+  auto alpnLength = cursor.read<uint8_t>();
+  auto appTokenLength = cursor.readBE<uint16_t>();
+
+  cursor.skip(secretLength);
+  if (alpnLength > 0) {
+    resState.alpn = cursor.readFixedString(alpnLength);
+  }
+  resState.appToken = folly::IOBuf::create(appTokenLength);
+  cursor.pull(resState.appToken->writableData(), appTokenLength);
+  resState.appToken->append(appTokenLength);
+
+  resState.clientCert = readClientCertificate(cursor, factory);
+  if (!cursor.isAtEnd()) {
+    throw std::runtime_error("trailing data in compact ticket");
+  }
+
+  if (identityHash != 0) {
+    resState.serverCert = certManager.getCertByIdentityHash(identityHash);
+  }
+
+  // The resumption secret is the only field left in the encoded buffer.
+  encoded->trimStart(kFixedHeaderLength);
+  encoded->trimEnd(encoded->length() - secretLength);
+  resState.resumptionSecret = std::move(encoded);
+  return resState;
+}
+} // namespace server
+} // namespace fizz
@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/server/TicketCodec.h>
+
+#include <limits>
+
+namespace fizz {
+namespace server {
+/**
+ * Ticket codec with a fixed layout header. Unlike TicketCodec, the server
+ * certificate is stored as CertManager::getIdentityHash() of its identity and
+ * resolved through CertManager::getCertByIdentityHash(), and decoding does not
+ * clone the encoded buffer: the resumption secret is a view into it.
+ *
+ * Layout (all integers big endian):
+ *   offset  0: uint8_t  format version (kFormatVersion)
+ *   offset  1: uint16_t protocol version
+ *   offset  3: uint16_t cipher suite
+ *   offset  5: uint32_t ticket age add
+ *   offset  9: uint64_t ticket issue time (seconds since epoch)
+ *   offset 17: uint64_t handshake time (seconds since epoch)
+ *   offset 25: uint64_t server identity hash (0 if no server cert)
+ *   offset 33: uint8_t  resumption secret length
+ *   offset 34: uint8_t  alpn length
+ *   offset 35: uint16_t app token length
+ *   offset 37: resumption secret, alpn, app token, client certificate
+ *
+ * The label differs from TicketCodec's, so the two codecs can be rolled out
+ * side by side behind a DualTicketCipher.
+ */
+template <CertificateStorage Storage>
+struct CompactTicketCodec {
+  static constexpr folly::StringPiece Label{"Fizz Compact Ticket Codec v1"};
+
+  static constexpr uint8_t kFormatVersion = 1;
+  static constexpr size_t kFixedHeaderLength = 37;
+
+  static Buf encode(ResumptionState state);
+
+  static ResumptionState
+  decode(Buf encoded, const Factory& factory, const CertManager& certManager);
+};
+} // namespace server
+} // namespace fizz
+
+#include <fizz/server/CompactTicketCodec-inl.h>
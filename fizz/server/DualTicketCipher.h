@@ -35,10 +35,43 @@ class DualTicketCipher : public TicketCipher {
   folly::SemiFuture<std::pair<PskType, folly::Optional<ResumptionState>>>
   decrypt(std::unique_ptr<folly::IOBuf> encryptedTicket) const override {
     auto bufClone = encryptedTicket->clone();
-    return cipher_->decrypt(std::move(encryptedTicket))
-        .deferValue([this, ticket = std::move(bufClone)](
-                        std::pair<PskType, folly::Optional<ResumptionState>>
-                            res) mutable {
+    return withFallback(
+        cipher_->decrypt(std::move(encryptedTicket)), std::move(bufClone));
+  }
+
+  folly::Optional<std::pair<PskType, folly::Optional<ResumptionState>>>
+  decryptSync(const folly::IOBuf& encryptedTicket) const override {
+    auto res = cipher_->decryptSync(encryptedTicket);
+    if (res && res->first == PskType::Rejected) {
+      // If the fallback cipher is asynchronous this returns none.
+      return fallbackCipher_->decryptSync(encryptedTicket);
+    }
+    return res;
+  }
+
+  SyncOrAsyncResult decryptSyncOrAsync(
+      const folly::IOBuf& encryptedTicket) const override {
+    auto res = cipher_->decryptSyncOrAsync(encryptedTicket);
+    if (res.result && res.result->first == PskType::Rejected) {
+      // Only the fallback cipher is left to try, synchronously or not.
+      return fallbackCipher_->decryptSyncOrAsync(encryptedTicket);
+    }
+    if (res.future) {
+      res.future =
+          withFallback(std::move(*res.future), encryptedTicket.clone());
+    }
+    return res;
+  }
+
+ private:
+  folly::SemiFuture<std::pair<PskType, folly::Optional<ResumptionState>>>
+  withFallback(
+      folly::SemiFuture<std::pair<PskType, folly::Optional<ResumptionState>>>
+          result,
+      std::unique_ptr<folly::IOBuf> ticket) const {
+    return std::move(result).deferValue(
+        [this, ticket = std::move(ticket)](
+            std::pair<PskType, folly::Optional<ResumptionState>> res) mutable {
           if (std::get<0>(res) == PskType::Rejected) {
             return fallbackCipher_->decrypt(std::move(ticket));
           }
@@ -46,7 +79,6 @@ class DualTicketCipher : public TicketCipher {
         });
   }
 
- private:
   std::unique_ptr<TicketCipher> cipher_;
   std::unique_ptr<TicketCipher> fallbackCipher_;
 };
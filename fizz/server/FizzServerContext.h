@@ -14,6 +14,7 @@
 #include <fizz/protocol/ech/Decrypter.h>
 #include <fizz/record/Types.h>
 #include <fizz/server/CertManager.h>
+#include <fizz/server/ClientHelloFilter.h>
 #include <fizz/server/CookieCipher.h>
 #include <fizz/server/Negotiator.h>
 #include <fizz/server/ReplayCache.h>
@@ -294,6 +295,20 @@ class FizzServerContext {
     return sendNewSessionTicket_;
   }
 
+  /**
+   * Number of NewSessionTickets sent automatically after the handshake. Each
+   * ticket has its own resumption secret, so a client that keeps several of
+   * them can resume that many connections in parallel without reusing a
+   * ticket.
+   * Default is 1.
+   */
+  void setNumNewSessionTickets(uint32_t numNewSessionTickets) {
+    numNewSessionTickets_ = numNewSessionTickets;
+  }
+  uint32_t getNumNewSessionTickets() const {
+    return numNewSessionTickets_;
+  }
+
   /**
    * Set supported cert compression algorithms. Note: It is expected that any
    * certificate used has been initialized with compressors corresponding to the
@@ -319,6 +334,19 @@ class FizzServerContext {
     return omitEarlyRecordLayer_;
   }
 
+  /**
+   * Whether to record per phase handshake timings (see HandshakeTimings).
+   * They are reported to AsyncFizzServer::HandshakeCallback before handshake
+   * success.
+   * Default is false.
+   */
+  void setRecordHandshakeTimings(bool enabled) {
+    recordHandshakeTimings_ = enabled;
+  }
+  bool getRecordHandshakeTimings() const {
+    return recordHandshakeTimings_;
+  }
+
   void setClock(std::shared_ptr<Clock> clock) {
     clock_ = clock;
   }
@@ -350,6 +378,17 @@ class FizzServerContext {
     return decrypter_;
   }
 
+  /**
+   * Set a filter that screens every ClientHello before it is processed.
+   */
+  void setClientHelloFilter(std::shared_ptr<ClientHelloFilter> filter) {
+    clientHelloFilter_ = std::move(filter);
+  }
+
+  const std::shared_ptr<ClientHelloFilter>& getClientHelloFilter() const {
+    return clientHelloFilter_;
+  }
+
  private:
   std::shared_ptr<Factory> factory_;
 
@@ -396,12 +435,17 @@ class FizzServerContext {
   bool earlyDataFbOnly_{false};
 
   bool sendNewSessionTicket_{true};
+  uint32_t numNewSessionTickets_{1};
 
   bool omitEarlyRecordLayer_{false};
 
+  bool recordHandshakeTimings_{false};
+
   AlpnMode alpnMode_{AlpnMode::AllowMismatch};
 
   std::shared_ptr<ech::Decrypter> decrypter_;
+
+  std::shared_ptr<ClientHelloFilter> clientHelloFilter_;
 };
 } // namespace server
 } // namespace fizz
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/server/FizzServerContextStore.h>
+
+namespace fizz {
+namespace server {
+
+FizzServerContextStore::FizzServerContextStore(
+    std::shared_ptr<const FizzServerContext> context) {
+  publish(std::move(context));
+}
+
+const std::shared_ptr<const FizzServerContext>& FizzServerContextStore::get()
+    const {
+  auto& local = *local_;
+  auto version = version_.load(std::memory_order_acquire);
+  if (local.version != version) {
+    // Read the version again under the lock, as a publish may have landed
+    // between the load above and taking the lock.
+    auto current = current_.rlock();
+    local.context = *current;
+    local.version = version_.load(std::memory_order_relaxed);
+  }
+  return local.context;
+}
+
+uint64_t FizzServerContextStore::publish(
+    std::shared_ptr<const FizzServerContext> context) {
+  std::lock_guard<std::mutex> guard(writeMutex_);
+  return publishLocked(std::move(context));
+}
+
+uint64_t FizzServerContextStore::update(
+    folly::FunctionRef<std::shared_ptr<const FizzServerContext>(
+        std::shared_ptr<const FizzServerContext>)> updateFn) {
+  std::lock_guard<std::mutex> guard(writeMutex_);
+  auto current = *current_.rlock();
+  return publishLocked(updateFn(std::move(current)));
+}
+
+uint64_t FizzServerContextStore::publishLocked(
+    std::shared_ptr<const FizzServerContext> context) {
+  if (!context) {
+    throw std::runtime_error("cannot publish null server context");
+  }
+  auto current = current_.wlock();
+  auto old = std::exchange(*current, std::move(context));
+  auto version = version_.fetch_add(1, std::memory_order_acq_rel) + 1;
+  current.unlock();
+  // The previous context is released outside of the lock so that readers
+  // refreshing their snapshot are not held up by its destruction.
+  old.reset();
+  return version;
+}
+} // namespace server
+} // namespace fizz
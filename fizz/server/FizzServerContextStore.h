@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/server/FizzServerContext.h>
+#include <folly/Function.h>
+#include <folly/Synchronized.h>
+#include <folly/ThreadLocal.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace fizz {
+namespace server {
+
+/**
+ * Versioned holder for the FizzServerContext used by new connections.
+ *
+ * Published contexts are immutable. Configuration changes (cert rotation,
+ * ticket secret rotation, cipher changes, ...) are made by building a new
+ * context, usually from the current one, and publishing it as a new version.
+ * Handshakes already running keep using the snapshot they started with.
+ *
+ * Each thread caches the snapshot it last saw, so looking up the current
+ * context with get() only performs a version check; the store's lock is only
+ * taken the first time a thread observes a new version. A thread's cached
+ * snapshot is released the next time it calls get() after a publish, or when
+ * the thread exits.
+ *
+ * This does not remove the per-connection reference count: whoever creates a
+ * connection from the snapshot (an AsyncFizzServer, and the server state it
+ * owns) copies the shared_ptr, as with a context managed by hand.
+ */
+class FizzServerContextStore {
+ public:
+  explicit FizzServerContextStore(
+      std::shared_ptr<const FizzServerContext> context);
+
+  /**
+   * Returns the current snapshot. The reference stays valid until the next
+   * call to get() on the same thread; copy it to keep the snapshot alive
+   * longer (for example to hand it to an AsyncFizzServer).
+   */
+  const std::shared_ptr<const FizzServerContext>& get() const;
+
+  /**
+   * Replaces the current context and returns its version.
+   */
+  uint64_t publish(std::shared_ptr<const FizzServerContext> context);
+
+  /**
+   * Calls updateFn with the current context and publishes the context it
+   * returns. Updates are serialized with each other and with publish(), so
+   * no update is lost to a concurrent one.
+   *
+   * updateFn must not modify the current context, which handshakes may be
+   * using. It should build a new context (of the same type, if contexts are
+   * subclasses of FizzServerContext), and replace sub-objects such as the
+   * CertManager or ticket cipher with new instances rather than modify the
+   * shared ones in place.
+   */
+  uint64_t update(folly::FunctionRef<std::shared_ptr<const FizzServerContext>(
+                      std::shared_ptr<const FizzServerContext>)> updateFn);
+
+  uint64_t getVersion() const {
+    return version_.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct LocalSnapshot {
+    uint64_t version{0};
+    std::shared_ptr<const FizzServerContext> context;
+  };
+
+  uint64_t publishLocked(std::shared_ptr<const FizzServerContext> context);
+
+  std::mutex writeMutex_;
+  folly::Synchronized<std::shared_ptr<const FizzServerContext>> current_;
+  std::atomic<uint64_t> version_{0};
+  folly::ThreadLocal<LocalSnapshot> local_;
+};
+} // namespace server
+} // namespace fizz
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/server/HmacCookieCipher.h>
+
+#include <fizz/crypto/Hkdf.h>
+#include <fizz/crypto/Hmac.h>
+#include <fizz/crypto/Utils.h>
+#include <fizz/record/Extensions.h>
+#include <folly/lang/Bits.h>
+
+#include <limits>
+
+namespace fizz {
+namespace server {
+
+namespace {
+
+struct CookieView {
+  uint16_t version;
+  uint16_t cipher;
+  uint16_t group;
+  folly::ByteRange chloHash;
+  folly::ByteRange appToken;
+  // Everything covered by the tag.
+  folly::ByteRange authenticated;
+  folly::ByteRange tag;
+};
+
+constexpr size_t kFixedHeaderLength = 3 * sizeof(uint16_t) + sizeof(uint8_t);
+
+template <class T>
+T readBE(folly::ByteRange& range) {
+  auto value = folly::Endian::big(folly::loadUnaligned<T>(range.data()));
+  range.advance(sizeof(T));
+  return value;
+}
+
+folly::Optional<CookieView> parseCookie(folly::ByteRange cookie) {
+  if (cookie.size() < kFixedHeaderLength + sizeof(uint16_t) +
+          HmacCookieCipher::kTagLength) {
+    return folly::none;
+  }
+  CookieView view;
+  view.authenticated =
+      cookie.subpiece(0, cookie.size() - HmacCookieCipher::kTagLength);
+  view.tag = cookie.subpiece(view.authenticated.size());
+
+  auto remaining = view.authenticated;
+  view.version = readBE<uint16_t>(remaining);
+  view.cipher = readBE<uint16_t>(remaining);
+  view.group = readBE<uint16_t>(remaining);
+  auto chloHashLength = readBE<uint8_t>(remaining);
+  if (remaining.size() < chloHashLength + sizeof(uint16_t)) {
+    return folly::none;
+  }
+  view.chloHash = remaining.subpiece(0, chloHashLength);
+  remaining.advance(chloHashLength);
+  auto appTokenLength = readBE<uint16_t>(remaining);
+  if (remaining.size() != appTokenLength) {
+    return folly::none;
+  }
+  view.appToken = remaining;
+  return view;
+}
+} // namespace
+
+HmacCookieCipher::~HmacCookieCipher() = default;
+
+bool HmacCookieCipher::setCookieSecrets(
+    const std::vector<folly::ByteRange>& cookieSecrets) {
+  for (const auto& cookieSecret : cookieSecrets) {
+    if (cookieSecret.size() < kMinCookieSecretLength) {
+      LOG(ERROR) << "Cookie cipher secret too small - not updating.";
+      return false;
+    }
+  }
+
+  VLOG(4) << "Updating cookie secrets, num=" << cookieSecrets.size();
+  std::vector<MacKey> keys;
+  keys.reserve(cookieSecrets.size());
+  for (const auto& cookieSecret : cookieSecrets) {
+    auto macKey = HkdfImpl(HashType::HashLen, &HasherType::hmac)
+                      .extract(kContextString, cookieSecret);
+
+    // HashLen is smaller than BlockSize, so the key only needs padding.
+    std::array<uint8_t, HashType::BlockSize> pad;
+    MacKey key;
+    pad.fill(HMAC_IPAD);
+    for (size_t i = 0; i < macKey.size(); i++) {
+      pad[i] ^= macKey[i];
+    }
+    key.inner.hash_init();
+    key.inner.hash_update(folly::range(pad));
+
+    pad.fill(HMAC_OPAD);
+    for (size_t i = 0; i < macKey.size(); i++) {
+      pad[i] ^= macKey[i];
+    }
+    key.outer.hash_init();
+    key.outer.hash_update(folly::range(pad));
+
+    CryptoUtils::clean(folly::range(pad));
+    CryptoUtils::clean(folly::range(macKey));
+    keys.push_back(std::move(key));
+  }
+  keys_ = std::move(keys);
+  return true;
+}
+
+void HmacCookieCipher::computeTag(
+    const MacKey& key,
+    folly::ByteRange data,
+    folly::MutableByteRange out) {
+  std::array<uint8_t, HashType::HashLen> innerHash;
+  auto inner = key.inner;
+  inner.hash_update(data);
+  inner.hash_final(folly::range(innerHash));
+
+  auto outer = key.outer;
+  outer.hash_update(folly::range(innerHash));
+  outer.hash_final(out);
+}
+
+bool HmacCookieCipher::validate(folly::ByteRange cookie) const {
+  auto view = parseCookie(cookie);
+  if (!view) {
+    VLOG(6) << "Malformed cookie.";
+    return false;
+  }
+  std::array<uint8_t, kTagLength> tag;
+  for (const auto& key : keys_) {
+    computeTag(key, view->authenticated, folly::range(tag));
+    if (CryptoUtils::equal(folly::range(tag), view->tag)) {
+      return true;
+    }
+  }
+  VLOG(6) << "Failed to authenticate cookie.";
+  return false;
+}
+
+folly::Optional<CookieState> HmacCookieCipher::decrypt(Buf cookie) const {
+  auto range = cookie->coalesce();
+  if (!validate(range)) {
+    return folly::none;
+  }
+  auto view = parseCookie(range);
+
+  CookieState state;
+  state.version = static_cast<ProtocolVersion>(view->version);
+  state.cipher = static_cast<CipherSuite>(view->cipher);
+  if (view->group != 0) {
+    state.group = static_cast<NamedGroup>(view->group);
+  }
+  state.chloHash = folly::IOBuf::copyBuffer(view->chloHash);
+  state.appToken = folly::IOBuf::copyBuffer(view->appToken);
+  return state;
+}
+
+Buf HmacCookieCipher::encode(const CookieState& state) const {
+  if (keys_.empty()) {
+    throw std::runtime_error("no cookie secrets");
+  }
+  if (state.echCipherSuite) {
+    throw std::runtime_error("cookie with ech state needs encryption");
+  }
+
+  auto chloHash = state.chloHash->coalesce();
+  if (chloHash.size() > std::numeric_limits<uint8_t>::max()) {
+    throw std::runtime_error("chlo hash too large for cookie");
+  }
+  folly::ByteRange appToken;
+  if (state.appToken) {
+    appToken = state.appToken->coalesce();
+  }
+  if (appToken.size() > std::numeric_limits<uint16_t>::max()) {
+    throw std::runtime_error("app token too large for cookie");
+  }
+
+  auto length = kFixedHeaderLength + chloHash.size() + sizeof(uint16_t) +
+      appToken.size() + kTagLength;
+  auto cookie = folly::IOBuf::create(length);
+  folly::io::Appender appender(cookie.get(), 0);
+  appender.writeBE(static_cast<uint16_t>(state.version));
+  appender.writeBE(static_cast<uint16_t>(state.cipher));
+  appender.writeBE(
+      state.group ? static_cast<uint16_t>(*state.group) : uint16_t(0));
+  appender.writeBE(static_cast<uint8_t>(chloHash.size()));
+  appender.push(chloHash);
+  appender.writeBE(static_cast<uint16_t>(appToken.size()));
+  appender.push(appToken);
+
+  auto authenticated = cookie->coalesce();
+  std::array<uint8_t, kTagLength> tag;
+  computeTag(keys_.front(), authenticated, folly::range(tag));
+  appender.push(folly::range(tag));
+  return cookie;
+}
+
+boost::variant<AppToken, StatelessHelloRetryRequest>
+HmacCookieCipher::getTokenOrRetry(Buf clientHello, Buf appToken) const {
+  return getTokenOrStatelessRetry(
+      *context_,
+      std::move(clientHello),
+      std::move(appToken),
+      [this](Buf cookie) {
+        auto range = cookie->coalesce();
+        if (!validate(range)) {
+          throw std::runtime_error("cookie could not be validated");
+        }
+        return folly::IOBuf::copyBuffer(parseCookie(range)->appToken);
+      },
+      [this](const CookieState& state) { return encode(state); });
+}
+} // namespace server
+} // namespace fizz
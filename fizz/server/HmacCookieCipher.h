@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/backend/openssl/Hasher.h>
+#include <fizz/server/AeadCookieCipher.h>
+
+namespace fizz {
+namespace server {
+
+/**
+ * Cookie cipher for servers issuing a large number of stateless hello retry
+ * requests, e.g. while under a handshake flood.
+ *
+ * Unlike AeadCookieCipher the cookie is not encrypted, it is only
+ * authenticated with HMAC-SHA256. The cookie contents (negotiated version,
+ * cipher, group, ClientHello hash, and app token) are visible to the client.
+ * The ClientHello hash only covers a message the client itself sent, but the
+ * app token must not contain anything the client shouldn't see. Cookies
+ * carrying ECH state are never issued or accepted, since the hash of an inner
+ * ClientHello must stay confidential; use AeadCookieCipher with ECH.
+ *
+ * The MAC keys are derived once, when the secrets are set. Checking a cookie
+ * does no key derivation and reads the cookie in place.
+ *
+ * Cookie structure (all integers big endian):
+ *   uint16_t protocol version
+ *   uint16_t cipher suite
+ *   uint16_t group (0 if no group was selected)
+ *   uint8_t  ClientHello hash length
+ *   ClientHello hash
+ *   uint16_t app token length
+ *   app token
+ *   32 bytes HMAC(mac key, all of the above)
+ *
+ * mac key = HKDF-Extract(kContextString, cookie secret)
+ */
+class HmacCookieCipher : public CookieCipher {
+ public:
+  static constexpr size_t kMinCookieSecretLength = 32;
+  static constexpr folly::StringPiece kContextString{
+      "Fizz HMAC Cookie Cipher v1"};
+
+  using HashType = Sha256;
+  static constexpr size_t kTagLength = HashType::HashLen;
+
+  HmacCookieCipher() = default;
+
+  ~HmacCookieCipher() override;
+
+  /**
+   * Set cookie secrets to use for cookie authentication. The first one is
+   * used for new cookies. All secrets must be at least kMinCookieSecretLength
+   * long.
+   */
+  bool setCookieSecrets(const std::vector<folly::ByteRange>& cookieSecrets);
+
+  /**
+   * Set the Fizz context to use when negotiating the parameters for a stateless
+   * hello retry request.
+   */
+  void setContext(const FizzServerContext* context) {
+    context_ = context;
+  }
+
+  /**
+   * Returns either a stateless hello retry request, or a verified token
+   * contained in the client hello.
+   */
+  boost::variant<AppToken, StatelessHelloRetryRequest> getTokenOrRetry(
+      Buf clientHello,
+      Buf appToken) const;
+
+  /**
+   * Returns true if cookie is well formed and authenticated by one of the
+   * secrets. Does not allocate any buffers.
+   */
+  bool validate(folly::ByteRange cookie) const;
+
+  folly::Optional<CookieState> decrypt(Buf cookie) const override;
+
+  Buf encode(const CookieState& state) const;
+
+ private:
+  using HasherType = openssl::Hasher<HashType>;
+
+  // HMAC state after absorbing the padded key, so computing a tag only needs
+  // to hash the message.
+  struct MacKey {
+    HasherType inner;
+    HasherType outer;
+  };
+
+  static void computeTag(
+      const MacKey& key,
+      folly::ByteRange data,
+      folly::MutableByteRange out);
+
+  // First key is the one used for new cookies.
+  std::vector<MacKey> keys_;
+
+  const FizzServerContext* context_ = nullptr;
+};
+} // namespace server
+} // namespace fizz
@@ -0,0 +1,188 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/server/OffloadAsyncSelfCert.h>
+
+#include <folly/Synchronized.h>
+
+#include <atomic>
+#include <deque>
+
+namespace fizz {
+namespace server {
+
+struct OffloadAsyncSelfCert::Queue
+    : public std::enable_shared_from_this<OffloadAsyncSelfCert::Queue> {
+  struct Job {
+    SignatureScheme scheme;
+    CertificateVerifyContext context;
+    Buf toBeSigned;
+    folly::Promise<folly::Optional<Buf>> promise;
+    std::chrono::steady_clock::time_point enqueueTime;
+  };
+
+  Queue(
+      std::shared_ptr<const SelfCert> signerIn,
+      std::shared_ptr<folly::Executor> executorIn,
+      Options optionsIn)
+      : signer(std::move(signerIn)),
+        executor(std::move(executorIn)),
+        options(std::move(optionsIn)) {
+    if (options.maxSignaturesPerTask == 0) {
+      options.maxSignaturesPerTask = 1;
+    }
+  }
+
+  void add(Job job) {
+    bool schedule;
+    {
+      auto lockedJobs = jobs.wlock();
+      lockedJobs->push_back(std::move(job));
+      // Keep at least one scheduled drain per maxSignaturesPerTask queued
+      // jobs.
+      schedule = (lockedJobs->size() - 1) % options.maxSignaturesPerTask == 0;
+    }
+    if (!schedule) {
+      return;
+    }
+    try {
+      executor->add([self = shared_from_this()]() { self->drain(); });
+    } catch (const std::exception& ex) {
+      VLOG(2) << "Failed to schedule signing, signing inline: " << ex.what();
+      drain();
+    }
+  }
+
+  void drain() {
+    std::vector<Job> toRun;
+    {
+      auto lockedJobs = jobs.wlock();
+      auto count =
+          std::min(lockedJobs->size(), options.maxSignaturesPerTask);
+      toRun.reserve(count);
+      for (size_t i = 0; i < count; i++) {
+        toRun.push_back(std::move(lockedJobs->front()));
+        lockedJobs->pop_front();
+      }
+    }
+    for (auto& job : toRun) {
+      run(job);
+    }
+  }
+
+  void run(Job& job) {
+    auto start = std::chrono::steady_clock::now();
+    try {
+      auto sig =
+          signer->sign(job.scheme, job.context, job.toBeSigned->coalesce());
+      job.promise.setValue(std::move(sig));
+    } catch (const std::exception& ex) {
+      failed.fetch_add(1, std::memory_order_relaxed);
+      job.promise.setException(folly::exception_wrapper(
+          std::current_exception(), ex));
+    }
+    auto end = std::chrono::steady_clock::now();
+    pending.fetch_sub(1, std::memory_order_acq_rel);
+
+    auto queueTime = start - job.enqueueTime;
+    auto signTime = end - start;
+    totalQueueTimeNs.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(queueTime)
+            .count(),
+        std::memory_order_relaxed);
+    totalSignTimeNs.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(signTime)
+            .count(),
+        std::memory_order_relaxed);
+    if (options.latencyCallback) {
+      options.latencyCallback(queueTime, signTime);
+    }
+  }
+
+  std::shared_ptr<const SelfCert> signer;
+  std::shared_ptr<folly::Executor> executor;
+  Options options;
+
+  folly::Synchronized<std::deque<Job>> jobs;
+
+  std::atomic<size_t> pending{0};
+  std::atomic<uint64_t> offloaded{0};
+  std::atomic<uint64_t> signedInline{0};
+  std::atomic<uint64_t> rejected{0};
+  std::atomic<uint64_t> failed{0};
+  std::atomic<uint64_t> totalQueueTimeNs{0};
+  std::atomic<uint64_t> totalSignTimeNs{0};
+};
+
+OffloadAsyncSelfCert::OffloadAsyncSelfCert(
+    std::shared_ptr<const SelfCert> signer,
+    std::shared_ptr<folly::Executor> executor)
+    : OffloadAsyncSelfCert(std::move(signer), std::move(executor), Options()) {}
+
+OffloadAsyncSelfCert::OffloadAsyncSelfCert(
+    std::shared_ptr<const SelfCert> signer,
+    std::shared_ptr<folly::Executor> executor,
+    Options options)
+    : signer_(std::move(signer)),
+      queue_(std::make_shared<Queue>(
+          signer_,
+          std::move(executor),
+          std::move(options))) {}
+
+OffloadAsyncSelfCert::~OffloadAsyncSelfCert() = default;
+
+folly::SemiFuture<folly::Optional<Buf>> OffloadAsyncSelfCert::signFuture(
+    SignatureScheme scheme,
+    CertificateVerifyContext context,
+    std::unique_ptr<folly::IOBuf> toBeSigned) const {
+  auto& queue = *queue_;
+  auto maxPending = queue.options.maxPendingSignatures;
+  auto pending = queue.pending.fetch_add(1, std::memory_order_acq_rel);
+  if (maxPending != 0 && pending >= maxPending) {
+    queue.pending.fetch_sub(1, std::memory_order_acq_rel);
+    if (!queue.options.signInlineWhenFull) {
+      queue.rejected.fetch_add(1, std::memory_order_relaxed);
+      return folly::makeSemiFuture<folly::Optional<Buf>>(
+          folly::make_exception_wrapper<FizzException>(
+              "signing queue full", AlertDescription::internal_error));
+    }
+    queue.signedInline.fetch_add(1, std::memory_order_relaxed);
+    return folly::makeSemiFutureWith([&]() {
+      return signer_->sign(scheme, context, toBeSigned->coalesce());
+    });
+  }
+
+  queue.offloaded.fetch_add(1, std::memory_order_relaxed);
+  Queue::Job job;
+  job.scheme = scheme;
+  job.context = context;
+  job.toBeSigned = std::move(toBeSigned);
+  job.enqueueTime = std::chrono::steady_clock::now();
+  auto future = job.promise.getSemiFuture();
+  queue.add(std::move(job));
+  return future;
+}
+
+size_t OffloadAsyncSelfCert::getPendingSignatures() const {
+  return queue_->pending.load(std::memory_order_acquire);
+}
+
+OffloadAsyncSelfCert::Stats OffloadAsyncSelfCert::getStats() const {
+  Stats stats;
+  stats.offloaded = queue_->offloaded.load(std::memory_order_relaxed);
+  stats.signedInline = queue_->signedInline.load(std::memory_order_relaxed);
+  stats.rejected = queue_->rejected.load(std::memory_order_relaxed);
+  stats.failed = queue_->failed.load(std::memory_order_relaxed);
+  stats.totalQueueTime = std::chrono::nanoseconds(
+      queue_->totalQueueTimeNs.load(std::memory_order_relaxed));
+  stats.totalSignTime = std::chrono::nanoseconds(
+      queue_->totalSignTimeNs.load(std::memory_order_relaxed));
+  return stats;
+}
+} // namespace server
+} // namespace fizz
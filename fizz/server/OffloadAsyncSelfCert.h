@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/server/AsyncSelfCert.h>
+#include <folly/Executor.h>
+#include <folly/Function.h>
+
+#include <chrono>
+
+namespace fizz {
+namespace server {
+
+/**
+ * A decorator for an existing SelfCert that moves signing off the calling
+ * (IO) thread onto an executor, typically a dedicated CPUThreadPoolExecutor.
+ *
+ * The number of signatures queued or running on the executor can be bounded.
+ * Once the bound is reached new signatures are either computed inline or
+ * fail the handshake, depending on Options::signInlineWhenFull.
+ */
+class OffloadAsyncSelfCert : public AsyncSelfCert {
+ public:
+  struct Options {
+    /**
+     * Maximum number of signatures queued or running on the executor for
+     * this certificate. Zero means unbounded.
+     */
+    size_t maxPendingSignatures{0};
+
+    /**
+     * Whether to sign on the calling thread when the executor queue is full.
+     * If false, the signature fails with an internal_error alert instead.
+     */
+    bool signInlineWhenFull{true};
+
+    /**
+     * Maximum number of queued signatures run one after another by a single
+     * executor task. Values above 1 let a burst of handshakes using this key
+     * share executor hops. Each signature is still computed separately; no
+     * signatures are combined.
+     */
+    size_t maxSignaturesPerTask{1};
+
+    /**
+     * Called after every offloaded signature with the time spent waiting in
+     * the queue and the time spent signing. Runs on the executor thread and
+     * must be thread safe.
+     */
+    folly::Function<void(std::chrono::nanoseconds, std::chrono::nanoseconds)
+                        const>
+        latencyCallback;
+  };
+
+  struct Stats {
+    uint64_t offloaded{0};
+    // Signatures computed on the calling thread because the queue was full.
+    uint64_t signedInline{0};
+    // Signatures failed because the queue was full.
+    uint64_t rejected{0};
+    uint64_t failed{0};
+    std::chrono::nanoseconds totalQueueTime{0};
+    std::chrono::nanoseconds totalSignTime{0};
+  };
+
+  OffloadAsyncSelfCert(
+      std::shared_ptr<const SelfCert> signer,
+      std::shared_ptr<folly::Executor> executor);
+
+  OffloadAsyncSelfCert(
+      std::shared_ptr<const SelfCert> signer,
+      std::shared_ptr<folly::Executor> executor,
+      Options options);
+
+  ~OffloadAsyncSelfCert() override;
+
+  std::string getIdentity() const override {
+    return signer_->getIdentity();
+  }
+
+  std::vector<std::string> getAltIdentities() const override {
+    return signer_->getAltIdentities();
+  }
+
+  std::vector<SignatureScheme> getSigSchemes() const override {
+    return signer_->getSigSchemes();
+  }
+
+  CertificateMsg getCertMessage(
+      Buf certificateRequestContext = nullptr) const override {
+    return signer_->getCertMessage(std::move(certificateRequestContext));
+  }
+
+  CompressedCertificate getCompressedCert(
+      CertificateCompressionAlgorithm algo) const override {
+    return signer_->getCompressedCert(algo);
+  }
+
+  folly::ssl::X509UniquePtr getX509() const override {
+    return signer_->getX509();
+  }
+
+  Buf sign(
+      SignatureScheme scheme,
+      CertificateVerifyContext context,
+      folly::ByteRange toBeSigned) const override {
+    return signer_->sign(scheme, context, toBeSigned);
+  }
+
+  folly::SemiFuture<folly::Optional<Buf>> signFuture(
+      SignatureScheme scheme,
+      CertificateVerifyContext context,
+      std::unique_ptr<folly::IOBuf> toBeSigned) const override;
+
+  /**
+   * Number of signatures currently queued or running on the executor.
+   */
+  size_t getPendingSignatures() const;
+
+  Stats getStats() const;
+
+  std::shared_ptr<const SelfCert> getSigner() const {
+    return signer_;
+  }
+
+ private:
+  struct Queue;
+
+  std::shared_ptr<const SelfCert> signer_;
+  std::shared_ptr<Queue> queue_;
+};
+} // namespace server
+} // namespace fizz
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <folly/Optional.h>
 #include <folly/Range.h>
 #include <folly/futures/Future.h>
 #include <folly/io/IOBuf.h>
@@ -37,6 +38,18 @@ class ReplayCache {
 
   virtual folly::SemiFuture<ReplayCacheResult> check(
       std::unique_ptr<folly::IOBuf> identifier) = 0;
+
+  /**
+   * Same as check(), for caches that can answer without waiting. This lets
+   * the server accept early data without allocating any futures.
+   *
+   * Returns none if the result is only available asynchronously, in which
+   * case check() is used instead.
+   */
+  virtual folly::Optional<ReplayCacheResult> checkSync(
+      folly::ByteRange /* identifier */) {
+    return folly::none;
+  }
 };
 
 /**
@@ -50,6 +63,10 @@ class AllowAllReplayReplayCache : public ReplayCache {
       std::unique_ptr<folly::IOBuf>) override {
     return ReplayCacheResult::NotReplay;
   }
+
+  folly::Optional<ReplayCacheResult> checkSync(folly::ByteRange) override {
+    return ReplayCacheResult::NotReplay;
+  }
 };
 } // namespace server
 } // namespace fizz
@@ -164,6 +164,10 @@ AsyncActions ServerStateMachine::processSocketData(
           ReportError("attempting to process data without record layer"),
           folly::none);
     }
+    if (state.handshakeTimings() && !state.handshakeTimings()->start &&
+        state.state() == StateEnum::ExpectingClientHello) {
+      state.handshakeTimings()->start = HandshakeTimings::Clock::now();
+    }
     auto readResult =
         state.readRecordLayer()->readEvent(buf, std::move(options));
     if (!readResult.has_value()) {
@@ -376,6 +380,67 @@ runOnCallerIfComplete(
   }
 }
 
+// A result that is either available immediately or still pending. Components
+// that can answer synchronously produce a value, which lets the caller skip
+// allocating and collecting futures.
+template <typename T>
+struct ReadyOrFuture {
+  /* implicit */ ReadyOrFuture(T valueArg) : value(std::move(valueArg)) {}
+  /* implicit */ ReadyOrFuture(SemiFuture<T> futureArg)
+      : future(std::move(futureArg)) {}
+
+  bool isReady() const {
+    return value.has_value();
+  }
+
+  SemiFuture<T> toSemiFuture() && {
+    if (value) {
+      return SemiFuture<T>(std::move(*value));
+    }
+    return std::move(*future);
+  }
+
+  Optional<T> value;
+  Optional<SemiFuture<T>> future;
+};
+
+static SemiFuture<Actions> toSemiFuture(AsyncActions asyncActions) {
+  return folly::variant_match(
+      asyncActions,
+      ::fizz::detail::result_type<SemiFuture<Actions>>(),
+      [](SemiFuture<Actions>& futureActions) {
+        return std::move(futureActions);
+      },
+      [](Actions& immediateActions) {
+        return SemiFuture<Actions>(std::move(immediateActions));
+      });
+}
+
+/**
+ * Like runOnCallerIfComplete, for continuations that produce AsyncActions.
+ * If the result is already available func runs on the caller and its actions
+ * are returned as is, so a handshake where every component is synchronous
+ * never allocates a future.
+ */
+template <typename T, typename F>
+AsyncActions runOnCallerIfReady(
+    folly::Executor* executor,
+    ReadyOrFuture<T> result,
+    F&& func) {
+  if (result.isReady()) {
+    return func(std::move(*result.value));
+  } else if (result.future->isReady()) {
+    return func(std::move(*result.future).get());
+  } else {
+    return std::move(*result.future)
+        .via(executor)
+        .thenValueInline([func = std::forward<F>(func)](T value) mutable {
+          return toSemiFuture(func(std::move(value)));
+        })
+        .semi();
+  }
+}
+
 } // namespace detail
 } // namespace server
 
@@ -400,31 +465,50 @@ EventHandler<ServerTypes, StateEnum::Uninitialized, Event::Accept>::handle(
   auto& accept = *param.asAccept();
   auto factory = accept.context->getFactory();
   auto readRecordLayer = factory->makePlaintextReadRecordLayer();
+  if (const auto& filter = accept.context->getClientHelloFilter()) {
+    readRecordLayer->setClientHelloCallback(
+        [filter](const ClientHelloInfo& info) {
+          if (filter->filter(info) == ClientHelloFilterResult::Reject) {
+            throw FizzException(
+                "client hello rejected by filter",
+                AlertDescription::handshake_failure);
+          }
+        });
+  }
   auto writeRecordLayer = factory->makePlaintextWriteRecordLayer();
   auto handshakeLogging = std::make_unique<HandshakeLogging>();
+  std::unique_ptr<HandshakeTimings> handshakeTimings;
+  if (accept.context->getRecordHandshakeTimings()) {
+    handshakeTimings = std::make_unique<HandshakeTimings>();
+  }
   return actions(
       MutateState([executor = accept.executor,
                    rrl = std::move(readRecordLayer),
                    wrl = std::move(writeRecordLayer),
                    context = std::move(accept.context),
                    handshakeLogging = std::move(handshakeLogging),
+                   handshakeTimings = std::move(handshakeTimings),
                    extensions = accept.extensions](State& newState) mutable {
         newState.executor() = executor;
         newState.context() = std::move(context);
         newState.readRecordLayer() = std::move(rrl);
         newState.writeRecordLayer() = std::move(wrl);
         newState.handshakeLogging() = std::move(handshakeLogging);
+        newState.handshakeTimings() = std::move(handshakeTimings);
         newState.extensions() = std::move(extensions);
       }),
       MutateState(&Transition<StateEnum::ExpectingClientHello>));
 }
 
-static void addHandshakeLogging(const State& state, const ClientHello& chlo) {
+static void addHandshakeLogging(
+    const State& state,
+    const ClientHello& chlo,
+    ClientHelloExtensions& extensions) {
   auto logging = state.handshakeLogging();
   if (!logging) {
     return;
   }
-  logging->populateFromClientHello(chlo);
+  logging->populateFromClientHello(chlo, extensions);
   auto plaintextReadRecord =
       dynamic_cast<PlaintextReadRecordLayer*>(state.readRecordLayer());
   if (plaintextReadRecord) {
@@ -433,6 +517,13 @@ static void addHandshakeLogging(const State& state, const ClientHello& chlo) {
   }
 }
 
+static void recordHandshakePhase(const State& state, HandshakePhase phase) {
+  auto timings = state.handshakeTimings();
+  if (timings) {
+    timings->record(phase);
+  }
+}
+
 static void validateClientHello(const ClientHello& chlo) {
   if (chlo.legacy_compression_methods.size() != 1 ||
       chlo.legacy_compression_methods.front() != 0x00) {
@@ -444,9 +535,9 @@ static void validateClientHello(const ClientHello& chlo) {
 }
 
 static Optional<ProtocolVersion> negotiateVersion(
-    const ClientHello& chlo,
+    ClientHelloExtensions& extensions,
     const std::vector<ProtocolVersion>& versions) {
-  const auto& clientVersions = getExtension<SupportedVersions>(chlo.extensions);
+  const auto& clientVersions = extensions.get<SupportedVersions>();
   if (!clientVersions) {
     return folly::none;
   }
@@ -507,28 +598,30 @@ static void verifyCookieState(
 }
 
 namespace {
+using ResumptionStateResultType =
+    std::pair<PskType, Optional<ResumptionState>>;
+
 struct ResumptionStateResult {
   explicit ResumptionStateResult(
-      SemiFuture<std::pair<PskType, Optional<ResumptionState>>>
-          futureResStateArg,
+      ReadyOrFuture<ResumptionStateResultType> futureResStateArg,
       Optional<PskKeyExchangeMode> pskModeArg = folly::none,
       Optional<uint32_t> obfuscatedAgeArg = folly::none)
       : futureResState(std::move(futureResStateArg)),
         pskMode(std::move(pskModeArg)),
         obfuscatedAge(std::move(obfuscatedAgeArg)) {}
 
-  SemiFuture<std::pair<PskType, Optional<ResumptionState>>> futureResState;
+  ReadyOrFuture<ResumptionStateResultType> futureResState;
   Optional<PskKeyExchangeMode> pskMode;
   Optional<uint32_t> obfuscatedAge;
 };
 } // namespace
 
 static ResumptionStateResult getResumptionState(
-    const ClientHello& chlo,
+    ClientHelloExtensions& extensions,
     const TicketCipher* ticketCipher,
     const std::vector<PskKeyExchangeMode>& supportedModes) {
-  auto psks = getExtension<ClientPresharedKey>(chlo.extensions);
-  auto clientModes = getExtension<PskKeyExchangeModes>(chlo.extensions);
+  const auto& psks = extensions.get<ClientPresharedKey>();
+  const auto& clientModes = extensions.get<PskKeyExchangeModes>();
   if (psks && !clientModes) {
     throw FizzException("no psk modes", AlertDescription::missing_extension);
   }
@@ -540,40 +633,49 @@ static ResumptionStateResult getResumptionState(
   if (!psks && !pskMode) {
     FOLLY_SDT(fizz, session_cache_NotSupported);
     return ResumptionStateResult(
-        std::make_pair(PskType::NotSupported, folly::none));
+        ResumptionStateResultType(PskType::NotSupported, folly::none));
   } else if (!psks || psks->identities.size() <= kPskIndex) {
     FOLLY_SDT(fizz, session_cache_NotAttempted);
     return ResumptionStateResult(
-        std::make_pair(PskType::NotAttempted, folly::none));
+        ResumptionStateResultType(PskType::NotAttempted, folly::none));
   } else if (!ticketCipher) {
     FOLLY_SDT(fizz, session_cache_NoTicketCipher);
     VLOG(8) << "No ticket cipher, rejecting PSK.";
     return ResumptionStateResult(
-        std::make_pair(PskType::Rejected, folly::none));
+        ResumptionStateResultType(PskType::Rejected, folly::none));
   } else if (!pskMode) {
     FOLLY_SDT(fizz, session_cache_PskModeMismatch);
     VLOG(8) << "No psk mode match, rejecting PSK.";
     return ResumptionStateResult(
-        std::make_pair(PskType::Rejected, folly::none));
+        ResumptionStateResultType(PskType::Rejected, folly::none));
   } else {
     FOLLY_SDT(fizz, session_cache_ResumptionSuccess);
     const auto& ident = psks->identities[kPskIndex].psk_identity;
+    const auto obfuscatedAge =
+        psks->identities[kPskIndex].obfuscated_ticket_age;
+    auto resState = ticketCipher->decryptSyncOrAsync(*ident);
+    if (resState.result) {
+      return ResumptionStateResult(
+          std::move(*resState.result), pskMode, obfuscatedAge);
+    }
     return ResumptionStateResult(
-        ticketCipher->decrypt(ident->clone()),
-        pskMode,
-        psks->identities[kPskIndex].obfuscated_ticket_age);
+        std::move(*resState.future), pskMode, obfuscatedAge);
   }
 }
 
-static SemiFuture<ReplayCacheResult> getReplayCacheResult(
+static ReadyOrFuture<ReplayCacheResult> getReplayCacheResult(
     const ClientHello& chlo,
+    ClientHelloExtensions& extensions,
     bool zeroRttEnabled,
     ReplayCache* replayCache) {
-  if (!zeroRttEnabled || !replayCache ||
-      !getExtension<ClientEarlyData>(chlo.extensions)) {
+  if (!zeroRttEnabled || !replayCache || !extensions.get<ClientEarlyData>()) {
     FOLLY_SDT(fizz, replay_cache_NotChecked);
     return ReplayCacheResult::NotChecked;
   }
+  auto result = replayCache->checkSync(folly::range(chlo.random));
+  if (result) {
+    return *result;
+  }
   auto randBuf = folly::IOBuf::copyBuffer(chlo.random, chlo.random.size());
   return replayCache->check(std::move(randBuf));
 }
@@ -624,6 +726,7 @@ static std::
         const Factory& factory,
         CipherSuite cipher,
         const ClientHello& chlo,
+        ClientHelloExtensions& extensions,
         const Optional<ResumptionState>& resState,
         const Optional<CookieState>& cookieState,
         PskType pskType,
@@ -665,7 +768,7 @@ static std::
         chloQueue.split(chloQueue.chainLength() - getBinderLength(chlo));
     handshakeContext->appendToTranscript(chloPrefix);
 
-    const auto& psks = getExtension<ClientPresharedKey>(chlo.extensions);
+    const auto& psks = extensions.get<ClientPresharedKey>();
     if (!psks || psks->binders.size() <= kPskIndex) {
       throw FizzException("no binders", AlertDescription::illegal_parameter);
     }
@@ -701,9 +804,9 @@ static void validateGroups(const std::vector<KeyShareEntry>& client_shares) {
 
 static std::tuple<NamedGroup, Optional<Buf>> negotiateGroup(
     ProtocolVersion /*version*/,
-    const ClientHello& chlo,
+    ClientHelloExtensions& extensions,
     const std::vector<NamedGroup>& supportedGroups) {
-  auto groups = getExtension<SupportedGroups>(chlo.extensions);
+  const auto& groups = extensions.get<SupportedGroups>();
   if (!groups) {
     throw FizzException("no named groups", AlertDescription::missing_extension);
   }
@@ -711,7 +814,7 @@ static std::tuple<NamedGroup, Optional<Buf>> negotiateGroup(
   if (!group) {
     throw FizzException("no group match", AlertDescription::handshake_failure);
   }
-  auto clientShares = getExtension<ClientKeyShare>(chlo.extensions);
+  const auto& clientShares = extensions.get<ClientKeyShare>();
   if (!clientShares) {
     throw FizzException(
         "no client shares", AlertDescription::missing_extension);
@@ -726,19 +829,19 @@ static std::tuple<NamedGroup, Optional<Buf>> negotiateGroup(
   return std::make_tuple(*group, folly::none);
 }
 
-static SemiFuture<Optional<AsyncKeyExchange::DoKexResult>> doKexSyncFuture(
+static AsyncKeyExchange::DoKexResult doKexSync(
     KeyExchange* kex,
     std::unique_ptr<folly::IOBuf> clientShare) {
   AsyncKeyExchange::DoKexResult res;
   kex->generateKeyPair();
   res.sharedSecret = kex->generateSharedSecret(clientShare->coalesce());
   res.ourKeyShare = kex->getKeyShare();
-  return folly::makeSemiFuture(Optional(std::move(res)));
+  return res;
   // Everything completed and clientShare can be safely freed now.
 }
 
 // Caller is responsible to hold pKex until the lambda finished.
-static SemiFuture<Optional<AsyncKeyExchange::DoKexResult>> doKexFuture(
+static ReadyOrFuture<Optional<AsyncKeyExchange::DoKexResult>> doKexFuture(
     KeyExchange* pKex,
     std::unique_ptr<folly::IOBuf> clientShare) {
   auto pAsyncKex = dynamic_cast<AsyncKeyExchange*>(pKex);
@@ -748,7 +851,8 @@ static SemiFuture<Optional<AsyncKeyExchange::DoKexResult>> doKexFuture(
       return Optional(std::move(res));
     });
   } else {
-    return doKexSyncFuture(pKex, std::move(clientShare));
+    return Optional<AsyncKeyExchange::DoKexResult>(
+        doKexSync(pKex, std::move(clientShare)));
   }
 }
 
@@ -806,10 +910,10 @@ static ServerHello getServerHello(
 }
 
 static Optional<std::string> negotiateAlpn(
-    const ClientHello& chlo,
+    ClientHelloExtensions& extensions,
     folly::Optional<std::string> zeroRttAlpn,
     const FizzServerContext& context) {
-  auto ext = getExtension<ProtocolNameList>(chlo.extensions);
+  const auto& ext = extensions.get<ProtocolNameList>();
   std::vector<std::string> clientProtocols;
   // Check whether client supports ALPN
   if (ext) {
@@ -868,7 +972,7 @@ static Optional<Buf> getAppToken(const Optional<ResumptionState>& psk) {
 
 static EarlyDataType negotiateEarlyDataType(
     bool acceptEarlyData,
-    const ClientHello& chlo,
+    ClientHelloExtensions& extensions,
     const Optional<ResumptionState>& psk,
     CipherSuite cipher,
     Optional<KeyExchangeType> keyExchangeType,
@@ -878,7 +982,7 @@ static EarlyDataType negotiateEarlyDataType(
     Optional<std::chrono::milliseconds> clockSkew,
     ClockSkewTolerance clockSkewTolerance,
     const AppTokenValidator* appTokenValidator) {
-  if (!getExtension<ClientEarlyData>(chlo.extensions)) {
+  if (!extensions.get<ClientEarlyData>()) {
     return EarlyDataType::NotAttempted;
   }
 
@@ -972,14 +1076,14 @@ static Buf getEncryptedExt(
 
 static std::pair<std::shared_ptr<SelfCert>, SignatureScheme> chooseCert(
     const FizzServerContext& context,
-    const ClientHello& chlo) {
-  const auto& clientSigSchemes =
-      getExtension<SignatureAlgorithms>(chlo.extensions);
+    const ClientHello& chlo,
+    ClientHelloExtensions& extensions) {
+  const auto& clientSigSchemes = extensions.get<SignatureAlgorithms>();
   if (!clientSigSchemes) {
     throw FizzException("no sig schemes", AlertDescription::missing_extension);
   }
   Optional<std::string> sni;
-  auto serverNameList = getExtension<ServerNameList>(chlo.extensions);
+  const auto& serverNameList = extensions.get<ServerNameList>();
   if (serverNameList && !serverNameList->server_name_list.empty()) {
     sni = serverNameList->server_name_list.front().hostname->to<std::string>();
   }
@@ -997,13 +1101,12 @@ static std::tuple<Buf, folly::Optional<CertificateCompressionAlgorithm>>
 getCertificate(
     const std::shared_ptr<const SelfCert>& serverCert,
     const FizzServerContext& context,
-    const ClientHello& chlo,
+    ClientHelloExtensions& extensions,
     HandshakeContext& handshakeContext) {
   // Check for compression support first, and if so, send compressed.
   Buf encodedCertificate;
   folly::Optional<CertificateCompressionAlgorithm> algo;
-  auto compAlgos =
-      getExtension<CertificateCompressionAlgorithms>(chlo.extensions);
+  const auto& compAlgos = extensions.get<CertificateCompressionAlgorithms>();
   if (compAlgos && !context.getSupportedCompressionAlgorithms().empty()) {
     algo = negotiate(
         context.getSupportedCompressionAlgorithms(), compAlgos->algorithms);
@@ -1206,6 +1309,7 @@ AsyncActions
 EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
     handle(const State& state, Param& param) {
   ClientHello chlo = std::move(*param.asClientHello());
+  recordHandshakePhase(state, HandshakePhase::ClientHello);
 
   auto cookieState = getCookieState(chlo, state.context()->getCookieCipher());
 
@@ -1218,8 +1322,13 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
   folly::Optional<ECHState> echState;
 
   std::tie(echStatus, echState) = processECH(cookieState, state, chlo);
+  if (echStatus != ECHStatus::NotRequested) {
+    recordHandshakePhase(state, HandshakePhase::ECHDecryption);
+  }
 
-  addHandshakeLogging(state, chlo);
+  // Extensions are looked up from here on, after ECH may have replaced chlo.
+  ClientHelloExtensions extensions(chlo.extensions);
+  addHandshakeLogging(state, chlo, extensions);
 
   if (state.readRecordLayer()->hasUnparsedHandshakeData()) {
     throw FizzException(
@@ -1227,7 +1336,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
   }
 
   auto version =
-      negotiateVersion(chlo, state.context()->getSupportedVersions());
+      negotiateVersion(extensions, state.context()->getSupportedVersions());
 
   if (state.version().has_value() &&
       (!version || *version != *state.version())) {
@@ -1237,7 +1346,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
   }
 
   if (!version) {
-    if (getExtension<ClientEarlyData>(chlo.extensions)) {
+    if (extensions.get<ClientEarlyData>()) {
       throw FizzException(
           "supported version mismatch with early data",
           AlertDescription::protocol_version);
@@ -1252,7 +1361,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
               .writeInitialClientHello(std::move(*chlo.originalEncoding))
               .data;
       // Save SNI extension value to help decide server SSL context.
-      auto serverNameList = getExtension<ServerNameList>(chlo.extensions);
+      const auto& serverNameList = extensions.get<ServerNameList>();
       if (serverNameList && !serverNameList->server_name_list.empty()) {
         fallback.sni = serverNameList->server_name_list.front()
                            .hostname->to<std::string>();
@@ -1281,34 +1390,32 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
   verifyCookieState(cookieState, *version, cipher);
 
   auto resStateResult = getResumptionState(
-      chlo,
+      extensions,
       state.context()->getTicketCipher(),
       state.context()->getSupportedPskModes());
 
   auto replayCacheResultFuture = getReplayCacheResult(
       chlo,
+      extensions,
       state.context()->getAcceptEarlyData(*version),
       state.context()->getReplayCache());
 
-  auto results =
-      collectAll(resStateResult.futureResState, replayCacheResultFuture);
-
   using FutureResultType = std::tuple<
-      folly::Try<std::pair<PskType, Optional<ResumptionState>>>,
+      folly::Try<ResumptionStateResultType>,
       folly::Try<ReplayCacheResult>>;
-  return runOnCallerIfComplete(
-      state.executor(),
-      std::move(results),
+  auto handleResults =
       [&state,
        chlo = std::move(chlo),
+       extensions = std::move(extensions),
        cookieState = std::move(cookieState),
        version = *version,
        cipher,
        pskMode = resStateResult.pskMode,
        echStatus,
        echState = std::move(echState),
-       obfuscatedAge =
-           resStateResult.obfuscatedAge](FutureResultType result) mutable {
+       obfuscatedAge = resStateResult.obfuscatedAge](
+          FutureResultType result) mutable -> AsyncActions {
+        recordHandshakePhase(state, HandshakePhase::ResumptionCheck);
         auto& resumption = *std::get<0>(result);
         auto pskType = resumption.first;
         auto resState = std::move(resumption.second);
@@ -1342,13 +1449,14 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
             *state.context()->getFactory(),
             cipher,
             chlo,
+            extensions,
             resState,
             cookieState,
             pskType,
             std::move(state.handshakeContext()),
             version);
 
-        auto alpn = negotiateAlpn(chlo, folly::none, *state.context());
+        auto alpn = negotiateAlpn(extensions, folly::none, *state.context());
 
         auto clockSkew = getClockSkew(
             resState,
@@ -1359,7 +1467,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
 
         auto earlyDataType = negotiateEarlyDataType(
             state.context()->getAcceptEarlyData(version),
-            chlo,
+            extensions,
             resState,
             cipher,
             state.keyExchangeType(),
@@ -1402,14 +1510,14 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
 
         Optional<NamedGroup> group;
         KeyExchangeType keyExchangeType;
-        SemiFuture<Optional<AsyncKeyExchange::DoKexResult>> kexResultFuture =
-            folly::none;
+        ReadyOrFuture<Optional<AsyncKeyExchange::DoKexResult>>
+            kexResultFuture = Optional<AsyncKeyExchange::DoKexResult>();
         std::unique_ptr<KeyExchange> kex = nullptr;
 
         if (!pskMode || *pskMode != PskKeyExchangeMode::psk_ke) {
           Optional<Buf> clientShare;
           std::tie(group, clientShare) = negotiateGroup(
-              version, chlo, state.context()->getSupportedGroups());
+              version, extensions, state.context()->getSupportedGroups());
           if (!clientShare) {
             VLOG(8) << "Did not find key share for " << toString(*group);
             if (state.group().has_value() || cookieState) {
@@ -1472,7 +1580,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
             newReadRecordLayer->setSkipEncryptedRecords(
                 earlyDataType == EarlyDataType::Rejected);
 
-            return SemiFuture<Actions>(actions(
+            return actions(
                 MutateState([handshakeContext = std::move(handshakeContext),
                              version,
                              cipher,
@@ -1500,7 +1608,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
                   newState.echState() = std::move(echState);
                 }),
                 std::move(serverFlight),
-                MutateState(&Transition<StateEnum::ExpectingClientHello>)));
+                MutateState(&Transition<StateEnum::ExpectingClientHello>));
           }
 
           if (state.keyExchangeType().has_value()) {
@@ -1519,7 +1627,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
           keyExchangeType = KeyExchangeType::None;
         }
 
-        return runOnCallerIfComplete(
+        return runOnCallerIfReady(
             state.executor(),
             std::move(kexResultFuture),
             [&state,
@@ -1544,6 +1652,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
              legacySessionId = std::move(legacySessionId),
              handshakeTime,
              chlo = std::move(chlo),
+             extensions = std::move(extensions),
              cookieState = std::move(cookieState),
              resState = std::move(resState),
              // Hold kex until the doKexFuture finished.
@@ -1551,6 +1660,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
                 Optional<AsyncKeyExchange::DoKexResult> kexResult) mutable {
               Optional<Buf> serverShare;
               if (kexResult.hasValue()) {
+                recordHandshakePhase(state, HandshakePhase::KeyExchange);
                 serverShare = std::move(kexResult.value().ourKeyShare);
                 scheduler->deriveHandshakeSecret(
                     kexResult.value().sharedSecret->coalesce());
@@ -1673,7 +1783,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
                * transcript.
                */
               Optional<Buf> encodedCertificate;
-              SemiFuture<Optional<Buf>> signature = folly::none;
+              ReadyOrFuture<Optional<Buf>> signature = Optional<Buf>();
               Optional<SignatureScheme> sigScheme;
               Optional<std::shared_ptr<const Cert>> serverCert;
               std::shared_ptr<const Cert> clientCert;
@@ -1681,14 +1791,15 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
               if (!resState) { // TODO or reauth
                 std::shared_ptr<const SelfCert> originalSelfCert;
                 std::tie(originalSelfCert, sigScheme) =
-                    chooseCert(*state.context(), chlo);
+                    chooseCert(*state.context(), chlo, extensions);
 
                 std::tie(encodedCertificate, certCompressionAlgo) =
                     getCertificate(
                         originalSelfCert,
                         *state.context(),
-                        chlo,
+                        extensions,
                         *handshakeContext);
+                recordHandshakePhase(state, HandshakePhase::CertSelection);
 
                 auto toBeSigned = handshakeContext->getHandshakeContext();
                 auto asyncSelfCert =
@@ -1699,11 +1810,10 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
                       CertificateVerifyContext::Server,
                       std::move(toBeSigned));
                 } else {
-                  signature = folly::makeSemiFuture<Optional<Buf>>(
-                      originalSelfCert->sign(
-                          *sigScheme,
-                          CertificateVerifyContext::Server,
-                          toBeSigned->coalesce()));
+                  signature = Optional<Buf>(originalSelfCert->sign(
+                      *sigScheme,
+                      CertificateVerifyContext::Server,
+                      toBeSigned->coalesce()));
                 }
                 serverCert = std::move(originalSelfCert);
               } else {
@@ -1713,7 +1823,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
 
               auto clientRandom = std::move(chlo.random);
 
-              return runOnCallerIfComplete(
+              return runOnCallerIfReady(
                   state.executor(),
                   std::move(signature),
                   [&state,
@@ -1758,6 +1868,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
                    handshakeTime](Optional<Buf> sig) mutable {
                     Optional<Buf> encodedCertificateVerify;
                     if (sig) {
+                      recordHandshakePhase(state, HandshakePhase::Signing);
                       encodedCertificateVerify = getCertificateVerify(
                           *sigScheme, std::move(*sig), *handshakeContext);
                     }
@@ -1844,6 +1955,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
                         folly::range(writeSecret.secret),
                         *state.context()->getFactory(),
                         *scheduler);
+                    recordHandshakePhase(state, HandshakePhase::ServerFlight);
 
                     // If we have previously dealt with early data (before a
                     // HelloRetryRequest), don't overwrite the previous result.
@@ -1991,7 +2103,22 @@ EventHandler<ServerTypes, StateEnum::ExpectingClientHello, Event::ClientHello>::
                     }
                   });
             });
-      });
+      };
+
+  // Stay on the caller when the ticket cipher and replay cache answered
+  // synchronously, without allocating futures for their results.
+  if (resStateResult.futureResState.isReady() &&
+      replayCacheResultFuture.isReady()) {
+    return handleResults(FutureResultType(
+        std::move(*resStateResult.futureResState.value),
+        *replayCacheResultFuture.value));
+  }
+
+  auto results = collectAll(
+      std::move(resStateResult.futureResState).toSemiFuture(),
+      std::move(replayCacheResultFuture).toSemiFuture());
+  return runOnCallerIfReady<FutureResultType>(
+      state.executor(), std::move(results), std::move(handleResults));
 }
 
 AsyncActions
@@ -2053,7 +2180,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingFinished, Event::AppWrite>::
   return actions(std::move(write));
 }
 
-static WriteToSocket writeNewSessionTicket(
+static TLSContent writeNewSessionTicket(
     const FizzServerContext& context,
     const WriteRecordLayer& recordLayer,
     std::chrono::seconds ticketLifetime,
@@ -2074,24 +2201,38 @@ static WriteToSocket writeNewSessionTicket(
   }
 
   auto encodedNst = encodeHandshake(std::move(nst));
-  WriteToSocket nstWrite;
-  nstWrite.contents.emplace_back(
-      recordLayer.writeHandshake(std::move(encodedNst)));
-  return nstWrite;
+  return recordLayer.writeHandshake(std::move(encodedNst));
 }
 
-static SemiFuture<Optional<WriteToSocket>> generateTicket(
+namespace {
+struct EncryptedTicket {
+  Buf ticket;
+  std::chrono::seconds lifetime;
+  uint32_t ticketAgeAdd;
+  Buf nonce;
+};
+} // namespace
+
+static Buf getTicketNonce(uint32_t ticketNumber) {
+  // The first ticket keeps the empty nonce, later ones only need to be
+  // distinct within the connection.
+  auto nonce = folly::IOBuf::create(sizeof(ticketNumber));
+  if (ticketNumber > 0) {
+    folly::io::Appender appender(nonce.get(), 0);
+    appender.writeBE(ticketNumber);
+  }
+  return nonce;
+}
+
+static SemiFuture<Optional<EncryptedTicket>> encryptTicket(
     const State& state,
     const std::vector<uint8_t>& resumptionMasterSecret,
-    Buf appToken = nullptr) {
+    uint32_t ticketNumber,
+    Buf appToken) {
   auto ticketCipher = state.context()->getTicketCipher();
 
-  if (!ticketCipher || *state.pskType() == PskType::NotSupported) {
-    return folly::none;
-  }
-
   Buf resumptionSecret;
-  auto ticketNonce = folly::IOBuf::create(0);
+  auto ticketNonce = getTicketNonce(ticketNumber);
   resumptionSecret = state.keyScheduler()->getResumptionSecret(
       folly::range(resumptionMasterSecret), ticketNonce->coalesce());
 
@@ -2112,21 +2253,81 @@ static SemiFuture<Optional<WriteToSocket>> generateTicket(
   return runOnCallerIfComplete(
       state.executor(),
       std::move(ticketFuture),
-      [&state, ticketAgeAdd, ticketNonce = std::move(ticketNonce)](
+      [ticketAgeAdd, ticketNonce = std::move(ticketNonce)](
           Optional<std::pair<Buf, std::chrono::seconds>> ticket) mutable
-      -> Optional<WriteToSocket> {
+      -> Optional<EncryptedTicket> {
         if (!ticket) {
           return folly::none;
         }
-        return writeNewSessionTicket(
-            *state.context(),
-            *state.writeRecordLayer(),
+        return EncryptedTicket{
+            std::move(ticket->first),
             ticket->second,
             ticketAgeAdd,
-            std::move(ticketNonce),
-            std::move(ticket->first),
-            *state.version());
+            std::move(ticketNonce)};
+      });
+}
+
+/**
+ * Issues count tickets, numbered from state.ticketsIssued(). The tickets are
+ * written to the record layer in order once all of them are encrypted.
+ */
+static SemiFuture<Optional<WriteToSocket>> generateTickets(
+    const State& state,
+    const std::vector<uint8_t>& resumptionMasterSecret,
+    uint32_t count,
+    Buf appToken = nullptr) {
+  if (!state.context()->getTicketCipher() ||
+      *state.pskType() == PskType::NotSupported || count == 0) {
+    return folly::none;
+  }
+
+  std::vector<SemiFuture<Optional<EncryptedTicket>>> ticketFutures;
+  ticketFutures.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    ticketFutures.push_back(encryptTicket(
+        state,
+        resumptionMasterSecret,
+        state.ticketsIssued() + i,
+        appToken ? appToken->clone() : nullptr));
+  }
+
+  auto writeTickets = [&state](std::vector<Optional<EncryptedTicket>> tickets)
+      -> Optional<WriteToSocket> {
+    WriteToSocket nstWrite;
+    for (auto& ticket : tickets) {
+      if (ticket) {
+        nstWrite.contents.emplace_back(writeNewSessionTicket(
+            *state.context(),
+            *state.writeRecordLayer(),
+            ticket->lifetime,
+            ticket->ticketAgeAdd,
+            std::move(ticket->nonce),
+            std::move(ticket->ticket),
+            *state.version()));
+      }
+    }
+    if (nstWrite.contents.empty()) {
+      return folly::none;
+    }
+    return nstWrite;
+  };
+
+  bool ready = std::all_of(
+      ticketFutures.begin(), ticketFutures.end(), [](const auto& future) {
+        return future.isReady();
       });
+  if (ready) {
+    std::vector<Optional<EncryptedTicket>> tickets;
+    tickets.reserve(count);
+    for (auto& future : ticketFutures) {
+      tickets.push_back(std::move(future).get());
+    }
+    return writeTickets(std::move(tickets));
+  }
+  return runOnCallerIfComplete(
+      state.executor(),
+      folly::collect(std::move(ticketFutures)),
+      std::move(writeTickets));
 }
 
 AsyncActions
@@ -2246,6 +2447,7 @@ EventHandler<ServerTypes, StateEnum::ExpectingFinished, Event::Finished>::
   if (state.readRecordLayer()->hasUnparsedHandshakeData()) {
     throw FizzException("data after finished", folly::none);
   }
+  recordHandshakePhase(state, HandshakePhase::ClientFinished);
 
   auto readRecordLayer =
       state.context()->getFactory()->makeEncryptedReadRecordLayer(
@@ -2270,10 +2472,15 @@ EventHandler<ServerTypes, StateEnum::ExpectingFinished, Event::Finished>::
           .secret;
   state.keyScheduler()->clearMasterSecret();
 
+  auto numTickets = state.context()->getSendNewSessionTicket()
+      ? state.context()->getNumNewSessionTickets()
+      : 0;
   MutateState saveState([readRecordLayer = std::move(readRecordLayer),
-                         resumptionMasterSecret](State& newState) mutable {
+                         resumptionMasterSecret,
+                         numTickets](State& newState) mutable {
     newState.readRecordLayer() = std::move(readRecordLayer);
     newState.resumptionMasterSecret() = std::move(resumptionMasterSecret);
+    newState.ticketsIssued() += numTickets;
   });
 
   SecretAvailable appReadTrafficSecretAvailable(std::move(readSecret));
@@ -2285,7 +2492,8 @@ EventHandler<ServerTypes, StateEnum::ExpectingFinished, Event::Finished>::
         MutateState(&Transition<StateEnum::AcceptingData>),
         ReportHandshakeSuccess());
   } else {
-    auto ticketFuture = generateTicket(state, resumptionMasterSecret);
+    auto ticketFuture =
+        generateTickets(state, resumptionMasterSecret, numTickets);
     return runOnCallerIfComplete(
         state.executor(),
         std::move(ticketFuture),
@@ -2316,18 +2524,24 @@ AsyncActions EventHandler<
     StateEnum::AcceptingData,
     Event::WriteNewSessionTicket>::handle(const State& state, Param& param) {
   auto& writeNewSessionTicket = *param.asWriteNewSessionTicket();
-  auto ticketFuture = generateTicket(
+  auto count = writeNewSessionTicket.count;
+  auto ticketFuture = generateTickets(
       state,
       state.resumptionMasterSecret(),
+      count,
       std::move(writeNewSessionTicket.appToken));
   return runOnCallerIfComplete(
       state.executor(),
       std::move(ticketFuture),
-      [](Optional<WriteToSocket> nstWrite) {
+      [count](Optional<WriteToSocket> nstWrite) {
         if (!nstWrite) {
           return Actions();
         }
-        return actions(std::move(*nstWrite));
+        return actions(
+            MutateState([count](State& newState) {
+              newState.ticketsIssued() += count;
+            }),
+            std::move(*nstWrite));
       });
 }
 
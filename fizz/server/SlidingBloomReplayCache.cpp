@@ -169,6 +169,15 @@ folly::SemiFuture<ReplayCacheResult> SlidingBloomReplayCache::check(
       .semi();
 }
 
+folly::Optional<ReplayCacheResult> SlidingBloomReplayCache::checkSync(
+    folly::ByteRange query) {
+  if (executor_ && !executor_->isInEventBaseThread()) {
+    return folly::none;
+  }
+  return testAndSet(query) ? ReplayCacheResult::MaybeReplay
+                           : ReplayCacheResult::NotReplay;
+}
+
 void SlidingBloomReplayCache::clearBucket(size_t bucket) {
   VLOG(8) << "Clearing bit " << bucket << ", current bucket is "
           << currentBucket_;
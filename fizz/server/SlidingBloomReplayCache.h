@@ -53,6 +53,11 @@ class SlidingBloomReplayCache : public ReplayCache,
   folly::SemiFuture<ReplayCacheResult> check(
       std::unique_ptr<folly::IOBuf> query) override;
 
+  // Only answers synchronously when called on the event base thread (or
+  // without an event base), otherwise the check has to hop threads.
+  folly::Optional<ReplayCacheResult> checkSync(
+      folly::ByteRange query) override;
+
  private:
   void clearBucket(size_t bucket);
   void clear();
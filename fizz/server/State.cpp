@@ -12,8 +12,15 @@ namespace fizz {
 namespace server {
 
 void HandshakeLogging::populateFromClientHello(const ClientHello& chlo) {
+  ClientHelloExtensions extensions(chlo.extensions);
+  populateFromClientHello(chlo, extensions);
+}
+
+void HandshakeLogging::populateFromClientHello(
+    const ClientHello& chlo,
+    ClientHelloExtensions& extensions) {
   clientLegacyVersion = chlo.legacy_version;
-  auto supportedVersions = getExtension<SupportedVersions>(chlo.extensions);
+  const auto& supportedVersions = extensions.get<SupportedVersions>();
   if (supportedVersions) {
     clientSupportedVersions = supportedVersions->versions;
   }
@@ -28,22 +35,22 @@ void HandshakeLogging::populateFromClientHello(const ClientHello& chlo) {
     }
   }
   clientAlpns.clear();
-  auto alpn = getExtension<ProtocolNameList>(chlo.extensions);
+  const auto& alpn = extensions.get<ProtocolNameList>();
   if (alpn) {
     for (auto& protocol : alpn->protocol_name_list) {
       clientAlpns.push_back(protocol.name->to<std::string>());
     }
   }
-  auto sni = getExtension<ServerNameList>(chlo.extensions);
+  const auto& sni = extensions.get<ServerNameList>();
   if (sni && !sni->server_name_list.empty()) {
     clientSni = sni->server_name_list.front().hostname->to<std::string>();
   }
-  auto supportedGroups = getExtension<SupportedGroups>(chlo.extensions);
+  const auto& supportedGroups = extensions.get<SupportedGroups>();
   if (supportedGroups) {
-    clientSupportedGroups = std::move(supportedGroups->named_group_list);
+    clientSupportedGroups = supportedGroups->named_group_list;
   }
 
-  auto keyShare = getExtension<ClientKeyShare>(chlo.extensions);
+  const auto& keyShare = extensions.get<ClientKeyShare>();
   if (keyShare && !clientKeyShares) {
     std::vector<NamedGroup> shares;
     for (const auto& entry : keyShare->client_shares) {
@@ -52,15 +59,15 @@ void HandshakeLogging::populateFromClientHello(const ClientHello& chlo) {
     clientKeyShares = std::move(shares);
   }
 
-  auto exchangeModes = getExtension<PskKeyExchangeModes>(chlo.extensions);
+  const auto& exchangeModes = extensions.get<PskKeyExchangeModes>();
   if (exchangeModes) {
-    clientKeyExchangeModes = std::move(exchangeModes->modes);
+    clientKeyExchangeModes = exchangeModes->modes;
   }
 
-  auto clientSigSchemes = getExtension<SignatureAlgorithms>(chlo.extensions);
+  const auto& clientSigSchemes = extensions.get<SignatureAlgorithms>();
   if (clientSigSchemes) {
     clientSignatureAlgorithms =
-        std::move(clientSigSchemes->supported_signature_algorithms);
+        clientSigSchemes->supported_signature_algorithms;
   }
 
   clientSessionIdSent =
@@ -96,6 +103,43 @@ folly::StringPiece toString(StateEnum state) {
   return "Invalid state";
 }
 
+void HandshakeTimings::record(HandshakePhase phase) {
+  phaseEnd[static_cast<size_t>(phase)] = Clock::now();
+}
+
+folly::Optional<std::chrono::nanoseconds> HandshakeTimings::getDuration(
+    HandshakePhase phase) const {
+  auto index = static_cast<size_t>(phase);
+  if (index >= phaseEnd.size() || !phaseEnd[index]) {
+    return folly::none;
+  }
+  auto previous = start;
+  for (size_t i = index; i > 0; i--) {
+    if (phaseEnd[i - 1]) {
+      previous = phaseEnd[i - 1];
+      break;
+    }
+  }
+  if (!previous) {
+    return folly::none;
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      *phaseEnd[index] - *previous);
+}
+
+folly::Optional<std::chrono::nanoseconds> HandshakeTimings::getTotal() const {
+  if (!start) {
+    return folly::none;
+  }
+  for (auto it = phaseEnd.rbegin(); it != phaseEnd.rend(); ++it) {
+    if (*it) {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          **it - *start);
+    }
+  }
+  return folly::none;
+}
+
 folly::StringPiece toString(ECHStatus status) {
   switch (status) {
     case ECHStatus::NotRequested:
@@ -107,5 +151,29 @@ folly::StringPiece toString(ECHStatus status) {
   }
   return "Invalid status";
 }
+
+folly::StringPiece toString(HandshakePhase phase) {
+  switch (phase) {
+    case HandshakePhase::ClientHello:
+      return "ClientHello";
+    case HandshakePhase::ECHDecryption:
+      return "ECHDecryption";
+    case HandshakePhase::ResumptionCheck:
+      return "ResumptionCheck";
+    case HandshakePhase::KeyExchange:
+      return "KeyExchange";
+    case HandshakePhase::CertSelection:
+      return "CertSelection";
+    case HandshakePhase::Signing:
+      return "Signing";
+    case HandshakePhase::ServerFlight:
+      return "ServerFlight";
+    case HandshakePhase::ClientFinished:
+      return "ClientFinished";
+    case HandshakePhase::NUM_PHASES:
+      break;
+  }
+  return "Invalid phase";
+}
 } // namespace server
 } // namespace fizz
@@ -21,6 +21,9 @@
 #include <fizz/server/ResumptionState.h>
 #include <fizz/server/ServerExtensions.h>
 
+#include <array>
+#include <chrono>
+
 namespace fizz {
 namespace server {
 
@@ -51,6 +54,22 @@ struct ECHState {
   folly::Optional<std::string> outerSni;
 };
 
+/**
+ * The ClientHello extensions the server looks up while negotiating, decoded
+ * once per ClientHello.
+ */
+using ClientHelloExtensions = CachedExtensions<
+    SupportedVersions,
+    ProtocolNameList,
+    ServerNameList,
+    SupportedGroups,
+    ClientKeyShare,
+    PskKeyExchangeModes,
+    SignatureAlgorithms,
+    ClientPresharedKey,
+    ClientEarlyData,
+    CertificateCompressionAlgorithms>;
+
 struct HandshakeLogging {
   folly::Optional<ProtocolVersion> clientLegacyVersion;
   std::vector<ProtocolVersion> clientSupportedVersions;
@@ -68,6 +87,65 @@ struct HandshakeLogging {
   std::vector<std::string> clientAlpns;
 
   void populateFromClientHello(const ClientHello& chlo);
+  void populateFromClientHello(
+      const ClientHello& chlo,
+      ClientHelloExtensions& extensions);
+};
+
+/**
+ * Phases of a server handshake, in the order they complete.
+ */
+enum class HandshakePhase : uint8_t {
+  // From the first ClientHello bytes being read until the ClientHello is
+  // decoded. After a HelloRetryRequest this includes the retry round trip.
+  ClientHello,
+  // ECH decryption of the outer ClientHello, if ECH was offered.
+  ECHDecryption,
+  // Ticket decryption and replay cache check. These run concurrently, so they
+  // are measured together.
+  ResumptionCheck,
+  // (EC)DHE/KEM key exchange, if a key share was used.
+  KeyExchange,
+  // Certificate selection and encoding, on full handshakes.
+  CertSelection,
+  // CertificateVerify signature, on full handshakes.
+  Signing,
+  // Encoding and encryption of the rest of the server flight.
+  ServerFlight,
+  // Waiting for and processing the client Finished.
+  ClientFinished,
+  NUM_PHASES
+};
+
+/**
+ * Monotonic timestamps of when each handshake phase completed. Phases that
+ * did not happen on a handshake are left unset. Only populated when enabled
+ * with FizzServerContext::setRecordHandshakeTimings().
+ */
+struct HandshakeTimings {
+  using Clock = std::chrono::steady_clock;
+
+  // When the first ClientHello bytes were read.
+  folly::Optional<Clock::time_point> start;
+  std::array<
+      folly::Optional<Clock::time_point>,
+      static_cast<size_t>(HandshakePhase::NUM_PHASES)>
+      phaseEnd;
+
+  void record(HandshakePhase phase);
+
+  /**
+   * Time between the completion of the last recorded phase before phase (or
+   * start) and the completion of phase. Returns none if phase was not
+   * recorded.
+   */
+  folly::Optional<std::chrono::nanoseconds> getDuration(
+      HandshakePhase phase) const;
+
+  /**
+   * Time from start until the last recorded phase.
+   */
+  folly::Optional<std::chrono::nanoseconds> getTotal() const;
 };
 
 /**
@@ -220,6 +298,13 @@ class State {
     return handshakeLogging_.get();
   }
 
+  /**
+   * Per phase handshake timestamps. Null unless enabled on the context.
+   */
+  HandshakeTimings* handshakeTimings() const {
+    return handshakeTimings_.get();
+  }
+
   /**
    * Key scheduler used on this connection.
    *
@@ -285,6 +370,16 @@ class State {
     return resumptionMasterSecret_;
   }
 
+  /**
+   * Number of NewSessionTickets issued on this connection. Used to give each
+   * ticket a distinct nonce.
+   *
+   * Should not be used outside of the state machine.
+   */
+  uint32_t ticketsIssued() const {
+    return ticketsIssued_;
+  }
+
   /**
    * The certificate chain sent by the client pre-verification
    *
@@ -423,6 +518,9 @@ class State {
   auto& handshakeLogging() {
     return handshakeLogging_;
   }
+  auto& handshakeTimings() {
+    return handshakeTimings_;
+  }
   auto& extensions() {
     return extensions_;
   }
@@ -432,6 +530,9 @@ class State {
   auto& resumptionMasterSecret() {
     return resumptionMasterSecret_;
   }
+  auto& ticketsIssued() {
+    return ticketsIssued_;
+  }
   auto& earlyExporterMasterSecret() {
     return earlyExporterMasterSecret_;
   }
@@ -494,11 +595,13 @@ class State {
   std::shared_ptr<ServerExtensions> extensions_;
   std::vector<ExtensionType> certReqExtensions_;
   std::vector<uint8_t> resumptionMasterSecret_;
+  uint32_t ticketsIssued_{0};
   folly::Optional<std::chrono::system_clock::time_point> handshakeTime_;
   ECHStatus echStatus_{ECHStatus::NotRequested};
   folly::Optional<ECHState> echState_;
 
   std::unique_ptr<HandshakeLogging> handshakeLogging_;
+  std::unique_ptr<HandshakeTimings> handshakeTimings_;
 
   folly::Optional<Buf> earlyExporterMasterSecret_;
   folly::Optional<Buf> exporterMasterSecret_;
@@ -506,6 +609,7 @@ class State {
 
 folly::StringPiece toString(server::StateEnum state);
 folly::StringPiece toString(server::ECHStatus status);
+folly::StringPiece toString(server::HandshakePhase phase);
 
 inline std::ostream& operator<<(std::ostream& os, StateEnum state) {
   os << toString(state);
@@ -39,6 +39,43 @@ class TicketCipher {
   virtual folly::SemiFuture<
       std::pair<PskType, folly::Optional<ResumptionState>>>
   decrypt(std::unique_ptr<folly::IOBuf> encryptedTicket) const = 0;
+
+  /**
+   * Same as decrypt(), for ciphers that never need to wait for a result. This
+   * lets the server resume without allocating any futures.
+   *
+   * Returns none if the cipher can only decrypt asynchronously, in which case
+   * decrypt() is used instead.
+   */
+  virtual folly::Optional<std::pair<PskType, folly::Optional<ResumptionState>>>
+  decryptSync(const folly::IOBuf& /* encryptedTicket */) const {
+    return folly::none;
+  }
+
+  struct SyncOrAsyncResult {
+    // Set if the ticket was decrypted synchronously.
+    folly::Optional<std::pair<PskType, folly::Optional<ResumptionState>>>
+        result;
+    // Set otherwise.
+    folly::Optional<
+        folly::SemiFuture<std::pair<PskType, folly::Optional<ResumptionState>>>>
+        future;
+  };
+
+  /**
+   * Decrypts with decryptSync() if possible, and with decrypt() otherwise.
+   * This is what the server uses. Ciphers built from other ciphers override it
+   * so that work done synchronously is not repeated asynchronously.
+   */
+  virtual SyncOrAsyncResult decryptSyncOrAsync(
+      const folly::IOBuf& encryptedTicket) const {
+    SyncOrAsyncResult res;
+    res.result = decryptSync(encryptedTicket);
+    if (!res.result) {
+      res.future = decrypt(encryptedTicket.clone());
+    }
+    return res;
+  }
 };
 } // namespace server
 } // namespace fizz
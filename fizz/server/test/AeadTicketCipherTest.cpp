@@ -288,6 +288,19 @@ TEST_F(AeadTicketCipherTest, TestDecryptSecond) {
   EXPECT_TRUE(result.second.has_value());
 }
 
+TEST_F(AeadTicketCipherTest, TestDecryptSync) {
+  rebuildCipher();
+  expectDecode();
+  auto result = cipher_.decryptSync(*toIOBuf(ticket1));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->first, PskType::Resumption);
+  EXPECT_TRUE(result->second.has_value());
+
+  result = cipher_.decryptSync(*toIOBuf(badTicket));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->first, PskType::Rejected);
+}
+
 TEST_F(AeadTicketCipherTest, TestDecryptWithContext) {
   rebuildCipher("foobar");
   expectDecode();
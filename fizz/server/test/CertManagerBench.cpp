@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/init/Init.h>
+
+#include <fizz/protocol/test/Mocks.h>
+#include <fizz/server/CertManager.h>
+
+using namespace fizz;
+using namespace fizz::test;
+
+namespace {
+
+const std::vector<SignatureScheme> kSupportedSchemes{
+    SignatureScheme::ecdsa_secp256r1_sha256,
+    SignatureScheme::rsa_pss_sha256};
+const std::vector<SignatureScheme> kPeerSchemes{
+    SignatureScheme::rsa_pss_sha256};
+
+std::shared_ptr<SelfCert> makeCert(std::string identity) {
+  auto cert = std::make_shared<NiceMock<MockSelfCert>>();
+  ON_CALL(*cert, getIdentity()).WillByDefault(Return(identity));
+  ON_CALL(*cert, getAltIdentities())
+      .WillByDefault(Return(std::vector<std::string>{}));
+  ON_CALL(*cert, getSigSchemes())
+      .WillByDefault(Return(std::vector<SignatureScheme>{
+          SignatureScheme::ecdsa_secp256r1_sha256,
+          SignatureScheme::rsa_pss_sha256}));
+  return cert;
+}
+
+// Half of the certs are exact names, the other half wildcards.
+std::unique_ptr<server::CertManager> makeCertManager(size_t numCerts) {
+  auto manager = std::make_unique<server::CertManager>();
+  manager->addCertAndSetDefault(makeCert("default.example.com"));
+  for (size_t i = 0; i < numCerts; ++i) {
+    if (i % 2 == 0) {
+      manager->addCert(makeCert(folly::sformat("host{}.example.com", i)));
+    } else {
+      manager->addCert(makeCert(folly::sformat("*.domain{}.example.net", i)));
+    }
+  }
+  return manager;
+}
+
+std::vector<folly::Optional<std::string>> makeSnis(size_t numCerts) {
+  std::vector<folly::Optional<std::string>> snis;
+  for (size_t i = 0; i < numCerts; i += 7) {
+    if (i % 2 == 0) {
+      snis.emplace_back(folly::sformat("HOST{}.example.com", i));
+    } else {
+      snis.emplace_back(folly::sformat("www.domain{}.example.net", i));
+    }
+    snis.emplace_back(folly::sformat("unknown{}.example.org", i));
+  }
+  return snis;
+}
+
+void getCertBySni(uint32_t n, size_t numCerts) {
+  std::unique_ptr<server::CertManager> manager;
+  std::vector<folly::Optional<std::string>> snis;
+  BENCHMARK_SUSPEND {
+    manager = makeCertManager(numCerts);
+    snis = makeSnis(numCerts);
+  }
+  for (uint32_t i = 0; i < n; ++i) {
+    auto res = manager->getCert(
+        snis[i % snis.size()], kSupportedSchemes, kPeerSchemes, {});
+    folly::doNotOptimizeAway(res);
+  }
+}
+
+void getCertByIdentity(uint32_t n, size_t numCerts) {
+  std::unique_ptr<server::CertManager> manager;
+  std::vector<std::string> identities;
+  BENCHMARK_SUSPEND {
+    manager = makeCertManager(numCerts);
+    for (size_t i = 0; i < numCerts; i += 14) {
+      identities.push_back(folly::sformat("host{}.example.com", i));
+    }
+  }
+  for (uint32_t i = 0; i < n; ++i) {
+    auto res = manager->getCert(identities[i % identities.size()]);
+    folly::doNotOptimizeAway(res);
+  }
+}
+} // namespace
+
+BENCHMARK_PARAM(getCertBySni, 100);
+BENCHMARK_PARAM(getCertBySni, 10000);
+BENCHMARK_PARAM(getCertBySni, 100000);
+
+BENCHMARK_PARAM(getCertByIdentity, 100);
+BENCHMARK_PARAM(getCertByIdentity, 100000);
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
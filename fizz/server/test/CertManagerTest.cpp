@@ -184,6 +184,16 @@ TEST_F(CertManagerTest, TestNoWildcard) {
       manager_.getCert(std::string("test.com"), kRsa, kRsa, {}).hasValue());
 }
 
+TEST_F(CertManagerTest, TestLongSni) {
+  std::string longName(300, 'a');
+  auto cert = getCert("*.test.com", {}, kRsa);
+  manager_.addCert(cert);
+
+  auto res = manager_.getCert(longName + ".TEST.com", kRsa, kRsa, {});
+  EXPECT_EQ(res->cert, cert);
+  EXPECT_EQ(res->type, CertManager::MatchType::Direct);
+}
+
 TEST_F(CertManagerTest, TestGetByIdentity) {
   auto cert = getCert("*.test.com", {"www.example.com"}, kRsa);
   manager_.addCert(cert);
@@ -194,6 +204,21 @@ TEST_F(CertManagerTest, TestGetByIdentity) {
   EXPECT_EQ(manager_.getCert("www.blah.com"), nullptr);
 }
 
+TEST_F(CertManagerTest, TestGetByIdentityHash) {
+  auto cert = getCert("*.test.com", {"www.example.com"}, kRsa);
+  manager_.addCert(cert);
+
+  EXPECT_EQ(
+      manager_.getCertByIdentityHash(
+          CertManager::getIdentityHash("*.test.com")),
+      cert);
+  EXPECT_EQ(
+      manager_.getCertByIdentityHash(
+          CertManager::getIdentityHash("www.example.com")),
+      nullptr);
+  EXPECT_EQ(manager_.getCertByIdentityHash(0), nullptr);
+}
+
 TEST_F(CertManagerTest, TestDN) {
   // This test is largely the same as TestGetByIdentity, but it is asserting
   // that we should not be relying on Certificate::getIdentity() to return a
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/io/async/ssl/OpenSSLTransportCertificate.h>
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+
+#include <fizz/server/CompactTicketCodec.h>
+
+#include <fizz/crypto/test/TestUtil.h>
+#include <fizz/protocol/DefaultFactory.h>
+#include <fizz/protocol/test/Mocks.h>
+#include <fizz/server/test/Mocks.h>
+
+static constexpr folly::StringPiece compactTicketNoServerCert{
+    "0103041301444444440000000000000019000000000000000f000000000000000006020000736563726574683200"};
+
+namespace fizz {
+namespace server {
+namespace test {
+
+using Codec = CompactTicketCodec<CertificateStorage::X509>;
+
+static ResumptionState getTestResumptionState(
+    std::shared_ptr<SelfCert> cert,
+    std::shared_ptr<PeerCert> peerCert) {
+  ResumptionState rs;
+  rs.version = ProtocolVersion::tls_1_3;
+  rs.cipher = CipherSuite::TLS_AES_128_GCM_SHA256;
+  rs.resumptionSecret = folly::IOBuf::copyBuffer("secret");
+  rs.serverCert = cert;
+  rs.clientCert = peerCert;
+  rs.ticketAgeAdd = 0x44444444;
+  rs.ticketIssueTime = std::chrono::time_point<std::chrono::system_clock>(
+      std::chrono::seconds(25));
+  rs.alpn = "h2";
+  rs.handshakeTime = std::chrono::time_point<std::chrono::system_clock>(
+      std::chrono::seconds(15));
+  return rs;
+}
+
+static void expectCommonFields(const ResumptionState& rs) {
+  EXPECT_EQ(rs.version, ProtocolVersion::tls_1_3);
+  EXPECT_EQ(rs.cipher, CipherSuite::TLS_AES_128_GCM_SHA256);
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      rs.resumptionSecret, folly::IOBuf::copyBuffer("secret")));
+  EXPECT_EQ(rs.ticketAgeAdd, 0x44444444);
+  EXPECT_EQ(
+      rs.ticketIssueTime,
+      std::chrono::time_point<std::chrono::system_clock>(
+          std::chrono::seconds(25)));
+  EXPECT_EQ(
+      rs.handshakeTime,
+      std::chrono::time_point<std::chrono::system_clock>(
+          std::chrono::seconds(15)));
+}
+
+TEST(CompactTicketCodecTest, TestEncode) {
+  auto rs = getTestResumptionState(nullptr, nullptr);
+  auto encoded = Codec::encode(std::move(rs));
+  EXPECT_TRUE(
+      folly::IOBufEqualTo()(encoded, toIOBuf(compactTicketNoServerCert)));
+}
+
+TEST(CompactTicketCodecTest, TestDecode) {
+  DefaultFactory factory;
+  CertManager certManager;
+  auto rs = Codec::decode(
+      toIOBuf(compactTicketNoServerCert), factory, certManager);
+  expectCommonFields(rs);
+  EXPECT_EQ(*rs.alpn, "h2");
+  EXPECT_FALSE(rs.serverCert);
+  EXPECT_FALSE(rs.clientCert);
+  EXPECT_TRUE(rs.appToken->empty());
+}
+
+TEST(CompactTicketCodecTest, TestRoundTripServerCert) {
+  auto cert = std::make_shared<MockSelfCert>();
+  EXPECT_CALL(*cert, getIdentity()).WillRepeatedly(Return("ident"));
+  auto rs = getTestResumptionState(cert, nullptr);
+  rs.appToken = folly::IOBuf::copyBuffer("hello world");
+  rs.alpn = folly::none;
+  auto encoded = Codec::encode(std::move(rs));
+
+  DefaultFactory factory;
+  MockCertManager certManager;
+  EXPECT_CALL(
+      certManager,
+      getCertByIdentityHash(CertManager::getIdentityHash("ident")))
+      .WillOnce(Return(cert));
+  auto drs = Codec::decode(std::move(encoded), factory, certManager);
+  expectCommonFields(drs);
+  EXPECT_FALSE(drs.alpn.has_value());
+  EXPECT_EQ(drs.serverCert, cert);
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      drs.appToken, folly::IOBuf::copyBuffer("hello world")));
+}
+
+TEST(CompactTicketCodecTest, TestRoundTripClientAuthX509) {
+  auto peerCert = std::make_shared<MockPeerCert>();
+  EXPECT_CALL(*peerCert, getX509()).Times(2).WillRepeatedly(Invoke([]() {
+    return getCert(kRSACertificate);
+  }));
+  auto rs = getTestResumptionState(nullptr, peerCert);
+  auto encoded = Codec::encode(std::move(rs));
+
+  DefaultFactory factory;
+  CertManager certManager;
+  auto drs = Codec::decode(std::move(encoded), factory, certManager);
+  expectCommonFields(drs);
+  ASSERT_TRUE(drs.clientCert);
+  EXPECT_EQ(drs.clientCert->getIdentity(), "Fizz");
+}
+
+TEST(CompactTicketCodecTest, TestRoundTripClientAuthIdentityOnly) {
+  auto peerCert = std::make_shared<MockPeerCert>();
+  EXPECT_CALL(*peerCert, getIdentity()).WillRepeatedly(Return("clientid"));
+  auto rs = getTestResumptionState(nullptr, peerCert);
+  auto encoded = CompactTicketCodec<CertificateStorage::IdentityOnly>::encode(
+      std::move(rs));
+
+  DefaultFactory factory;
+  CertManager certManager;
+  auto drs = Codec::decode(std::move(encoded), factory, certManager);
+  expectCommonFields(drs);
+  ASSERT_TRUE(drs.clientCert);
+  EXPECT_EQ(drs.clientCert->getIdentity(), "clientid");
+}
+
+TEST(CompactTicketCodecTest, TestDecodeTooShort) {
+  DefaultFactory factory;
+  CertManager certManager;
+  auto buf = toIOBuf(compactTicketNoServerCert);
+  buf->trimEnd(1);
+  EXPECT_THROW(
+      Codec::decode(std::move(buf), factory, certManager), std::exception);
+}
+
+TEST(CompactTicketCodecTest, TestDecodeTrailingData) {
+  DefaultFactory factory;
+  CertManager certManager;
+  auto buf = toIOBuf(compactTicketNoServerCert);
+  buf->prependChain(folly::IOBuf::copyBuffer("x"));
+  EXPECT_THROW(
+      Codec::decode(std::move(buf), factory, certManager), std::exception);
+}
+
+TEST(CompactTicketCodecTest, TestDecodeWrongFormatVersion) {
+  DefaultFactory factory;
+  CertManager certManager;
+  auto buf = toIOBuf(compactTicketNoServerCert);
+  buf->writableData()[0] = 0x02;
+  EXPECT_THROW(
+      Codec::decode(std::move(buf), factory, certManager), std::exception);
+}
+
+TEST(CompactTicketCodecTest, TestDecodeLegacyTicket) {
+  auto cert = std::make_shared<MockSelfCert>();
+  EXPECT_CALL(*cert, getIdentity()).WillRepeatedly(Return("ident"));
+  auto encoded = TicketCodec<CertificateStorage::X509>::encode(
+      getTestResumptionState(cert, nullptr));
+  DefaultFactory factory;
+  CertManager certManager;
+  EXPECT_THROW(
+      Codec::decode(std::move(encoded), factory, certManager), std::exception);
+}
+} // namespace test
+} // namespace server
+} // namespace fizz
@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <fizz/crypto/RandomGenerator.h>
+#include <fizz/protocol/test/TestUtil.h>
+#include <fizz/record/Extensions.h>
+#include <fizz/server/AeadTokenCipher.h>
+#include <fizz/server/CookieTypes.h>
+#include <fizz/server/HmacCookieCipher.h>
+
+using namespace fizz;
+using namespace fizz::server;
+
+// Simulates a flood of ClientHellos that are all answered with a stateless
+// HelloRetryRequest, and the second ClientHellos that come back with a valid
+// or a forged cookie.
+
+namespace {
+
+const size_t kNumClientHellos = 1024;
+
+Buf makeClientHello(Buf cookie) {
+  auto chlo = fizz::test::TestMessages::clientHello();
+  chlo.random = RandomGenerator<32>().generateRandom();
+  if (cookie) {
+    Cookie c;
+    c.cookie = std::move(cookie);
+    chlo.extensions.push_back(encodeExtension(std::move(c)));
+  }
+  return PlaintextWriteRecordLayer()
+      .writeInitialClientHello(encodeHandshake(std::move(chlo)))
+      .data;
+}
+
+Buf getCookie(Buf retry) {
+  folly::IOBufQueue queue{folly::IOBufQueue::cacheChainLength()};
+  queue.append(std::move(retry));
+  auto msg = PlaintextReadRecordLayer().readEvent(queue, Aead::AeadOptions());
+  auto& hrr = *msg->asHelloRetryRequest();
+  return std::move(getExtension<Cookie>(hrr.extensions)->cookie);
+}
+
+const FizzServerContext* getContext() {
+  static auto context = [] {
+    auto ctx = std::make_shared<FizzServerContext>();
+    ctx->setSupportedVersions({ProtocolVersion::tls_1_3});
+    // The test ClientHello only has an x25519 share, so every ClientHello
+    // needs a retry to select a group.
+    ctx->setSupportedGroups({NamedGroup::secp256r1});
+    return ctx;
+  }();
+  return context.get();
+}
+
+const AES128CookieCipher& getAeadCipher() {
+  static auto cipher = [] {
+    auto c = std::make_unique<AES128CookieCipher>(
+        std::make_unique<Aead128GCMTokenCipher>(
+            std::vector<std::string>({"Fizz Cookie Cipher v1"})));
+    auto secret = RandomGenerator<32>().generateRandom();
+    c->setCookieSecrets({folly::range(secret)});
+    c->setContext(getContext());
+    return c;
+  }();
+  return *cipher;
+}
+
+const HmacCookieCipher& getHmacCipher() {
+  static auto cipher = [] {
+    auto c = std::make_unique<HmacCookieCipher>();
+    auto secret = RandomGenerator<32>().generateRandom();
+    c->setCookieSecrets({folly::range(secret)});
+    c->setContext(getContext());
+    return c;
+  }();
+  return *cipher;
+}
+
+template <class Cipher>
+void issueRetries(size_t iters, const Cipher& cipher) {
+  std::vector<Buf> chlos;
+  BENCHMARK_SUSPEND {
+    for (size_t i = 0; i < kNumClientHellos; i++) {
+      chlos.push_back(makeClientHello(nullptr));
+    }
+  }
+  for (size_t i = 0; i < iters; i++) {
+    auto res = cipher.getTokenOrRetry(
+        chlos[i % chlos.size()]->clone(), folly::IOBuf::copyBuffer("token"));
+    folly::doNotOptimizeAway(res);
+  }
+}
+
+template <class Cipher>
+std::vector<Buf> makeCookies(const Cipher& cipher, bool forged) {
+  std::vector<Buf> cookies;
+  for (size_t i = 0; i < kNumClientHellos; i++) {
+    auto res = cipher.getTokenOrRetry(
+        makeClientHello(nullptr), folly::IOBuf::copyBuffer("token"));
+    auto cookie =
+        getCookie(std::move(boost::get<StatelessHelloRetryRequest>(res).data));
+    if (forged) {
+      cookie->unshare();
+      cookie->coalesce();
+      cookie->writableData()[cookie->length() - 1] ^= 0x01;
+    }
+    cookies.push_back(std::move(cookie));
+  }
+  return cookies;
+}
+
+template <class Cipher>
+void acceptCookies(size_t iters, const Cipher& cipher) {
+  std::vector<Buf> chlos;
+  BENCHMARK_SUSPEND {
+    for (auto& cookie : makeCookies(cipher, false)) {
+      chlos.push_back(makeClientHello(std::move(cookie)));
+    }
+  }
+  for (size_t i = 0; i < iters; i++) {
+    auto res = cipher.getTokenOrRetry(
+        chlos[i % chlos.size()]->clone(), folly::IOBuf::copyBuffer("token"));
+    folly::doNotOptimizeAway(res);
+  }
+}
+
+template <class Cipher>
+void rejectCookies(size_t iters, const Cipher& cipher) {
+  std::vector<Buf> cookies;
+  BENCHMARK_SUSPEND {
+    cookies = makeCookies(cipher, true);
+  }
+  for (size_t i = 0; i < iters; i++) {
+    auto state = cipher.decrypt(cookies[i % cookies.size()]->clone());
+    folly::doNotOptimizeAway(state);
+  }
+}
+} // namespace
+
+BENCHMARK(IssueRetryAead, iters) {
+  issueRetries(iters, getAeadCipher());
+}
+
+BENCHMARK_RELATIVE(IssueRetryHmac, iters) {
+  issueRetries(iters, getHmacCipher());
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(AcceptCookieAead, iters) {
+  acceptCookies(iters, getAeadCipher());
+}
+
+BENCHMARK_RELATIVE(AcceptCookieHmac, iters) {
+  acceptCookies(iters, getHmacCipher());
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(RejectForgedCookieAead, iters) {
+  rejectCookies(iters, getAeadCipher());
+}
+
+BENCHMARK_RELATIVE(RejectForgedCookieHmac, iters) {
+  rejectCookies(iters, getHmacCipher());
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
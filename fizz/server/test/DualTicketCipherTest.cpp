@@ -71,6 +71,95 @@ TEST(DualCipherTest, DecryptSuccessWithFallback) {
       std::get<0>(dualCipher.decrypt(std::move(buf)).get()),
       PskType::Resumption);
 }
+
+TEST(DualCipherTest, DecryptSyncWithFallback) {
+  auto cipher = std::make_unique<MockTicketCipher>();
+  auto fallbackCipher = std::make_unique<MockTicketCipher>();
+
+  EXPECT_CALL(*cipher, decryptSync(_)).WillOnce(InvokeWithoutArgs([]() {
+    return folly::make_optional(
+        std::pair<PskType, folly::Optional<ResumptionState>>(
+            PskType::Rejected, folly::none));
+  }));
+  EXPECT_CALL(*fallbackCipher, decryptSync(_)).WillOnce(InvokeWithoutArgs([]() {
+    return folly::make_optional(
+        std::pair<PskType, folly::Optional<ResumptionState>>(
+            PskType::Resumption, ResumptionState()));
+  }));
+
+  auto dualCipher =
+      DualTicketCipher(std::move(cipher), std::move(fallbackCipher));
+  auto buf =
+      folly::IOBuf::wrapBuffer(folly::ByteRange(folly::StringPiece("ss")));
+  auto result = dualCipher.decryptSync(*buf);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->first, PskType::Resumption);
+}
+
+TEST(DualCipherTest, DecryptSyncAsyncCipher) {
+  auto cipher = std::make_unique<MockTicketCipher>();
+  auto fallbackCipher = std::make_unique<MockTicketCipher>();
+
+  EXPECT_CALL(*cipher, decryptSync(_)).WillOnce(Return(folly::none));
+  EXPECT_CALL(*fallbackCipher, decryptSync(_)).Times(0);
+
+  auto dualCipher =
+      DualTicketCipher(std::move(cipher), std::move(fallbackCipher));
+  auto buf =
+      folly::IOBuf::wrapBuffer(folly::ByteRange(folly::StringPiece("ss")));
+  EXPECT_FALSE(dualCipher.decryptSync(*buf).has_value());
+}
+
+TEST(DualCipherTest, DecryptSyncOrAsyncRejectedThenAsyncFallback) {
+  auto cipher = std::make_unique<MockTicketCipher>();
+  auto fallbackCipher = std::make_unique<MockTicketCipher>();
+
+  EXPECT_CALL(*cipher, decryptSync(_)).WillOnce(InvokeWithoutArgs([]() {
+    return folly::make_optional(
+        std::pair<PskType, folly::Optional<ResumptionState>>(
+            PskType::Rejected, folly::none));
+  }));
+  // The primary cipher already rejected the ticket, so it is not run again.
+  EXPECT_CALL(*cipher, _decrypt(_)).Times(0);
+  EXPECT_CALL(*fallbackCipher, decryptSync(_)).WillOnce(Return(folly::none));
+  EXPECT_CALL(*fallbackCipher, _decrypt(_)).WillOnce(InvokeWithoutArgs([]() {
+    ResumptionState res;
+    return std::make_pair(PskType::Resumption, std::move(res));
+  }));
+
+  auto dualCipher =
+      DualTicketCipher(std::move(cipher), std::move(fallbackCipher));
+  auto buf =
+      folly::IOBuf::wrapBuffer(folly::ByteRange(folly::StringPiece("ss")));
+  auto result = dualCipher.decryptSyncOrAsync(*buf);
+  EXPECT_FALSE(result.result.has_value());
+  ASSERT_TRUE(result.future.has_value());
+  EXPECT_EQ(std::move(*result.future).get().first, PskType::Resumption);
+}
+
+TEST(DualCipherTest, DecryptSyncOrAsyncAsyncCipher) {
+  auto cipher = std::make_unique<MockTicketCipher>();
+  auto fallbackCipher = std::make_unique<MockTicketCipher>();
+
+  EXPECT_CALL(*cipher, decryptSync(_)).WillOnce(Return(folly::none));
+  EXPECT_CALL(*cipher, _decrypt(_)).WillOnce(InvokeWithoutArgs([]() {
+    ResumptionState res;
+    return std::make_pair(PskType::Rejected, std::move(res));
+  }));
+  EXPECT_CALL(*fallbackCipher, decryptSync(_)).Times(0);
+  EXPECT_CALL(*fallbackCipher, _decrypt(_)).WillOnce(InvokeWithoutArgs([]() {
+    ResumptionState res;
+    return std::make_pair(PskType::Resumption, std::move(res));
+  }));
+
+  auto dualCipher =
+      DualTicketCipher(std::move(cipher), std::move(fallbackCipher));
+  auto buf =
+      folly::IOBuf::wrapBuffer(folly::ByteRange(folly::StringPiece("ss")));
+  auto result = dualCipher.decryptSyncOrAsync(*buf);
+  ASSERT_TRUE(result.future.has_value());
+  EXPECT_EQ(std::move(*result.future).get().first, PskType::Resumption);
+}
 } // namespace test
 } // namespace server
 } // namespace fizz
@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+
+#include <fizz/server/FizzServerContextStore.h>
+
+#include <thread>
+
+namespace fizz {
+namespace server {
+namespace test {
+
+TEST(FizzServerContextStoreTest, TestGet) {
+  auto context = std::make_shared<FizzServerContext>();
+  FizzServerContextStore store(context);
+  EXPECT_EQ(store.getVersion(), 1);
+  EXPECT_EQ(store.get(), context);
+  EXPECT_EQ(&store.get(), &store.get());
+}
+
+TEST(FizzServerContextStoreTest, TestPublish) {
+  auto context = std::make_shared<FizzServerContext>();
+  FizzServerContextStore store(context);
+  auto snapshot = store.get();
+
+  auto next = std::make_shared<FizzServerContext>();
+  EXPECT_EQ(store.publish(next), 2);
+  EXPECT_EQ(store.get(), next);
+  EXPECT_EQ(snapshot, context);
+}
+
+TEST(FizzServerContextStoreTest, TestPublishNull) {
+  FizzServerContextStore store(std::make_shared<FizzServerContext>());
+  EXPECT_THROW(store.publish(nullptr), std::runtime_error);
+  EXPECT_EQ(store.getVersion(), 1);
+}
+
+TEST(FizzServerContextStoreTest, TestUpdate) {
+  auto context = std::make_shared<FizzServerContext>();
+  context->setSupportedAlpns({"h2"});
+  FizzServerContextStore store(context);
+  auto snapshot = store.get();
+
+  auto version = store.update([](auto current) {
+    auto ctx = std::make_shared<FizzServerContext>(*current);
+    ctx->setSendNewSessionTicket(false);
+    return ctx;
+  });
+  EXPECT_EQ(version, 2);
+
+  auto& updated = store.get();
+  EXPECT_NE(updated, snapshot);
+  EXPECT_FALSE(updated->getSendNewSessionTicket());
+  EXPECT_EQ(updated->getSupportedAlpns(), std::vector<std::string>{"h2"});
+  EXPECT_TRUE(snapshot->getSendNewSessionTicket());
+}
+
+TEST(FizzServerContextStoreTest, TestUpdateSubclass) {
+  class TestContext : public FizzServerContext {
+   public:
+    int generation{0};
+  };
+  FizzServerContextStore store(std::make_shared<TestContext>());
+
+  store.update([](auto current) {
+    auto ctx = std::make_shared<TestContext>(
+        dynamic_cast<const TestContext&>(*current));
+    ctx->generation++;
+    return ctx;
+  });
+
+  auto updated = std::dynamic_pointer_cast<const TestContext>(store.get());
+  ASSERT_TRUE(updated);
+  EXPECT_EQ(updated->generation, 1);
+}
+
+TEST(FizzServerContextStoreTest, TestUpdateNull) {
+  FizzServerContextStore store(std::make_shared<FizzServerContext>());
+  EXPECT_THROW(
+      store.update([](auto) { return nullptr; }), std::runtime_error);
+  EXPECT_EQ(store.getVersion(), 1);
+}
+
+TEST(FizzServerContextStoreTest, TestConcurrentReaders) {
+  FizzServerContextStore store(std::make_shared<FizzServerContext>());
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (size_t i = 0; i < 4; i++) {
+    readers.emplace_back([&] {
+      uint64_t lastVersion = 0;
+      while (!done.load()) {
+        auto version = store.getVersion();
+        auto& context = store.get();
+        EXPECT_TRUE(context);
+        EXPECT_GE(version, lastVersion);
+        lastVersion = version;
+      }
+    });
+  }
+  for (size_t i = 0; i < 100; i++) {
+    store.update([](auto current) {
+      auto ctx = std::make_shared<FizzServerContext>(*current);
+      ctx->setMaxEarlyDataSize(ctx->getMaxEarlyDataSize() - 1);
+      return ctx;
+    });
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(store.getVersion(), 101);
+  EXPECT_EQ(
+      store.get()->getMaxEarlyDataSize(),
+      std::numeric_limits<uint32_t>::max() - 100);
+}
+} // namespace test
+} // namespace server
+} // namespace fizz
@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+
+#include <fizz/server/HmacCookieCipher.h>
+
+#include <fizz/crypto/RandomGenerator.h>
+#include <fizz/crypto/test/TestUtil.h>
+#include <fizz/protocol/test/TestUtil.h>
+
+using namespace fizz::test;
+using namespace testing;
+
+static constexpr folly::StringPiece secret{
+    "c44ed3fb98c179579036d201735f43af20a856470b9c527fe07f01f3a2a0bde9"};
+
+namespace fizz {
+namespace server {
+namespace test {
+
+class HmacCookieCipherTest : public Test {
+ public:
+  void SetUp() override {
+    context_ = std::make_shared<FizzServerContext>();
+    context_->setSupportedVersions({ProtocolVersion::tls_1_3});
+    cipher_ = std::make_shared<HmacCookieCipher>();
+    cipher_->setContext(context_.get());
+
+    auto s = toIOBuf(secret);
+    std::vector<folly::ByteRange> cookieSecrets{{s->coalesce()}};
+    EXPECT_TRUE(cipher_->setCookieSecrets(std::move(cookieSecrets)));
+  }
+
+ protected:
+  ClientHello getChlo(Buf cookie) {
+    auto chlo = TestMessages::clientHello();
+
+    if (cookie) {
+      Cookie c;
+      c.cookie = std::move(cookie);
+      chlo.extensions.push_back(encodeExtension(std::move(c)));
+    }
+    return chlo;
+  }
+
+  Buf getClientHello(Buf cookie) {
+    return PlaintextWriteRecordLayer()
+        .writeInitialClientHello(encodeHandshake(getChlo(std::move(cookie))))
+        .data;
+  }
+
+  CookieState getState() {
+    CookieState state;
+    state.version = ProtocolVersion::tls_1_3;
+    state.cipher = CipherSuite::TLS_AES_128_GCM_SHA256;
+    state.group = NamedGroup::secp256r1;
+    state.chloHash = folly::IOBuf::copyBuffer("chlohash");
+    state.appToken = folly::IOBuf::copyBuffer("test");
+    return state;
+  }
+
+  std::shared_ptr<FizzServerContext> context_;
+  std::shared_ptr<HmacCookieCipher> cipher_;
+};
+
+TEST_F(HmacCookieCipherTest, TestEncodeDecrypt) {
+  auto cookie = cipher_->encode(getState());
+  auto state = cipher_->decrypt(std::move(cookie));
+  ASSERT_TRUE(state.has_value());
+  EXPECT_EQ(state->version, ProtocolVersion::tls_1_3);
+  EXPECT_EQ(state->cipher, CipherSuite::TLS_AES_128_GCM_SHA256);
+  EXPECT_EQ(*state->group, NamedGroup::secp256r1);
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      state->chloHash, folly::IOBuf::copyBuffer("chlohash")));
+  EXPECT_TRUE(
+      folly::IOBufEqualTo()(state->appToken, folly::IOBuf::copyBuffer("test")));
+  EXPECT_FALSE(state->echCipherSuite.has_value());
+  EXPECT_FALSE(state->echConfigId.has_value());
+}
+
+TEST_F(HmacCookieCipherTest, TestEncodeDecryptNoGroup) {
+  auto cookieState = getState();
+  cookieState.group = folly::none;
+  cookieState.appToken = nullptr;
+  auto state = cipher_->decrypt(cipher_->encode(cookieState));
+  ASSERT_TRUE(state.has_value());
+  EXPECT_FALSE(state->group.has_value());
+  EXPECT_TRUE(state->appToken->empty());
+}
+
+TEST_F(HmacCookieCipherTest, TestEncodeEch) {
+  auto state = getState();
+  state.echCipherSuite = ech::HpkeSymmetricCipherSuite{
+      hpke::KDFId::Sha256, hpke::AeadId::TLS_AES_128_GCM_SHA256};
+  state.echConfigId = 0xFB;
+  state.echEnc = folly::IOBuf::copyBuffer("enc");
+  EXPECT_THROW(cipher_->encode(state), std::runtime_error);
+}
+
+TEST_F(HmacCookieCipherTest, TestValidateTampered) {
+  auto cookie = cipher_->encode(getState());
+  auto range = cookie->coalesce();
+  EXPECT_TRUE(cipher_->validate(range));
+
+  for (size_t i = 0; i < range.size(); i++) {
+    auto tampered = cookie->clone();
+    tampered->unshare();
+    tampered->writableData()[i] ^= 0x01;
+    EXPECT_FALSE(cipher_->validate(tampered->coalesce()));
+  }
+
+  EXPECT_FALSE(cipher_->validate(range.subpiece(1)));
+  EXPECT_FALSE(cipher_->validate(range.subpiece(0, range.size() - 1)));
+  EXPECT_FALSE(cipher_->validate(folly::ByteRange()));
+}
+
+TEST_F(HmacCookieCipherTest, TestGetRetry) {
+  auto res = cipher_->getTokenOrRetry(
+      getClientHello(nullptr), folly::IOBuf::copyBuffer("test"));
+  auto msg = std::move(boost::get<StatelessHelloRetryRequest>(res));
+
+  auto state = getCookieState(
+      *context_->getFactory(),
+      context_->getSupportedVersions(),
+      context_->getSupportedCiphers(),
+      context_->getSupportedGroups(),
+      getChlo(nullptr),
+      folly::IOBuf::copyBuffer("test"));
+  auto expected = PlaintextWriteRecordLayer()
+                      .writeHandshake(getStatelessHelloRetryRequest(
+                          state.version,
+                          state.cipher,
+                          state.group,
+                          cipher_->encode(state)))
+                      .data;
+  EXPECT_TRUE(folly::IOBufEqualTo()(msg.data, expected));
+}
+
+TEST_F(HmacCookieCipherTest, TestGetToken) {
+  auto res = cipher_->getTokenOrRetry(
+      getClientHello(cipher_->encode(getState())),
+      folly::IOBuf::copyBuffer("xx"));
+  auto token = std::move(boost::get<AppToken>(res));
+  EXPECT_TRUE(
+      folly::IOBufEqualTo()(token.token, folly::IOBuf::copyBuffer("test")));
+}
+
+TEST_F(HmacCookieCipherTest, TestGetTokenInvalid) {
+  EXPECT_THROW(
+      cipher_->getTokenOrRetry(
+          getClientHello(folly::IOBuf::copyBuffer("junk")),
+          folly::IOBuf::copyBuffer("xx")),
+      std::runtime_error);
+}
+
+TEST_F(HmacCookieCipherTest, TestSecretTooShort) {
+  auto s = RandomGenerator<16>().generateRandom();
+  std::vector<folly::ByteRange> cookieSecrets{{folly::range(s)}};
+  EXPECT_FALSE(cipher_->setCookieSecrets(std::move(cookieSecrets)));
+
+  // The old secret is still in use.
+  EXPECT_TRUE(cipher_->decrypt(cipher_->encode(getState())).has_value());
+}
+
+TEST_F(HmacCookieCipherTest, TestDecryptMultipleSecrets) {
+  auto cookie = cipher_->encode(getState());
+
+  auto s = toIOBuf(secret);
+  auto s1 = RandomGenerator<32>().generateRandom();
+  std::vector<folly::ByteRange> cookieSecrets{
+      {folly::range(s1), s->coalesce()}};
+  EXPECT_TRUE(cipher_->setCookieSecrets(std::move(cookieSecrets)));
+  EXPECT_TRUE(cipher_->decrypt(cookie->clone()).has_value());
+
+  // New cookies use the first secret.
+  auto newCookie = cipher_->encode(getState());
+  EXPECT_FALSE(folly::IOBufEqualTo()(cookie, newCookie));
+
+  std::vector<folly::ByteRange> rotatedSecrets{{folly::range(s1)}};
+  EXPECT_TRUE(cipher_->setCookieSecrets(std::move(rotatedSecrets)));
+  EXPECT_FALSE(cipher_->decrypt(std::move(cookie)).has_value());
+  EXPECT_TRUE(cipher_->decrypt(std::move(newCookie)).has_value());
+}
+} // namespace test
+} // namespace server
+} // namespace fizz
@@ -16,6 +16,7 @@
 #include <fizz/record/test/Mocks.h>
 #include <fizz/server/AsyncFizzServer.h>
 #include <fizz/server/AsyncSelfCert.h>
+#include <fizz/server/ClientHelloFilter.h>
 #include <fizz/server/CookieCipher.h>
 #include <fizz/server/ReplayCache.h>
 #include <fizz/server/ServerExtensions.h>
@@ -123,20 +124,32 @@ class MockTicketCipher : public TicketCipher {
     return _decrypt(encryptedTicket);
   }
 
+  MOCK_METHOD(
+      (folly::Optional<std::pair<PskType, folly::Optional<ResumptionState>>>),
+      decryptSync,
+      (const folly::IOBuf& encryptedTicket),
+      (const));
+
+  static ResumptionState getDefaultResumptionState(
+      std::chrono::system_clock::time_point ticketIssued) {
+    ResumptionState res;
+    res.version = ProtocolVersion::tls_1_3;
+    res.cipher = CipherSuite::TLS_AES_128_GCM_SHA256;
+    res.resumptionSecret = folly::IOBuf::copyBuffer("resumesecret");
+    res.alpn = "h2";
+    res.ticketAgeAdd = 0;
+    res.ticketIssueTime = ticketIssued;
+    res.handshakeTime = ticketIssued;
+    return res;
+  }
+
   void setDefaults(
       std::chrono::system_clock::time_point ticketIssued =
           std::chrono::system_clock::now()) {
     ON_CALL(*this, _decrypt(_))
         .WillByDefault(InvokeWithoutArgs([ticketIssued]() {
-          ResumptionState res;
-          res.version = ProtocolVersion::tls_1_3;
-          res.cipher = CipherSuite::TLS_AES_128_GCM_SHA256;
-          res.resumptionSecret = folly::IOBuf::copyBuffer("resumesecret");
-          res.alpn = "h2";
-          res.ticketAgeAdd = 0;
-          res.ticketIssueTime = ticketIssued;
-          res.handshakeTime = ticketIssued;
-          return std::make_pair(PskType::Resumption, std::move(res));
+          return std::make_pair(
+              PskType::Resumption, getDefaultResumptionState(ticketIssued));
         }));
     ON_CALL(*this, _encrypt(_)).WillByDefault(InvokeWithoutArgs([]() {
       return std::make_pair(
@@ -234,6 +247,11 @@ class MockCertManager : public CertManager {
       getCert,
       (const std::string& identity),
       (const));
+  MOCK_METHOD(
+      std::shared_ptr<SelfCert>,
+      getCertByIdentityHash,
+      (uint64_t identityHash),
+      (const));
 };
 
 class MockServerExtensions : public ServerExtensions {
@@ -247,6 +265,15 @@ class MockReplayCache : public ReplayCache {
       folly::SemiFuture<ReplayCacheResult>,
       check,
       (std::unique_ptr<folly::IOBuf>));
+  MOCK_METHOD(
+      folly::Optional<ReplayCacheResult>,
+      checkSync,
+      (folly::ByteRange));
+};
+
+class MockClientHelloFilter : public ClientHelloFilter {
+ public:
+  MOCK_METHOD(ClientHelloFilterResult, filter, (const ClientHelloInfo&));
 };
 
 class MockAppTokenValidator : public AppTokenValidator {
@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+
+#include <fizz/server/OffloadAsyncSelfCert.h>
+
+#include <fizz/protocol/test/Matchers.h>
+#include <fizz/protocol/test/Mocks.h>
+#include <folly/executors/ManualExecutor.h>
+
+using namespace fizz::test;
+
+namespace fizz {
+namespace server {
+namespace test {
+
+class OffloadAsyncSelfCertTest : public Test {
+ public:
+  void SetUp() override {
+    signer_ = std::make_shared<MockSelfCert>();
+    executor_ = std::make_shared<folly::ManualExecutor>();
+  }
+
+ protected:
+  std::unique_ptr<OffloadAsyncSelfCert> makeCert(
+      OffloadAsyncSelfCert::Options options = {}) {
+    return std::make_unique<OffloadAsyncSelfCert>(
+        signer_, executor_, std::move(options));
+  }
+
+  folly::SemiFuture<folly::Optional<Buf>> sign(
+      const OffloadAsyncSelfCert& cert) {
+    return cert.signFuture(
+        SignatureScheme::ecdsa_secp256r1_sha256,
+        CertificateVerifyContext::Server,
+        folly::IOBuf::copyBuffer("tbs"));
+  }
+
+  std::shared_ptr<MockSelfCert> signer_;
+  std::shared_ptr<folly::ManualExecutor> executor_;
+};
+
+TEST_F(OffloadAsyncSelfCertTest, TestDelegates) {
+  auto cert = makeCert();
+  EXPECT_CALL(*signer_, getIdentity()).WillOnce(Return("id"));
+  EXPECT_EQ(cert->getIdentity(), "id");
+  EXPECT_CALL(*signer_, getSigSchemes())
+      .WillOnce(Return(std::vector<SignatureScheme>{
+          SignatureScheme::ecdsa_secp256r1_sha256}));
+  EXPECT_EQ(
+      cert->getSigSchemes(),
+      std::vector<SignatureScheme>{SignatureScheme::ecdsa_secp256r1_sha256});
+}
+
+TEST_F(OffloadAsyncSelfCertTest, TestSignOnExecutor) {
+  auto cert = makeCert();
+  auto future = sign(*cert);
+  EXPECT_FALSE(future.isReady());
+  EXPECT_EQ(cert->getPendingSignatures(), 1);
+
+  EXPECT_CALL(
+      *signer_,
+      sign(
+          SignatureScheme::ecdsa_secp256r1_sha256,
+          CertificateVerifyContext::Server,
+          RangeMatches("tbs")))
+      .WillOnce(InvokeWithoutArgs(
+          []() { return folly::IOBuf::copyBuffer("sig"); }));
+  executor_->drain();
+
+  auto sig = std::move(future).get();
+  EXPECT_TRUE(folly::IOBufEqualTo()(*sig, folly::IOBuf::copyBuffer("sig")));
+  EXPECT_EQ(cert->getPendingSignatures(), 0);
+  auto stats = cert->getStats();
+  EXPECT_EQ(stats.offloaded, 1);
+  EXPECT_EQ(stats.signedInline, 0);
+  EXPECT_EQ(stats.failed, 0);
+}
+
+TEST_F(OffloadAsyncSelfCertTest, TestSignFailure) {
+  auto cert = makeCert();
+  auto future = sign(*cert);
+  EXPECT_CALL(*signer_, sign(_, _, _))
+      .WillOnce(Throw(std::runtime_error("no key")));
+  executor_->drain();
+  EXPECT_THROW(std::move(future).get(), std::runtime_error);
+  EXPECT_EQ(cert->getStats().failed, 1);
+  EXPECT_EQ(cert->getPendingSignatures(), 0);
+}
+
+TEST_F(OffloadAsyncSelfCertTest, TestQueueFullSignInline) {
+  OffloadAsyncSelfCert::Options options;
+  options.maxPendingSignatures = 1;
+  auto cert = makeCert(std::move(options));
+
+  auto queued = sign(*cert);
+  EXPECT_CALL(*signer_, sign(_, _, _)).WillOnce(InvokeWithoutArgs([]() {
+    return folly::IOBuf::copyBuffer("inline");
+  }));
+  auto inlineSig = sign(*cert);
+  EXPECT_TRUE(inlineSig.isReady());
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      *std::move(inlineSig).get(), folly::IOBuf::copyBuffer("inline")));
+  EXPECT_FALSE(queued.isReady());
+
+  auto stats = cert->getStats();
+  EXPECT_EQ(stats.offloaded, 1);
+  EXPECT_EQ(stats.signedInline, 1);
+  EXPECT_EQ(stats.rejected, 0);
+
+  EXPECT_CALL(*signer_, sign(_, _, _)).WillOnce(InvokeWithoutArgs([]() {
+    return folly::IOBuf::copyBuffer("sig");
+  }));
+  executor_->drain();
+  EXPECT_TRUE(queued.isReady());
+}
+
+TEST_F(OffloadAsyncSelfCertTest, TestQueueFullSignInlineThrows) {
+  OffloadAsyncSelfCert::Options options;
+  options.maxPendingSignatures = 1;
+  auto cert = makeCert(std::move(options));
+
+  auto queued = sign(*cert);
+  EXPECT_CALL(*signer_, sign(_, _, _))
+      .WillOnce(Throw(std::runtime_error("sign failed")));
+  // The failure is reported through the future rather than thrown.
+  auto inlineSig = sign(*cert);
+  EXPECT_TRUE(inlineSig.isReady());
+  EXPECT_THROW(std::move(inlineSig).get(), std::runtime_error);
+
+  EXPECT_CALL(*signer_, sign(_, _, _)).WillOnce(InvokeWithoutArgs([]() {
+    return folly::IOBuf::copyBuffer("sig");
+  }));
+  executor_->drain();
+  EXPECT_TRUE(queued.isReady());
+}
+
+TEST_F(OffloadAsyncSelfCertTest, TestQueueFullReject) {
+  OffloadAsyncSelfCert::Options options;
+  options.maxPendingSignatures = 1;
+  options.signInlineWhenFull = false;
+  auto cert = makeCert(std::move(options));
+
+  auto queued = sign(*cert);
+  auto rejected = sign(*cert);
+  EXPECT_THROW(std::move(rejected).get(), FizzException);
+  EXPECT_EQ(cert->getStats().rejected, 1);
+  EXPECT_EQ(cert->getStats().signedInline, 0);
+
+  EXPECT_CALL(*signer_, sign(_, _, _)).WillOnce(InvokeWithoutArgs([]() {
+    return folly::IOBuf::copyBuffer("sig");
+  }));
+  executor_->drain();
+  EXPECT_TRUE(queued.isReady());
+}
+
+TEST_F(OffloadAsyncSelfCertTest, TestSignaturesPerTask) {
+  OffloadAsyncSelfCert::Options options;
+  options.maxSignaturesPerTask = 2;
+  size_t latencyCalls = 0;
+  options.latencyCallback = [&latencyCalls](auto, auto) { latencyCalls++; };
+  auto cert = makeCert(std::move(options));
+
+  std::vector<folly::SemiFuture<folly::Optional<Buf>>> futures;
+  for (size_t i = 0; i < 3; i++) {
+    futures.push_back(sign(*cert));
+  }
+
+  EXPECT_CALL(*signer_, sign(_, _, _)).Times(3).WillRepeatedly(
+      InvokeWithoutArgs([]() { return folly::IOBuf::copyBuffer("sig"); }));
+  // Three queued signatures only need two executor tasks.
+  EXPECT_EQ(executor_->run(), 2);
+  for (auto& future : futures) {
+    EXPECT_TRUE(future.isReady());
+  }
+  EXPECT_EQ(latencyCalls, 3);
+  EXPECT_EQ(cert->getStats().offloaded, 3);
+}
+
+TEST_F(OffloadAsyncSelfCertTest, TestOutlivesCert) {
+  auto cert = makeCert();
+  auto future = sign(*cert);
+  cert.reset();
+  EXPECT_CALL(*signer_, sign(_, _, _)).WillOnce(InvokeWithoutArgs([]() {
+    return folly::IOBuf::copyBuffer("sig");
+  }));
+  executor_->drain();
+  EXPECT_TRUE(future.isReady());
+}
+} // namespace test
+} // namespace server
+} // namespace fizz
@@ -0,0 +1,310 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/executors/ManualExecutor.h>
+#include <folly/init/Init.h>
+
+#include <fizz/backend/openssl/certificate/CertUtils.h>
+#include <fizz/crypto/exchange/X25519.h>
+#include <fizz/crypto/test/TestUtil.h>
+#include <fizz/protocol/test/TestUtil.h>
+#include <fizz/record/Extensions.h>
+#include <fizz/server/AsyncSelfCert.h>
+#include <fizz/server/CertManager.h>
+#include <fizz/server/ServerProtocol.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+using namespace fizz;
+using namespace fizz::server;
+using namespace fizz::test;
+
+// Server side processing of a ClientHello for a full handshake, up to and
+// including writing the server flight. Reports the number of allocations, and
+// the bytes requested by them, per handshake next to the timings.
+
+namespace {
+std::atomic<size_t> gAllocations{0};
+std::atomic<size_t> gAllocatedBytes{0};
+
+// Backs every replaceable form of operator new, so that allocations made
+// through the array and aligned forms are counted as well.
+void* allocate(size_t size, size_t alignment) noexcept {
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  size = size ? size : 1;
+  if (alignment <= alignof(std::max_align_t)) {
+    return std::malloc(size);
+  }
+  // aligned_alloc() requires the size to be a multiple of the alignment.
+  return std::aligned_alloc(
+      alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void* allocateOrThrow(size_t size, size_t alignment) {
+  if (auto ptr = allocate(size, alignment)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+} // namespace
+
+void* operator new(size_t size) {
+  return allocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new[](size_t size) {
+  return allocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+  return allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(
+    size_t size,
+    std::align_val_t alignment,
+    const std::nothrow_t&) noexcept {
+  return allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](
+    size_t size,
+    std::align_val_t alignment,
+    const std::nothrow_t&) noexcept {
+  return allocate(size, static_cast<size_t>(alignment));
+}
+
+// malloc() and aligned_alloc() memory are both released with free(), so all
+// forms of operator delete are the same.
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(
+    void* ptr,
+    std::align_val_t,
+    const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](
+    void* ptr,
+    std::align_val_t,
+    const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+namespace {
+
+const size_t kNumClientHellos = 64;
+
+// Uses the asynchronous interface, but signs on the calling thread and
+// returns a completed future.
+class ReadyAsyncSelfCert : public AsyncSelfCert {
+ public:
+  explicit ReadyAsyncSelfCert(std::shared_ptr<const SelfCert> signer)
+      : signer_(std::move(signer)) {}
+
+  std::string getIdentity() const override {
+    return signer_->getIdentity();
+  }
+
+  std::vector<std::string> getAltIdentities() const override {
+    return signer_->getAltIdentities();
+  }
+
+  std::vector<SignatureScheme> getSigSchemes() const override {
+    return signer_->getSigSchemes();
+  }
+
+  CertificateMsg getCertMessage(
+      Buf certificateRequestContext = nullptr) const override {
+    return signer_->getCertMessage(std::move(certificateRequestContext));
+  }
+
+  CompressedCertificate getCompressedCert(
+      CertificateCompressionAlgorithm algo) const override {
+    return signer_->getCompressedCert(algo);
+  }
+
+  folly::ssl::X509UniquePtr getX509() const override {
+    return signer_->getX509();
+  }
+
+  Buf sign(
+      SignatureScheme scheme,
+      CertificateVerifyContext context,
+      folly::ByteRange toBeSigned) const override {
+    return signer_->sign(scheme, context, toBeSigned);
+  }
+
+  folly::SemiFuture<folly::Optional<Buf>> signFuture(
+      SignatureScheme scheme,
+      CertificateVerifyContext context,
+      std::unique_ptr<folly::IOBuf> toBeSigned) const override {
+    return folly::makeSemiFuture<folly::Optional<Buf>>(
+        signer_->sign(scheme, context, toBeSigned->coalesce()));
+  }
+
+ private:
+  std::shared_ptr<const SelfCert> signer_;
+};
+
+std::shared_ptr<SelfCert> makeSelfCert() {
+  return openssl::CertUtils::makeSelfCert(
+      kP256Certificate.str(), kP256Key.str());
+}
+
+std::shared_ptr<const FizzServerContext> makeContext(
+    std::shared_ptr<SelfCert> cert) {
+  auto certManager = std::make_shared<CertManager>();
+  certManager->addCertAndSetDefault(std::move(cert));
+  auto context = std::make_shared<FizzServerContext>();
+  context->setCertManager(std::move(certManager));
+  context->setSupportedAlpns({"h2"});
+  return context;
+}
+
+std::vector<Buf> makeClientHellos() {
+  std::vector<Buf> chlos;
+  for (size_t i = 0; i < kNumClientHellos; i++) {
+    auto chlo = TestMessages::clientHello();
+    TestMessages::removeExtension(chlo, ExtensionType::key_share);
+    X25519KeyExchange kex;
+    kex.generateKeyPair();
+    ClientKeyShare keyShare;
+    KeyShareEntry entry;
+    entry.group = NamedGroup::x25519;
+    entry.key_exchange = kex.getKeyShare();
+    keyShare.client_shares.push_back(std::move(entry));
+    chlo.extensions.push_back(encodeExtension(std::move(keyShare)));
+    auto encoded = encodeHandshake(std::move(chlo));
+    chlos.push_back(PlaintextWriteRecordLayer()
+                        .writeInitialClientHello(std::move(encoded))
+                        .data);
+  }
+  return chlos;
+}
+
+void processStateMutations(State& state, AsyncActions asyncActions) {
+  auto& actions = boost::get<Actions>(asyncActions);
+  for (auto& action : actions) {
+    auto mutateState = action.asMutateState();
+    if (mutateState) {
+      (*mutateState)(state);
+    }
+  }
+}
+
+void processClientHellos(
+    folly::UserCounters& counters,
+    size_t iters,
+    std::shared_ptr<const FizzServerContext> context) {
+  std::vector<Buf> chlos;
+  folly::ManualExecutor executor;
+  BENCHMARK_SUSPEND {
+    chlos = makeClientHellos();
+  }
+  size_t allocations = 0;
+  size_t bytes = 0;
+  for (size_t i = 0; i < iters; i++) {
+    State state;
+    processStateMutations(
+        state,
+        ServerStateMachine().processAccept(state, &executor, context, nullptr));
+    folly::IOBufQueue queue{folly::IOBufQueue::cacheChainLength()};
+    queue.append(chlos[i % chlos.size()]->clone());
+
+    auto before = gAllocations.load(std::memory_order_relaxed);
+    auto bytesBefore = gAllocatedBytes.load(std::memory_order_relaxed);
+    auto actions = ServerStateMachine().processSocketData(
+        state, queue, Aead::AeadOptions());
+    allocations += gAllocations.load(std::memory_order_relaxed) - before;
+    bytes += gAllocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+    folly::doNotOptimizeAway(actions);
+  }
+  counters["allocs"] = iters ? allocations / iters : 0;
+  counters["bytes"] = iters ? bytes / iters : 0;
+}
+} // namespace
+
+BENCHMARK_COUNTERS(FullHandshakeSyncSigner, counters, iters) {
+  std::shared_ptr<const FizzServerContext> context;
+  BENCHMARK_SUSPEND {
+    context = makeContext(makeSelfCert());
+  }
+  processClientHellos(counters, iters, std::move(context));
+}
+
+BENCHMARK_COUNTERS(FullHandshakeReadyAsyncSigner, counters, iters) {
+  std::shared_ptr<const FizzServerContext> context;
+  BENCHMARK_SUSPEND {
+    context =
+        makeContext(std::make_shared<ReadyAsyncSelfCert>(makeSelfCert()));
+  }
+  processClientHellos(counters, iters, std::move(context));
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -489,6 +489,45 @@ TEST_F(ServerProtocolTest, TestAccept) {
   EXPECT_EQ(
       state_.writeRecordLayer()->getEncryptionLevel(),
       EncryptionLevel::Plaintext);
+  EXPECT_EQ(state_.handshakeTimings(), nullptr);
+}
+
+TEST_F(ServerProtocolTest, TestAcceptHandshakeTimings) {
+  context_->setRecordHandshakeTimings(true);
+  auto actions = getActions(ServerStateMachine().processAccept(
+      state_, &executor_, context_, extensions_));
+  processStateMutations(actions);
+  ASSERT_NE(state_.handshakeTimings(), nullptr);
+  EXPECT_FALSE(state_.handshakeTimings()->start.has_value());
+}
+
+TEST_F(ServerProtocolTest, TestAcceptClientHelloFilter) {
+  auto filter = std::make_shared<MockClientHelloFilter>();
+  context_->setClientHelloFilter(filter);
+  EXPECT_CALL(*factory_, makePlaintextReadRecordLayer())
+      .WillOnce(Invoke(
+          []() { return std::make_unique<PlaintextReadRecordLayer>(); }));
+  auto actions = getActions(ServerStateMachine().processAccept(
+      state_, &executor_, context_, extensions_));
+  processStateMutations(actions);
+
+  EXPECT_CALL(*filter, filter(_))
+      .WillOnce(Invoke([](const ClientHelloInfo& info) {
+        EXPECT_EQ(info.sni.value_or(""), "www.hostname.com");
+        return ClientHelloFilterResult::Reject;
+      }));
+  TLSMessage msg{
+      ContentType::handshake, encodeHandshake(TestMessages::clientHello())};
+  folly::IOBufQueue buf;
+  buf.append(PlaintextWriteRecordLayer()
+                 .write(std::move(msg), Aead::AeadOptions())
+                 .data);
+  try {
+    state_.readRecordLayer()->readEvent(buf, Aead::AeadOptions());
+    ADD_FAILURE() << "filter did not reject";
+  } catch (const FizzException& e) {
+    EXPECT_EQ(e.getAlert(), AlertDescription::handshake_failure);
+  }
 }
 
 TEST_F(ServerProtocolTest, TestAppClose) {
@@ -4882,6 +4921,63 @@ TEST_F(ServerProtocolTest, TestClientHelloRejectEarlyDataReplayCache) {
   EXPECT_EQ(state_.replayCacheResult(), ReplayCacheResult::DefinitelyReplay);
 }
 
+TEST_F(ServerProtocolTest, TestClientHelloAcceptEarlyDataSync) {
+  acceptEarlyData();
+  setUpExpectingClientHello();
+
+  EXPECT_CALL(*mockTicketCipher_, decryptSync(_))
+      .WillOnce(InvokeWithoutArgs([] {
+        return folly::make_optional(
+            std::pair<PskType, folly::Optional<ResumptionState>>(
+                PskType::Resumption,
+                MockTicketCipher::getDefaultResumptionState(
+                    std::chrono::system_clock::time_point(
+                        std::chrono::seconds(10)))));
+      }));
+  EXPECT_CALL(*mockTicketCipher_, _decrypt(_)).Times(0);
+  EXPECT_CALL(*replayCache_, checkSync(_))
+      .WillOnce(Return(ReplayCacheResult::NotReplay));
+  EXPECT_CALL(*replayCache_, check(_)).Times(0);
+
+  std::chrono::milliseconds age =
+      std::chrono::minutes(5) - std::chrono::seconds(10);
+
+  fizz::Param param = TestMessages::clientHelloPskEarly(age.count());
+  auto actions = getActions(detail::processEvent(state_, param));
+  expectActions<
+      MutateState,
+      WriteToSocket,
+      ReportEarlyHandshakeSuccess,
+      SecretAvailable>(actions);
+  processStateMutations(actions);
+  EXPECT_EQ(state_.state(), StateEnum::AcceptingEarlyData);
+  EXPECT_EQ(state_.pskType(), PskType::Resumption);
+  EXPECT_EQ(state_.earlyDataType(), EarlyDataType::Accepted);
+  EXPECT_EQ(state_.replayCacheResult(), ReplayCacheResult::NotReplay);
+}
+
+TEST_F(ServerProtocolTest, TestClientHelloRejectEarlyDataReplayCacheSync) {
+  acceptEarlyData();
+  setUpExpectingClientHello();
+
+  EXPECT_CALL(*replayCache_, checkSync(_))
+      .WillOnce(Return(ReplayCacheResult::DefinitelyReplay));
+  EXPECT_CALL(*replayCache_, check(_)).Times(0);
+
+  std::chrono::milliseconds age =
+      std::chrono::minutes(5) - std::chrono::seconds(10);
+
+  // The ticket cipher is still asynchronous here.
+  fizz::Param param = TestMessages::clientHelloPskEarly(age.count());
+  auto actions = getActions(detail::processEvent(state_, param));
+  expectActions<MutateState, WriteToSocket, SecretAvailable>(actions);
+  processStateMutations(actions);
+  EXPECT_EQ(state_.state(), StateEnum::ExpectingFinished);
+  EXPECT_EQ(state_.pskType(), PskType::Resumption);
+  EXPECT_EQ(state_.earlyDataType(), EarlyDataType::Rejected);
+  EXPECT_EQ(state_.replayCacheResult(), ReplayCacheResult::DefinitelyReplay);
+}
+
 TEST_F(ServerProtocolTest, TestClientHelloRejectEarlyDataNoAlpn) {
   acceptEarlyData();
   setUpExpectingClientHello();
@@ -5141,6 +5237,53 @@ TEST_F(ServerProtocolTest, TestClientHelloHandshakeLogging) {
   EXPECT_TRUE(state_.handshakeLogging()->clientRandom.has_value());
 }
 
+TEST_F(ServerProtocolTest, TestClientHelloHandshakeTimings) {
+  setUpExpectingClientHello();
+  state_.handshakeTimings() = std::make_unique<HandshakeTimings>();
+  state_.handshakeTimings()->start = HandshakeTimings::Clock::now();
+  fizz::Param param = TestMessages::clientHello();
+  auto actions = getActions(detail::processEvent(state_, param));
+  processStateMutations(actions);
+
+  auto& timings = *state_.handshakeTimings();
+  for (auto phase :
+       {HandshakePhase::ClientHello,
+        HandshakePhase::ResumptionCheck,
+        HandshakePhase::KeyExchange,
+        HandshakePhase::CertSelection,
+        HandshakePhase::Signing,
+        HandshakePhase::ServerFlight}) {
+    EXPECT_TRUE(timings.getDuration(phase).has_value()) << toString(phase);
+  }
+  EXPECT_FALSE(timings.getDuration(HandshakePhase::ECHDecryption).has_value());
+  EXPECT_FALSE(timings.getDuration(HandshakePhase::ClientFinished).has_value());
+  ASSERT_TRUE(timings.getTotal().has_value());
+  EXPECT_GE(
+      *timings.getTotal(), *timings.getDuration(HandshakePhase::ServerFlight));
+}
+
+TEST_F(ServerProtocolTest, TestClientHelloPskHandshakeTimings) {
+  context_->setSupportedPskModes({PskKeyExchangeMode::psk_ke});
+  setUpExpectingClientHello();
+  state_.handshakeTimings() = std::make_unique<HandshakeTimings>();
+  fizz::Param param = TestMessages::clientHelloPsk();
+  auto actions = getActions(detail::processEvent(state_, param));
+  processStateMutations(actions);
+
+  auto& timings = *state_.handshakeTimings();
+  auto recorded = [&](HandshakePhase phase) {
+    return timings.phaseEnd[static_cast<size_t>(phase)].has_value();
+  };
+  EXPECT_TRUE(recorded(HandshakePhase::ClientHello));
+  EXPECT_TRUE(recorded(HandshakePhase::ResumptionCheck));
+  EXPECT_TRUE(recorded(HandshakePhase::ServerFlight));
+  EXPECT_FALSE(recorded(HandshakePhase::KeyExchange));
+  EXPECT_FALSE(recorded(HandshakePhase::CertSelection));
+  EXPECT_FALSE(timings.getDuration(HandshakePhase::Signing).has_value());
+  // No start time was recorded.
+  EXPECT_FALSE(timings.getTotal().has_value());
+}
+
 TEST_F(ServerProtocolTest, TestClientHelloTestByte) {
   setUpExpectingClientHello();
   state_.handshakeLogging() = std::make_unique<HandshakeLogging>();
@@ -5814,6 +5957,24 @@ TEST_F(ServerProtocolTest, TestFinishedNoTicket) {
   EXPECT_EQ(state_.state(), StateEnum::AcceptingData);
 }
 
+TEST_F(ServerProtocolTest, TestFinishedHandshakeTimings) {
+  setUpExpectingFinished();
+  state_.handshakeTimings() = std::make_unique<HandshakeTimings>();
+  state_.handshakeTimings()->start = HandshakeTimings::Clock::now();
+  state_.handshakeTimings()->record(HandshakePhase::ServerFlight);
+  EXPECT_CALL(*mockTicketCipher_, _encrypt(_)).WillOnce(InvokeWithoutArgs([]() {
+    return folly::none;
+  }));
+
+  fizz::Param param = TestMessages::finished();
+  auto actions = getActions(detail::processEvent(state_, param));
+  processStateMutations(actions);
+  EXPECT_EQ(state_.state(), StateEnum::AcceptingData);
+  EXPECT_TRUE(state_.handshakeTimings()
+                  ->getDuration(HandshakePhase::ClientFinished)
+                  .has_value());
+}
+
 TEST_F(ServerProtocolTest, TestFinishedTicketEarly) {
   acceptEarlyData();
   setUpExpectingFinished();
@@ -5958,7 +6119,11 @@ TEST_F(ServerProtocolTest, TestWriteNewSessionTicket) {
 
   fizz::Param param = WriteNewSessionTicket();
   auto actions = getActions(detail::processEvent(state_, param));
-  auto write = expectSingleAction<WriteToSocket>(std::move(actions));
+  expectActions<MutateState, WriteToSocket>(actions);
+  auto write = expectAction<WriteToSocket>(actions);
+  processStateMutations(actions);
+  EXPECT_EQ(state_.ticketsIssued(), 1);
+  EXPECT_EQ(write.contents.size(), 1);
   EXPECT_EQ(write.contents[0].contentType, ContentType::handshake);
   EXPECT_EQ(write.contents[0].encryptionLevel, EncryptionLevel::AppTraffic);
   EXPECT_TRUE(folly::IOBufEqualTo()(nstBuf, write.contents[0].data));
@@ -5987,7 +6152,7 @@ TEST_F(ServerProtocolTest, TestWriteNewSessionTicketWithTicketEarly) {
 
   fizz::Param param = WriteNewSessionTicket();
   auto actions = getActions(detail::processEvent(state_, param));
-  expectSingleAction<WriteToSocket>(std::move(actions));
+  expectActions<MutateState, WriteToSocket>(actions);
 }
 
 TEST_F(ServerProtocolTest, TestWriteNewSessionTicketWithAppToken) {
@@ -6012,7 +6177,7 @@ TEST_F(ServerProtocolTest, TestWriteNewSessionTicketWithAppToken) {
   writeNewSessionTicket.appToken = folly::IOBuf::copyBuffer(appToken);
   fizz::Param param = std::move(writeNewSessionTicket);
   auto actions = getActions(detail::processEvent(state_, param));
-  expectSingleAction<WriteToSocket>(std::move(actions));
+  expectActions<MutateState, WriteToSocket>(actions);
 }
 
 TEST_F(
@@ -6061,7 +6226,9 @@ TEST_F(
   param = std::move(writeNewSessionTicket);
   auto writeNewSessionTicketActions =
       getActions(detail::processEvent(state_, param));
-  expectSingleAction<WriteToSocket>(std::move(writeNewSessionTicketActions));
+  expectActions<MutateState, WriteToSocket>(writeNewSessionTicketActions);
+  processStateMutations(writeNewSessionTicketActions);
+  EXPECT_EQ(state_.ticketsIssued(), 2);
 }
 
 TEST_F(ServerProtocolTest, TestWriteNewSessionTicketNoTicket) {
@@ -6087,6 +6254,101 @@ TEST_F(ServerProtocolTest, TestWriteNewSessionTicketPskNotSupported) {
   EXPECT_TRUE(actions.empty());
 }
 
+TEST_F(ServerProtocolTest, TestWriteNewSessionTicketMultiple) {
+  setUpAcceptingData();
+  context_->setSendNewSessionTicket(false);
+  state_.resumptionMasterSecret() = std::vector<uint8_t>({'r', 's', 'e', 'c'});
+  state_.ticketsIssued() = 1;
+
+  std::vector<std::string> nonces{
+      std::string("\x00\x00\x00\x01", 4),
+      std::string("\x00\x00\x00\x02", 4)};
+  Sequence seq;
+  for (const auto& nonce : nonces) {
+    EXPECT_CALL(
+        *mockKeyScheduler_,
+        getResumptionSecret(RangeMatches("rsec"), RangeMatches(nonce)))
+        .InSequence(seq)
+        .WillOnce(InvokeWithoutArgs(
+            []() { return folly::IOBuf::copyBuffer("derivedrsec"); }));
+  }
+  EXPECT_CALL(*mockTicketCipher_, _encrypt(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([](ResumptionState& resState) {
+        EXPECT_TRUE(folly::IOBufEqualTo()(
+            resState.appToken, folly::IOBuf::copyBuffer("appToken")));
+        return std::make_pair(
+            folly::IOBuf::copyBuffer("ticket"), std::chrono::seconds(100));
+      }));
+  EXPECT_CALL(*appWrite_, _write(_, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](TLSMessage& msg, Aead::AeadOptions) {
+        TLSContent content;
+        content.contentType = msg.type;
+        content.encryptionLevel = appWrite_->getEncryptionLevel();
+        EXPECT_EQ(msg.type, ContentType::handshake);
+        content.data = folly::IOBuf::copyBuffer("nst");
+        return content;
+      }));
+
+  WriteNewSessionTicket writeNewSessionTicket;
+  writeNewSessionTicket.appToken = folly::IOBuf::copyBuffer("appToken");
+  writeNewSessionTicket.count = 2;
+  fizz::Param param = std::move(writeNewSessionTicket);
+  auto actions = getActions(detail::processEvent(state_, param));
+  expectActions<MutateState, WriteToSocket>(actions);
+  auto write = expectAction<WriteToSocket>(actions);
+  EXPECT_EQ(write.contents.size(), 2);
+  processStateMutations(actions);
+  EXPECT_EQ(state_.ticketsIssued(), 3);
+}
+
+TEST_F(ServerProtocolTest, TestFinishedMultipleTickets) {
+  setUpExpectingFinished();
+  context_->setNumNewSessionTickets(3);
+
+  std::vector<std::string> nonces{
+      "",
+      std::string("\x00\x00\x00\x01", 4),
+      std::string("\x00\x00\x00\x02", 4)};
+  Sequence seq;
+  for (const auto& nonce : nonces) {
+    EXPECT_CALL(*mockKeyScheduler_, getResumptionSecret(_, RangeMatches(nonce)))
+        .InSequence(seq)
+        .WillOnce(InvokeWithoutArgs(
+            []() { return folly::IOBuf::copyBuffer("derivedrsec"); }));
+  }
+  EXPECT_CALL(*mockTicketCipher_, _encrypt(_))
+      .Times(3)
+      .WillRepeatedly(InvokeWithoutArgs([]() {
+        return std::make_pair(
+            folly::IOBuf::copyBuffer("ticket"), std::chrono::seconds(100));
+      }));
+  EXPECT_CALL(*mockWrite_, _write(_, _))
+      .Times(3)
+      .WillRepeatedly(Invoke([&](TLSMessage& msg, Aead::AeadOptions) {
+        TLSContent content;
+        content.contentType = msg.type;
+        content.encryptionLevel = mockWrite_->getEncryptionLevel();
+        EXPECT_EQ(msg.type, ContentType::handshake);
+        content.data = folly::IOBuf::copyBuffer("handshake");
+        return content;
+      }));
+
+  fizz::Param param = TestMessages::finished();
+  auto actions = getActions(detail::processEvent(state_, param));
+  expectActions<
+      MutateState,
+      ReportHandshakeSuccess,
+      WriteToSocket,
+      SecretAvailable>(actions);
+  auto write = expectAction<WriteToSocket>(actions);
+  EXPECT_EQ(write.contents.size(), 3);
+  processStateMutations(actions);
+  EXPECT_EQ(state_.state(), StateEnum::AcceptingData);
+  EXPECT_EQ(state_.ticketsIssued(), 3);
+}
+
 TEST_F(ServerProtocolTest, TestAppData) {
   setUpAcceptingData();
 
@@ -159,6 +159,21 @@ TEST(SlidingBloomReplayCacheTest, TestAsyncLookup) {
   EXPECT_EQ(std::move(r2).get(), ReplayCacheResult::NotReplay);
   EXPECT_EQ(std::move(r3).get(), ReplayCacheResult::MaybeReplay);
 }
+
+TEST(SlidingBloomReplayCacheTest, TestSyncLookup) {
+  folly::ScopedEventBaseThread evbThread;
+  SlidingBloomReplayCache cache(12, 1000, 0.0001, evbThread.getEventBase());
+
+  // Off the event base thread the check has to go through check().
+  EXPECT_FALSE(cache.checkSync(toRange("abcd")).has_value());
+
+  evbThread.getEventBase()->runInEventBaseThreadAndWait([&] {
+    EXPECT_EQ(*cache.checkSync(toRange("abcd")), ReplayCacheResult::NotReplay);
+    EXPECT_EQ(*cache.checkSync(toRange("wxyz")), ReplayCacheResult::NotReplay);
+    EXPECT_EQ(
+        *cache.checkSync(toRange("abcd")), ReplayCacheResult::MaybeReplay);
+  });
+}
 } // namespace test
 } // namespace server
 } // namespace fizz
@@ -20,6 +20,8 @@ int fizzClientCommand(const std::vector<std::string>& args);
 int fizzServerCommand(const std::vector<std::string>& args);
 int fizzGenerateDelegatedCredentialCommand(
     const std::vector<std::string>& args);
+int fizzGenerateCompressionDictionaryCommand(
+    const std::vector<std::string>& args);
 int fizzClientLoadGenCommand(const std::vector<std::string>& args);
 int fizzServerBenchmarkCommand(const std::vector<std::string>& args);
 const std::vector<std::string> utilityNames = {
@@ -28,6 +30,7 @@ const std::vector<std::string> utilityNames = {
     "server",
     "s_server",
     "gendc",
+    "gencompdict",
     "client_loadgen",
     "server_benchmark"};
 
@@ -38,6 +41,7 @@ const std::map<std::string, std::function<int(const std::vector<std::string>&)>>
         {"server", &fizzServerCommand},
         {"s_server", &fizzServerCommand},
         {"gendc", &fizzGenerateDelegatedCredentialCommand},
+        {"gencompdict", &fizzGenerateCompressionDictionaryCommand},
         {"client_loadgen", &fizzClientLoadGenCommand},
         {"server_benchmark", &fizzServerBenchmarkCommand}};
 
@@ -47,6 +51,7 @@ const std::map<std::string, std::string> utilityDescriptions = {
     {"server", "TLS 1.3 server"},
     {"s_server", "Alias for server"},
     {"gendc", "Generate a delegated credential"},
+    {"gencompdict", "Train a certificate compression dictionary"},
     {"client_loadgen",
      "TLS 1.3 clients generating TLS handshakes for performance benchmark"},
     {"server_benchmark", "TLS 1.3 servers for performance test"}};
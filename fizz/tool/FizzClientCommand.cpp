@@ -17,6 +17,7 @@
 #include <fizz/compression/ZlibCertificateDecompressor.h>
 #ifdef FIZZ_TOOL_ENABLE_ZSTD
 #include <fizz/compression/ZstdCertificateDecompressor.h>
+#include <fizz/compression/ZstdDictCertificateDecompressor.h>
 #endif
 #include <fizz/backend/openssl/certificate/CertUtils.h>
 #include <fizz/client/PskSerializationUtils.h>
@@ -72,6 +73,7 @@ void printUsage() {
     << " -sigschemes s1:...       (colon-separated list of signature schemes in preference order.\n"
     << " -curves c1:...           (colon-separated list of supported ECDSA curves. Default: secp256r1, x25519)\n"
     << " -certcompression a1:...  (enables certificate compression support for given algorithms. Default: None)\n"
+    << " -certcompressiondict f   (zstd dictionary for the zstd_dictionary certificate compression algorithm. Default: None)\n"
     << " -early                   (enables sending early data during resumption. Default: false)\n"
     << " -quiet                   (hide informational logging. Default: false)\n"
     << " -v verbosity             (set verbose log level for VLOG macros. Default: 0)\n"
@@ -517,6 +519,7 @@ int fizzClientCommand(const std::vector<std::string>& args) {
   std::string customSNI;
   std::vector<std::string> alpns;
   folly::Optional<std::vector<CertificateCompressionAlgorithm>> compAlgos;
+  std::string compDict;
   bool early = false;
   std::string proxyHost = "";
   uint16_t proxyPort = 0;
@@ -590,6 +593,11 @@ int fizzClientCommand(const std::vector<std::string>& args) {
           throw;
         }
     }}},
+    {"-certcompressiondict", {true, [&compDict](const std::string& arg) {
+        if (!readFile(arg.c_str(), compDict)) {
+          throw std::runtime_error("Failed to read compression dictionary");
+        }
+    }}},
     {"-early", {false, [&early](const std::string&) { early = true; }}},
     {"-quiet", {false, [](const std::string&) {
         FLAGS_minloglevel = google::GLOG_ERROR;
@@ -705,6 +713,16 @@ int fizzClientCommand(const std::vector<std::string>& args) {
           decompressors.push_back(
               std::make_shared<ZstdCertificateDecompressor>());
           break;
+        case CertificateCompressionAlgorithm::zstd_dictionary:
+          if (compDict.empty()) {
+            LOG(WARNING) << "zstd_dictionary requires -certcompressiondict, "
+                         << "ignoring...";
+            break;
+          }
+          decompressors.push_back(
+              std::make_shared<ZstdDictCertificateDecompressor>(
+                  StringPiece(compDict)));
+          break;
 #endif
         default:
           LOG(WARNING) << "Don't know what decompressor to use for "
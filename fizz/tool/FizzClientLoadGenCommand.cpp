@@ -58,7 +58,9 @@ void printUsage() {
     << "                           0 < num < 100. Default percentiles: 25%, 50%, 75%, 90%)\n"
     << " -min num                 (the minimum time elapse (in microsecond) allowed for statistics when -json is used. Default: 1000\n"
     << " -max num                 (the maximum time elapse (in microsecond) allowed for statistics when -json is used. Default: 1000000)\n"
-    << " -batch                   (use the batch signature scheme ecdsa_secp256r1_sha256_batch)\n";
+    << " -batch                   (use the batch signature scheme ecdsa_secp256r1_sha256_batch)\n"
+    << " -hrr                     (only send a secp256r1 key share, forcing a HelloRetryRequest from servers\n"
+    << "                           preferring x25519, to measure handshake throughput under an HRR storm)\n";
   // clang-format on
 }
 
@@ -134,6 +136,7 @@ struct ClientLoadgenConfig {
   std::string caFile;
   std::string pskLoadFile;
   bool jsonOutput = false;
+  bool forceHelloRetryRequest = false;
   int minLatency = 1000; // 1ms as the default minimum latency
   int maxLatency = 1000000; // 1s as the default maximum latency measured
   std::vector<float> percentiles = {0.25, 0.5, 0.75, 0.9};
@@ -158,6 +161,7 @@ std::string getJsonStr(
     ("total_tasks", config.numTaskPerSecond * config.totalTime)
     ("tasks_per_second", config.numTaskPerSecond)
     ("threads", config.threadNum)
+    ("hello_retry_request", config.forceHelloRetryRequest)
     ("success_tasks", numSuccess)
     ("unit", "microseconds")
     ("average_latency", avg_latency)
@@ -208,6 +212,9 @@ int fizzClientLoadGenCommand(const std::vector<std::string>& args) {
     }}},
     {"-batch", {false, [&enableBatch](const std::string&) {
       enableBatch = true;
+    }}},
+    {"-hrr", {false, [&config](const std::string&) {
+      config.forceHelloRetryRequest = true;
     }}}
   };
   // clang-format on
@@ -241,6 +248,13 @@ int fizzClientLoadGenCommand(const std::vector<std::string>& args) {
       {SignatureScheme::rsa_pss_sha256,
        SignatureScheme::ecdsa_secp256r1_sha256,
        SignatureScheme::ecdsa_secp384r1_sha384});
+  if (config.forceHelloRetryRequest) {
+    // Offer x25519 first but only send a secp256r1 share, so a server that
+    // supports x25519 has to ask for another ClientHello.
+    clientContext->setSupportedGroups(
+        {NamedGroup::x25519, NamedGroup::secp256r1});
+    clientContext->setDefaultShares({NamedGroup::secp256r1});
+  }
   if (enableBatch) {
     clientContext->setFactory(BatchSignatureFactory::makeBatchSignatureFactory(
         clientContext->getFactoryPtr()));
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree.
+ */
+
+#include <fizz/backend/openssl/certificate/CertUtils.h>
+#include <fizz/compression/ZstdDictCertificateCompressor.h>
+#include <fizz/tool/FizzCommandCommon.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/ssl/OpenSSLCertUtils.h>
+
+using namespace folly;
+
+namespace fizz {
+namespace tool {
+namespace {
+
+void printUsage() {
+  // clang-format off
+  std::cerr
+    << "Usage: gencompdict args\n"
+    << "\n"
+    << "Supported arguments:\n"
+    << " -certs c1:...        (colon-separated list of files, each containing a PEM format certificate chain. Required)\n"
+    << " -size bytes          (maximum size of the dictionary. Default: 16384)\n"
+    << " -out path            (file to output the zstd dictionary to. Required)\n"
+    << "\n"
+    << "Trains a zstd dictionary for the zstd_dictionary certificate compression\n"
+    << "algorithm. Use a representative corpus of the chains servers will send,\n"
+    << "at least a few dozen of them.\n";
+  // clang-format on
+}
+} // namespace
+
+int fizzGenerateCompressionDictionaryCommand(
+    const std::vector<std::string>& args) {
+  // clang-format off
+  std::vector<std::string> certPaths;
+  size_t maxSize = 16384;
+  std::string outPath;
+
+  FizzArgHandlerMap handlers = {
+    {"-certs", {true, [&certPaths](const std::string& arg) {
+        certPaths.clear();
+        folly::split(':', arg, certPaths);
+    }}},
+    {"-size", {true, [&maxSize](const std::string& arg) {
+        maxSize = std::stoul(arg);
+    }}},
+    {"-out", {true, [&outPath](const std::string& arg) {
+        outPath = arg;
+    }}}
+  };
+  // clang-format on
+
+  try {
+    if (parseArguments(args, handlers, printUsage)) {
+      // Parsing failed, return
+      return 1;
+    }
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Error: " << e.what();
+    return 1;
+  }
+
+  if (certPaths.empty()) {
+    LOG(ERROR) << "-certs is a required argument for gencompdict";
+    printUsage();
+    return 1;
+  }
+
+  if (outPath.empty()) {
+    LOG(ERROR) << "-out is a required argument for gencompdict";
+    printUsage();
+    return 1;
+  }
+
+  try {
+    std::vector<CertificateMsg> samples;
+    for (const auto& certPath : certPaths) {
+      std::string certData;
+      if (!readFile(certPath.c_str(), certData)) {
+        LOG(ERROR) << "Failed to read certificate chain " << certPath;
+        return 1;
+      }
+      auto certs = folly::ssl::OpenSSLCertUtils::readCertsFromBuffer(
+          StringPiece(certData));
+      if (certs.empty()) {
+        LOG(ERROR) << "No certificates found in " << certPath;
+        return 1;
+      }
+      samples.push_back(
+          openssl::CertUtils::getCertMessage(certs, IOBuf::create(0)));
+    }
+
+    auto dictionary =
+        ZstdDictCertificateCompressor::trainDictionary(samples, maxSize);
+    if (!writeFile(dictionary, outPath.c_str())) {
+      LOG(ERROR) << "Failed to write out dictionary: " << errnoStr(errno);
+      return 1;
+    }
+    LOG(INFO) << "Wrote " << dictionary.size() << " byte dictionary trained on "
+              << samples.size() << " chains to " << outPath;
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to generate dictionary: " << e.what();
+    return 1;
+  }
+
+  return 0;
+}
+
+} // namespace tool
+} // namespace fizz
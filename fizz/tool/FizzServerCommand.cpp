@@ -17,6 +17,7 @@
 #include <fizz/protocol/DefaultCertificateVerifier.h>
 #ifdef FIZZ_TOOL_ENABLE_ZSTD
 #include <fizz/compression/ZstdCertificateCompressor.h>
+#include <fizz/compression/ZstdDictCertificateCompressor.h>
 #endif
 #include <fizz/backend/openssl/certificate/CertUtils.h>
 #include <fizz/backend/openssl/certificate/OpenSSLSelfCertImpl.h>
@@ -70,6 +71,7 @@ void printUsage() {
     << " -early_max maxBytes      (sets the maximum amount allowed in early data. Default: UINT32_MAX)\n"
     << " -alpn alpn1:...          (comma-separated list of ALPNs to support. Default: none)\n"
     << " -certcompression a1:...  (enables certificate compression support for given algorithms. Default: None)\n"
+    << " -certcompressiondict f   (zstd dictionary for the zstd_dictionary certificate compression algorithm. Default: None)\n"
     << " -fallback                (enables falling back to OpenSSL for pre-1.3 connections. Default: false)\n"
     << " -loop                    (don't exit after client disconnect. Default: false)\n"
     << " -quiet                   (hide informational logging. Default: false)\n"
@@ -642,6 +644,7 @@ int fizzServerCommand(const std::vector<std::string>& args) {
   bool early = false;
   std::vector<std::string> alpns;
   folly::Optional<std::vector<CertificateCompressionAlgorithm>> compAlgos;
+  std::string compDict;
   bool loop = false;
   bool fallback = false;
   bool http = false;
@@ -726,6 +729,11 @@ int fizzServerCommand(const std::vector<std::string>& args) {
           throw;
         }
     }}},
+    {"-certcompressiondict", {true, [&compDict](const std::string& arg) {
+        if (!readFile(arg.c_str(), compDict)) {
+          throw std::runtime_error("Failed to read compression dictionary");
+        }
+    }}},
     {"-loop", {false, [&loop](const std::string&) { loop = true; }}},
     {"-quiet", {false, [](const std::string&) {
         FLAGS_minloglevel = google::GLOG_ERROR;
@@ -895,6 +903,16 @@ int fizzServerCommand(const std::vector<std::string>& args) {
               std::make_shared<ZstdCertificateCompressor>(19));
           finalAlgos.push_back(algo);
           break;
+        case CertificateCompressionAlgorithm::zstd_dictionary:
+          if (compDict.empty()) {
+            LOG(WARNING) << "zstd_dictionary requires -certcompressiondict, "
+                         << "ignoring.";
+            break;
+          }
+          compressors.push_back(std::make_shared<ZstdDictCertificateCompressor>(
+              19, StringPiece(compDict)));
+          finalAlgos.push_back(algo);
+          break;
 #endif
         default:
           LOG(WARNING) << "Don't know what compressor to use for "
@@ -82,7 +82,9 @@ inline CertificateCompressionAlgorithm parse(folly::StringPiece s) {
       stringToAlgos = {
           {"zlib", CertificateCompressionAlgorithm::zlib},
           {"brotli", CertificateCompressionAlgorithm::brotli},
-          {"zstd", CertificateCompressionAlgorithm::zstd}};
+          {"zstd", CertificateCompressionAlgorithm::zstd},
+          {"zstd_dictionary",
+           CertificateCompressionAlgorithm::zstd_dictionary}};
 
   auto location = stringToAlgos.find(s);
   if (location != stringToAlgos.end()) {